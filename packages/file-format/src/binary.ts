@@ -0,0 +1,625 @@
+// Binary encoding for timeline data.
+// A compact, lossless alternative to JSON: every distinct string (keys
+// included) is stored once in a string table, integers are varints and other
+// numbers are float64. Any JSON-compatible value can be encoded.
+//
+// Since version 2, arrays and objects that occur more than once (repeated
+// tracks, keyframe lists, property sets) are found by content hash and stored
+// once in a record table; each occurrence is a reference to its record.
+
+const MAGIC = [0x46, 0x4c, 0x52, 0x42];  // "FLRB"
+const VERSION = 2;
+
+// Subtrees smaller than this encode smaller inline than as a reference
+const MIN_SHARED_SIZE = 5;
+
+/**
+ * Value tags
+ */
+enum Tag {
+  NULL = 0,
+  FALSE = 1,
+  TRUE = 2,
+  FLOAT = 3,
+  INT = 4,        // Zigzag varint
+  STRING = 5,     // Varint string table index
+  ARRAY = 6,
+  OBJECT = 7,
+  REF = 8         // Varint record table index (version 2)
+}
+
+/**
+ * Options for FlareBinary.decode
+ */
+export interface BinaryDecodeOptions {
+  // Return one object for every reference to a record, instead of a copy per
+  // reference. Saves memory, but a change made through one reference shows up
+  // in all of them.
+  shareRecords?: boolean;
+}
+
+/**
+ * Arrays and objects with the same content
+ */
+interface SubtreeGroup {
+  first: object;
+  occurrences: number;
+  writes: number;
+  record: number;     // Record table index once written, else -1
+}
+
+/**
+ * Hash and encoded size of an array or object
+ */
+interface SubtreeInfo {
+  key: number;
+  size: number;
+  keys: string[] | null;    // Encoded keys of an object
+  group: SubtreeGroup;
+}
+
+/**
+ * Growable byte buffer
+ */
+class ByteWriter {
+  private bytes: Uint8Array = new Uint8Array(1024);
+  private view: DataView = new DataView(this.bytes.buffer);
+  public length: number = 0;
+
+  public u8(value: number): void {
+    this.reserve(1);
+    this.bytes[this.length++] = value;
+  }
+
+  public varint(value: number): void {
+    this.reserve(8);
+
+    // Values can exceed 32 bits, so divide instead of shifting
+    while (value >= 0x80) {
+      this.bytes[this.length++] = (value % 0x80) | 0x80;
+      value = Math.floor(value / 0x80);
+    }
+    this.bytes[this.length++] = value;
+  }
+
+  public f64(value: number): void {
+    this.reserve(8);
+    this.view.setFloat64(this.length, value, true);
+    this.length += 8;
+  }
+
+  public append(data: Uint8Array): void {
+    this.reserve(data.length);
+    this.bytes.set(data, this.length);
+    this.length += data.length;
+  }
+
+  public finish(): Uint8Array {
+    return this.bytes.slice(0, this.length);
+  }
+
+  private reserve(count: number): void {
+    if (this.length + count <= this.bytes.length) return;
+
+    let capacity = this.bytes.length * 2;
+    while (capacity < this.length + count) capacity *= 2;
+
+    const bytes = new Uint8Array(capacity);
+    bytes.set(this.bytes.subarray(0, this.length));
+    this.bytes = bytes;
+    this.view = new DataView(bytes.buffer);
+  }
+}
+
+/**
+ * Cursor over an encoded buffer
+ */
+class ByteReader {
+  private view: DataView;
+  public offset: number = 0;
+
+  constructor(private bytes: Uint8Array) {
+    this.view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  }
+
+  public u8(): number {
+    if (this.offset >= this.bytes.length) {
+      throw new Error('Unexpected end of binary data');
+    }
+    return this.bytes[this.offset++];
+  }
+
+  public varint(): number {
+    let value = 0;
+    let scale = 1;
+    let byte: number;
+
+    do {
+      byte = this.u8();
+      value += (byte & 0x7f) * scale;
+      scale *= 0x80;
+    } while (byte & 0x80);
+
+    return value;
+  }
+
+  public f64(): number {
+    if (this.offset + 8 > this.bytes.length) {
+      throw new Error('Unexpected end of binary data');
+    }
+    const value = this.view.getFloat64(this.offset, true);
+    this.offset += 8;
+    return value;
+  }
+
+  public take(count: number): Uint8Array {
+    if (this.offset + count > this.bytes.length) {
+      throw new Error('Unexpected end of binary data');
+    }
+    const data = this.bytes.subarray(this.offset, this.offset + count);
+    this.offset += count;
+    return data;
+  }
+}
+
+/**
+ * Encode a string as UTF-8 (TextEncoder isn't available everywhere the runtime runs)
+ */
+function encodeUTF8(str: string): Uint8Array {
+  const out: number[] = [];
+
+  for (let i = 0; i < str.length; i++) {
+    let code = str.charCodeAt(i);
+
+    // Combine surrogate pairs into one code point
+    if (code >= 0xd800 && code <= 0xdbff && i + 1 < str.length) {
+      const low = str.charCodeAt(i + 1);
+      if (low >= 0xdc00 && low <= 0xdfff) {
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        i++;
+      }
+    }
+
+    if (code <= 0x7f) {
+      out.push(code);
+    } else if (code <= 0x7ff) {
+      out.push(0xc0 | (code >> 6), 0x80 | (code & 63));
+    } else if (code <= 0xffff) {
+      out.push(0xe0 | (code >> 12), 0x80 | ((code >> 6) & 63), 0x80 | (code & 63));
+    } else {
+      out.push(0xf0 | (code >> 18), 0x80 | ((code >> 12) & 63), 0x80 | ((code >> 6) & 63), 0x80 | (code & 63));
+    }
+  }
+
+  return new Uint8Array(out);
+}
+
+/**
+ * Decode UTF-8 bytes produced by encodeUTF8
+ */
+function decodeUTF8(bytes: Uint8Array): string {
+  let str = '';
+  let i = 0;
+
+  while (i < bytes.length) {
+    const byte = bytes[i++];
+    let code: number;
+
+    if (byte < 0x80) {
+      code = byte;
+    } else if (byte < 0xe0) {
+      code = ((byte & 31) << 6) | (bytes[i++] & 63);
+    } else if (byte < 0xf0) {
+      code = ((byte & 15) << 12) | ((bytes[i++] & 63) << 6) | (bytes[i++] & 63);
+    } else {
+      code = ((byte & 7) << 18) | ((bytes[i++] & 63) << 12) | ((bytes[i++] & 63) << 6) | (bytes[i++] & 63);
+    }
+
+    if (code > 0xffff) {
+      code -= 0x10000;
+      str += String.fromCharCode(0xd800 + (code >> 10), 0xdc00 + (code & 1023));
+    } else {
+      str += String.fromCharCode(code);
+    }
+  }
+
+  return str;
+}
+
+const hashScratch = new DataView(new ArrayBuffer(8));
+
+/**
+ * 64-bit content hash, kept as two independently mixed 32-bit lanes
+ */
+class Hash64 {
+  constructor(public high: number = 0x9e3779b9, public low: number = 0x85ebca6b) {}
+
+  public add(value: number): this {
+    this.high = Math.imul(this.high ^ value, 0x01000193);
+    this.high ^= this.high >>> 15;
+    this.low = Math.imul(this.low + value, 0xcc9e2d51);
+    this.low = (this.low << 13) | (this.low >>> 19);
+    this.low = Math.imul(this.low, 5) + 0xe6546b64;
+    return this;
+  }
+
+  public addString(str: string): this {
+    this.add(str.length);
+    for (let i = 0; i < str.length; i++) this.add(str.charCodeAt(i));
+    return this;
+  }
+
+  public addNumber(value: number): this {
+    hashScratch.setFloat64(0, value);
+    return this.add(hashScratch.getUint32(0)).add(hashScratch.getUint32(4));
+  }
+
+  // Feed in another hash's key
+  public addKey(key: number): this {
+    return this.add(key % 0x100000000).add(Math.floor(key / 0x100000000));
+  }
+
+  // The hash folded to 53 bits, so it's an exact (and fast) Map key
+  public key(): number {
+    let high = this.high ^ (this.low >>> 16);
+    let low = this.low ^ (this.high >>> 13);
+    high = Math.imul(high ^ (high >>> 16), 0x85ebca6b) >>> 0;
+    low = Math.imul(low ^ (low >>> 13), 0xc2b2ae35) >>> 0;
+    return high * 0x200000 + (low >>> 11);
+  }
+}
+
+function varintSize(value: number): number {
+  let size = 1;
+  while (value >= 0x80) {
+    value = Math.floor(value / 0x80);
+    size++;
+  }
+  return size;
+}
+
+/**
+ * Keys of an object that encode, as JSON would keep them
+ */
+function encodedKeys(item: any): string[] {
+  return Object.keys(item).filter(key => item[key] !== undefined && typeof item[key] !== 'function');
+}
+
+/**
+ * Compare two values as they would encode
+ */
+function encodedEqual(a: any, b: any): boolean {
+  if (a === b) return true;
+  if (a === null || b === null || a === undefined || b === undefined) {
+    return (a === null || a === undefined) && (b === null || b === undefined);
+  }
+  if (typeof a !== 'object' || typeof b !== 'object') {
+    return typeof a === 'number' && typeof b === 'number' && Object.is(a, b);
+  }
+  if (Array.isArray(a) !== Array.isArray(b)) return false;
+
+  if (Array.isArray(a)) {
+    if (a.length !== b.length) return false;
+    for (let i = 0; i < a.length; i++) {
+      if (!encodedEqual(a[i], b[i])) return false;
+    }
+    return true;
+  }
+
+  const keys = encodedKeys(a);
+  const otherKeys = encodedKeys(b);
+  if (keys.length !== otherKeys.length) return false;
+  for (let i = 0; i < keys.length; i++) {
+    if (keys[i] !== otherKeys[i] || !encodedEqual(a[keys[i]], b[keys[i]])) return false;
+  }
+  return true;
+}
+
+/**
+ * Copy decoded arrays and objects; everything else is immutable
+ */
+function cloneDecoded(value: any): any {
+  if (value === null || typeof value !== 'object') return value;
+  if (Array.isArray(value)) return value.map(cloneDecoded);
+
+  const copy: Record<string, any> = {};
+  for (const key in value) copy[key] = cloneDecoded(value[key]);
+  return copy;
+}
+
+export class FlareBinary {
+  /**
+   * Encode a JSON-compatible value (normally a Timeline)
+   */
+  static encode(value: any): Uint8Array {
+    const strings: string[] = [];
+    const stringIndex = new Map<string, number>();
+    const stringHashes = new Map<string, number>();
+
+    const intern = (str: string): number => {
+      let index = stringIndex.get(str);
+      if (index === undefined) {
+        index = strings.length;
+        strings.push(str);
+        stringIndex.set(str, index);
+      }
+      return index;
+    };
+
+    // Pass 1: hash every array and object bottom-up. Equal hashes are
+    // confirmed against the first instance, so a collision never merges
+    // different subtrees.
+    const subtrees = new Map<object, SubtreeInfo>();
+    const groups = new Map<number, SubtreeGroup>();
+    let collisions = 0;
+
+    const stringHash = (str: string): number => {
+      let key = stringHashes.get(str);
+      if (key === undefined) {
+        key = new Hash64().addString(str).key();
+        stringHashes.set(str, key);
+      }
+      return key;
+    };
+
+    const hashValue = (item: any, hash: Hash64): number => {
+      if (item === null || item === undefined) {
+        hash.add(Tag.NULL);
+        return 1;
+      }
+      if (typeof item === 'boolean') {
+        hash.add(item ? Tag.TRUE : Tag.FALSE);
+        return 1;
+      }
+      if (typeof item === 'number') {
+        hash.add(Tag.FLOAT).addNumber(item);
+        return 9;
+      }
+      if (typeof item === 'string') {
+        hash.add(Tag.STRING).addKey(stringHash(item));
+        return 2;
+      }
+      if (typeof item === 'object') {
+        const info = measure(item);
+        hash.add(Tag.OBJECT).addKey(info.key);
+        return info.size;
+      }
+      throw new Error(`Cannot encode value of type ${typeof item}`);
+    };
+
+    const measure = (item: any): SubtreeInfo => {
+      let info = subtrees.get(item);
+      if (info) return info;
+
+      const hash = new Hash64();
+      let size = 1;
+      let keys: string[] | null = null;
+
+      if (Array.isArray(item)) {
+        hash.add(Tag.ARRAY).add(item.length);
+        size += varintSize(item.length);
+        for (let i = 0; i < item.length; i++) size += hashValue(item[i], hash);
+      } else {
+        keys = encodedKeys(item);
+        hash.add(Tag.OBJECT).add(keys.length);
+        size += varintSize(keys.length);
+        for (const key of keys) {
+          hash.addKey(stringHash(key));
+          size += 2 + hashValue(item[key], hash);
+        }
+      }
+
+      let key = hash.key();
+      let group = groups.get(key);
+      if (group && group.first !== item && !encodedEqual(group.first, item)) {
+        // Hash keys are never negative, so this can't clash with one
+        key = -(++collisions);
+        group = undefined;
+      }
+      if (!group) {
+        group = { first: item, occurrences: 0, writes: 0, record: -1 };
+        groups.set(key, group);
+      }
+      group.occurrences++;
+
+      info = { key, size, keys, group };
+      subtrees.set(item, info);
+      return info;
+    };
+
+    if (value !== null && typeof value === 'object') measure(value);
+
+    const isCandidate = (info: SubtreeInfo): boolean =>
+      info.size >= MIN_SHARED_SIZE && info.group.occurrences > 1;
+
+    // Pass 2: count how often each candidate is actually written. Repeats
+    // inside a record are written once, so they only count once.
+    const countWrites = (item: any): void => {
+      if (item === null || typeof item !== 'object') return;
+
+      const info = subtrees.get(item)!;
+      if (isCandidate(info) && ++info.group.writes > 1) return;
+
+      if (info.keys) {
+        info.keys.forEach(key => countWrites(item[key]));
+      } else {
+        item.forEach(countWrites);
+      }
+    };
+    countWrites(value);
+
+    // Pass 3: write the body. A shared subtree is written into the record
+    // table the first time it's met (after any records it contains) and
+    // referenced from then on.
+    const records = new ByteWriter();
+    let recordCount = 0;
+
+    const write = (item: any, out: ByteWriter): void => {
+      if (item === null || item === undefined) {
+        out.u8(Tag.NULL);
+      } else if (typeof item === 'boolean') {
+        out.u8(item ? Tag.TRUE : Tag.FALSE);
+      } else if (typeof item === 'number') {
+        if (Number.isSafeInteger(item) && !Object.is(item, -0)) {
+          out.u8(Tag.INT);
+          out.varint(item >= 0 ? item * 2 : -item * 2 - 1);
+        } else {
+          out.u8(Tag.FLOAT);
+          out.f64(item);
+        }
+      } else if (typeof item === 'string') {
+        out.u8(Tag.STRING);
+        out.varint(intern(item));
+      } else if (typeof item === 'object') {
+        const info = subtrees.get(item)!;
+
+        if (isCandidate(info) && info.group.writes > 1) {
+          const group = info.group;
+          if (group.record === -1) {
+            const record = new ByteWriter();
+            writeContainer(item, info, record);
+            group.record = recordCount++;
+            records.append(record.finish());
+          }
+          out.u8(Tag.REF);
+          out.varint(group.record);
+        } else {
+          writeContainer(item, info, out);
+        }
+      } else {
+        throw new Error(`Cannot encode value of type ${typeof item}`);
+      }
+    };
+
+    const writeContainer = (item: any, info: SubtreeInfo, out: ByteWriter): void => {
+      if (!info.keys) {
+        out.u8(Tag.ARRAY);
+        out.varint(item.length);
+        item.forEach((child: any) => write(child, out));
+      } else {
+        // Like JSON, keys holding undefined or functions are dropped
+        const keys = info.keys;
+        out.u8(Tag.OBJECT);
+        out.varint(keys.length);
+        keys.forEach(key => {
+          out.varint(intern(key));
+          write(item[key], out);
+        });
+      }
+    };
+
+    const body = new ByteWriter();
+    write(value, body);
+
+    const out = new ByteWriter();
+    MAGIC.forEach(byte => out.u8(byte));
+    out.u8(VERSION);
+    out.varint(strings.length);
+    strings.forEach(str => {
+      const bytes = encodeUTF8(str);
+      out.varint(bytes.length);
+      out.append(bytes);
+    });
+    out.varint(recordCount);
+    out.append(records.finish());
+    out.append(body.finish());
+
+    return out.finish();
+  }
+
+  /**
+   * Decode data produced by encode
+   */
+  static decode(bytes: Uint8Array, options: BinaryDecodeOptions = {}): any {
+    if (!FlareBinary.isBinary(bytes)) {
+      throw new Error('Not a binary Flare file');
+    }
+
+    const reader = new ByteReader(bytes);
+    reader.take(MAGIC.length);
+
+    const version = reader.u8();
+    if (version < 1 || version > VERSION) {
+      throw new Error(`Unsupported binary Flare version ${version}`);
+    }
+
+    const strings: string[] = [];
+    const stringCount = reader.varint();
+    for (let i = 0; i < stringCount; i++) {
+      strings.push(decodeUTF8(reader.take(reader.varint())));
+    }
+
+    const string = (index: number): string => {
+      if (index >= strings.length) {
+        throw new Error('Invalid string index in binary data');
+      }
+      return strings[index];
+    };
+
+    const records: any[] = [];
+
+    const read = (): any => {
+      const tag = reader.u8();
+
+      switch (tag) {
+        case Tag.NULL:
+          return null;
+        case Tag.FALSE:
+          return false;
+        case Tag.TRUE:
+          return true;
+        case Tag.FLOAT:
+          return reader.f64();
+        case Tag.INT: {
+          const zigzag = reader.varint();
+          return zigzag % 2 === 0 ? zigzag / 2 : -(zigzag + 1) / 2;
+        }
+        case Tag.STRING:
+          return string(reader.varint());
+        case Tag.ARRAY: {
+          const length = reader.varint();
+          const array = new Array(length);
+          for (let i = 0; i < length; i++) {
+            array[i] = read();
+          }
+          return array;
+        }
+        case Tag.OBJECT: {
+          const count = reader.varint();
+          const object: Record<string, any> = {};
+          for (let i = 0; i < count; i++) {
+            const key = string(reader.varint());
+            object[key] = read();
+          }
+          return object;
+        }
+        case Tag.REF: {
+          // Records only refer to records before them, so this is never a cycle
+          const index = reader.varint();
+          if (version < 2 || index >= records.length) {
+            throw new Error('Invalid record reference in binary data');
+          }
+          return options.shareRecords ? records[index] : cloneDecoded(records[index]);
+        }
+        default:
+          throw new Error(`Invalid value tag ${tag} in binary data`);
+      }
+    };
+
+    if (version >= 2) {
+      const recordCount = reader.varint();
+      for (let i = 0; i < recordCount; i++) {
+        records.push(read());
+      }
+    }
+
+    return read();
+  }
+
+  /**
+   * Check for the binary format's magic bytes
+   */
+  static isBinary(bytes: Uint8Array): boolean {
+    return bytes.length > MAGIC.length && MAGIC.every((byte, index) => bytes[index] === byte);
+  }
+}
@@ -1,4 +1,9 @@
 import { Timeline, Element } from '@flare/shared';
+import { FlareBinary } from './binary';
+
+export { FlareBinary } from './binary';
+export type { BinaryDecodeOptions } from './binary';
+export * from './stress-scene';
 
 // For the initial implementation, we'll use a simplified format
 // that's directly loaded as JSON, rather than parsing a binary format
@@ -21,6 +26,22 @@ export class FlareParser {
     }
   }
 
+  /**
+   * Parse a timeline stored in the binary format
+   */
+  static parseBinary(content: Uint8Array): Timeline {
+    try {
+      const data = FlareBinary.decode(content);
+      if (!data || !data.version || !data.frameRate || !data.layers) {
+        throw new Error('Invalid Flare file format');
+      }
+      return data as Timeline;
+    } catch (error) {
+      console.error('Failed to parse Flare content:', error);
+      throw error;
+    }
+  }
+
   /**
    * Create a simplified scene graph from the timeline data
    * (used for initial rendering before full animation support)
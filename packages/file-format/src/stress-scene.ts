@@ -0,0 +1,267 @@
+import { Timeline, Layer, Element, ElementType, Keyframe, PropertyAnimation } from '@flare/shared';
+import { FlareBinary } from './binary';
+
+// Synthetic stress scenes for scaling studies.
+// Scenes are generated from a seed, so the same options always give the same
+// scene and benchmark runs can be compared.
+
+/**
+ * Knobs for generateStressScene
+ */
+export interface StressSceneOptions {
+  elementCount: number;         // Total elements, groups included
+  layerCount?: number;          // Elements are spread evenly across layers
+  nestingDepth?: number;        // Group levels above the leaves; 0 is flat
+  tracksPerElement?: number;    // Animated properties per leaf
+  keyframesPerTrack?: number;   // At most one per frame of the duration
+  easingMix?: string[];         // Easings picked from uniformly
+  pathAnimationCount?: number;
+  triggerDensity?: number;      // Frame triggers per 100 frames
+  duration?: number;            // Frames
+  frameRate?: number;
+  width?: number;
+  height?: number;
+  seed?: number;
+}
+
+/**
+ * A path, shaped like the runtime's Path
+ */
+export interface StressPath {
+  id: string;
+  commands: { type: string, x?: number, y?: number }[];
+  closed: boolean;
+}
+
+/**
+ * A path animation, shaped like the runtime's PathAnimation
+ */
+export interface StressPathAnimation {
+  elementId: string;
+  startFrame: number;
+  duration: number;
+  options: {
+    pathId: string;
+    startOffset: number;
+    endOffset: number;
+    orient: boolean;
+    easing: string;
+  };
+}
+
+/**
+ * A frame trigger, shaped like the runtime's FrameEventTrigger
+ */
+export interface StressTrigger {
+  id: string;
+  type: 'frameEnter';
+  frame: number;
+  action: string;
+}
+
+/**
+ * Everything a stress run loads into the engine
+ */
+export interface StressScene {
+  timeline: Timeline;
+  paths: StressPath[];
+  pathAnimations: StressPathAnimation[];
+  triggers: StressTrigger[];
+}
+
+const DEFAULT_EASINGS = ['linear', 'ease-in', 'ease-out', 'ease-in-out', 'ease-out-bounce'];
+
+const ANIMATED_PROPERTIES = ['x', 'y', 'rotation', 'opacity', 'scaleX', 'scaleY', 'fill'];
+
+/**
+ * Small, fast seeded PRNG (mulberry32)
+ */
+function createRandom(seed: number): () => number {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+/**
+ * Generate a parameterized timeline along with the paths, path animations and
+ * triggers the runtime registers separately
+ */
+export function generateStressScene(options: StressSceneOptions): StressScene {
+  const elementCount = Math.max(0, Math.floor(options.elementCount));
+  const layerCount = Math.max(1, Math.floor(options.layerCount ?? 1));
+  const nestingDepth = Math.max(0, Math.floor(options.nestingDepth ?? 0));
+  const tracksPerElement = Math.max(0, Math.min(ANIMATED_PROPERTIES.length, Math.floor(options.tracksPerElement ?? 2)));
+  const duration = Math.max(1, Math.floor(options.duration ?? 300));
+  // Keyframes sharing a frame would make zero-length segments
+  const keyframesPerTrack = Math.min(duration, Math.max(2, Math.floor(options.keyframesPerTrack ?? 4)));
+  const easings = options.easingMix && options.easingMix.length > 0 ? options.easingMix : DEFAULT_EASINGS;
+  const frameRate = options.frameRate ?? 60;
+  const width = options.width ?? 1920;
+  const height = options.height ?? 1080;
+
+  const random = createRandom(options.seed ?? 1);
+  const pick = <T>(items: T[]): T => items[Math.floor(random() * items.length)];
+  const randomColor = (): string => '#' + Math.floor(random() * 0x1000000).toString(16).padStart(6, '0');
+
+  let nextId = 0;
+  const leafIds: string[] = [];
+
+  const valueFor = (property: string): any => {
+    switch (property) {
+      case 'x': return Math.round(random() * width);
+      case 'y': return Math.round(random() * height);
+      case 'rotation': return Math.round(random() * 360);
+      case 'opacity': return Math.round(random() * 100) / 100;
+      case 'fill': return randomColor();
+      default: return 0.5 + Math.round(random() * 150) / 100;
+    }
+  };
+
+  const createAnimations = (): PropertyAnimation[] => {
+    // Choose distinct properties by shuffling the first few
+    const properties = ANIMATED_PROPERTIES.slice();
+    for (let i = 0; i < tracksPerElement; i++) {
+      const j = i + Math.floor(random() * (properties.length - i));
+      [properties[i], properties[j]] = [properties[j], properties[i]];
+    }
+
+    return properties.slice(0, tracksPerElement).map(property => {
+      const keyframes: Keyframe[] = [];
+      for (let k = 0; k < keyframesPerTrack; k++) {
+        keyframes.push({
+          frame: keyframesPerTrack > 1 ? Math.round((k * (duration - 1)) / (keyframesPerTrack - 1)) : 0,
+          value: valueFor(property),
+          easing: pick(easings)
+        });
+      }
+      return { property, keyframes };
+    });
+  };
+
+  const createLeaf = (): Element => {
+    const id = `el${nextId++}`;
+    leafIds.push(id);
+
+    const circle = random() < 0.5;
+    const properties: Record<string, any> = {
+      x: valueFor('x'),
+      y: valueFor('y'),
+      fill: randomColor()
+    };
+    if (circle) {
+      properties.radius = 2 + Math.round(random() * 30);
+    } else {
+      properties.width = 4 + Math.round(random() * 60);
+      properties.height = 4 + Math.round(random() * 60);
+    }
+
+    const element: Element = {
+      id,
+      type: circle ? ElementType.CIRCLE : ElementType.RECTANGLE,
+      properties
+    };
+    if (tracksPerElement > 0) {
+      element.animations = createAnimations();
+    }
+    return element;
+  };
+
+  // Build `count` elements as a tree `depth` group levels deep
+  const createElements = (count: number, depth: number): Element[] => {
+    const elements: Element[] = [];
+    if (depth === 0 || count < 2) {
+      for (let i = 0; i < count; i++) elements.push(createLeaf());
+      return elements;
+    }
+
+    const fanout = Math.max(2, Math.ceil(Math.pow(count, 1 / (depth + 1))));
+    const groupCount = Math.min(fanout, count);
+    const childCount = count - groupCount;
+
+    for (let g = 0; g < groupCount; g++) {
+      const share = Math.floor(childCount / groupCount) + (g < childCount % groupCount ? 1 : 0);
+      elements.push({
+        id: `group${nextId++}`,
+        type: ElementType.GROUP,
+        properties: { x: 0, y: 0 },
+        children: createElements(share, depth - 1)
+      });
+    }
+    return elements;
+  };
+
+  const layers: Layer[] = [];
+  for (let l = 0; l < layerCount; l++) {
+    const count = Math.floor(elementCount / layerCount) + (l < elementCount % layerCount ? 1 : 0);
+    layers.push({
+      id: `layer${l}`,
+      type: 'normal',
+      visible: true,
+      locked: false,
+      frames: [{ startFrame: 0, duration, elements: createElements(count, nestingDepth) }]
+    });
+  }
+
+  const paths: StressPath[] = [];
+  const pathAnimations: StressPathAnimation[] = [];
+  const pathAnimationCount = leafIds.length > 0 ? Math.max(0, Math.floor(options.pathAnimationCount ?? 0)) : 0;
+
+  for (let p = 0; p < pathAnimationCount; p++) {
+    const pathId = `path${p}`;
+    const commands: StressPath['commands'] = [{ type: 'M', x: valueFor('x'), y: valueFor('y') }];
+    for (let c = 0; c < 3; c++) {
+      commands.push({ type: 'L', x: valueFor('x'), y: valueFor('y') });
+    }
+    paths.push({ id: pathId, commands, closed: false });
+
+    const startFrame = Math.floor(random() * duration / 2);
+    pathAnimations.push({
+      elementId: pick(leafIds),
+      startFrame,
+      duration: Math.max(1, Math.floor(random() * (duration - startFrame))),
+      options: { pathId, startOffset: 0, endOffset: 1, orient: random() < 0.5, easing: pick(easings) }
+    });
+  }
+
+  const triggers: StressTrigger[] = [];
+  const triggerCount = Math.round((duration * Math.max(0, options.triggerDensity ?? 0)) / 100);
+  for (let t = 0; t < triggerCount; t++) {
+    const frame = Math.floor(random() * duration);
+    triggers.push({ id: `trigger${t}`, type: 'frameEnter', frame, action: 'stressTrigger' });
+  }
+
+  return {
+    timeline: {
+      version: '1.0',
+      frameRate,
+      duration,
+      dimensions: { width, height, responsive: false },
+      layers,
+      scripts: []
+    },
+    paths,
+    pathAnimations,
+    triggers
+  };
+}
+
+/**
+ * Serialize a stress scene's timeline as JSON, for FlareParser.parseJSON.
+ * The paths, path animations and triggers are registered separately.
+ */
+export function encodeStressSceneJSON(scene: StressScene): string {
+  return JSON.stringify(scene.timeline);
+}
+
+/**
+ * Serialize a stress scene's timeline in the binary format, for
+ * FlareParser.parseBinary
+ */
+export function encodeStressSceneBinary(scene: StressScene): Uint8Array {
+  return FlareBinary.encode(scene.timeline);
+}
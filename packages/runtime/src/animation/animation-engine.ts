@@ -1,4 +1,4 @@
-import { Timeline, Frame, Layer, Element } from '@flare/shared';
+import { Timeline, Frame, Layer, LayerType, Element, Keyframe, PropertyAnimation } from '@flare/shared';
 import { Easing } from './easing';
 import {
   AnimationGroup,
@@ -14,8 +14,42 @@ import {
   EventTriggerType,
   EventTriggerManager,
   EventHandler,
-  EventData
+  EventData,
+  ElementInteraction
 } from './events';
+import { ElementIndex } from './element-index';
+import { PropertyPathTable } from './property-paths';
+import { FrameScheduler, SchedulerSnapshot } from './scheduler';
+import { CheckpointRing } from './checkpoints';
+
+/**
+ * Animations an element carries, with the keyframe arrays they held.
+ * Group playback replaces keyframe arrays rather than editing them, so
+ * keeping references is enough.
+ */
+interface ElementAnimationState {
+  animations: PropertyAnimation[] | undefined;
+  keyframes: Keyframe[][];
+}
+
+/**
+ * Mutable playback state that a seek has to reconstruct
+ */
+interface PlaybackState {
+  sequences: { id: string, currentStep: number, iterations: number }[];
+  scheduler: SchedulerSnapshot;
+  groupTargets: Map<Element, ElementAnimationState>;
+}
+
+/**
+ * A visible layer's elements at the current time
+ */
+export interface LayerElements {
+  id: string;
+  type: string;           // LayerType
+  elements: Element[];
+  mask: number;           // Index of the mask or clip layer in the same list that applies to it, or -1
+}
 
 /**
  * Enhanced AnimationEngine that integrates all the new features
@@ -23,6 +57,8 @@ import {
 export class AnimationEngine {
   private timeline: Timeline;
   private currentFrame: number = 0;
+  private frameFraction: number = 0;     // Progress towards the next frame, 0..1
+  private subFrameInterpolation: boolean = true;
   private isPlaying: boolean = false;
   private lastFrameTime: number = 0;
   private animationFrameId: number = 0;
@@ -30,6 +66,11 @@ export class AnimationEngine {
   // New components
   private pathManager: PathManager;
   private eventManager: EventTriggerManager;
+  private elementIndex: ElementIndex;
+  private propertyPaths: PropertyPathTable;
+  private scheduler: FrameScheduler;
+  private checkpoints: CheckpointRing<PlaybackState> = new CheckpointRing();
+  private groupTargets: Map<Element, ElementAnimationState> = new Map();  // Pristine state of elements groups have animated
   private groups: Map<string, AnimationGroup> = new Map();
   private sequences: Map<string, AnimationSequence> = new Map();
   private activeSequences: Map<string, {
@@ -42,6 +83,11 @@ export class AnimationEngine {
     this.timeline = timeline;
     this.pathManager = new PathManager();
     this.eventManager = new EventTriggerManager();
+    this.elementIndex = ElementIndex.fromTimeline(timeline);
+    this.propertyPaths = new PropertyPathTable();
+    this.propertyPaths.compileTimeline(timeline);
+    this.scheduler = new FrameScheduler(timeline.duration);
+    this.checkpoints.record(0, this.capturePlaybackState());
 
     // Set up default event actions
     this.setupDefaultEventActions();
@@ -146,7 +192,10 @@ export class AnimationEngine {
     const wasPlaying = this.isPlaying;
     this.pause();
     this.currentFrame = 0;
+    this.frameFraction = 0;
     this.activeSequences.clear();
+    this.scheduler.reset(0);
+    this.playbackStateChanged();
 
     // Update the event manager with new frame
     this.eventManager.updateFrame(this.currentFrame);
@@ -160,12 +209,55 @@ export class AnimationEngine {
    */
   public seekToFrame(frame: number): void {
     const oldFrame = this.currentFrame;
-    this.currentFrame = Math.max(0, Math.min(frame, this.timeline.duration - 1));
+    const time = Math.max(0, Math.min(frame, this.timeline.duration - 1));
+
+    // Discrete semantics use the whole frame; the remainder only feeds interpolation
+    this.frameFraction = time - Math.floor(time);
+
+    // Rebuild sequence progress, pending continuations and group keyframes
+    this.seekPlaybackState(oldFrame, Math.floor(time));
 
     // Update event manager with the new frame
     this.eventManager.updateFrame(this.currentFrame);
   }
 
+  /**
+   * Bring playback state from one frame to another by replaying the frames
+   * in between. Replay starts from the nearest checkpoint when it's closer
+   * than the current frame, which backward seeks always need, so scrubbing
+   * back costs at most one checkpoint interval.
+   */
+  private seekPlaybackState(fromFrame: number, toFrame: number): void {
+    if (toFrame === fromFrame) return;
+
+    // What happened after the target is no longer the history being played
+    if (toFrame < fromFrame) this.checkpoints.invalidateFrom(toFrame + 1);
+
+    const checkpoint = this.checkpoints.nearest(toFrame);
+    if (toFrame < fromFrame && !checkpoint) {
+      // Evicted: run or re-base what's pending
+      this.scheduler.seek(toFrame);
+      this.currentFrame = toFrame;
+      return;
+    }
+
+    if (checkpoint && (toFrame < fromFrame || checkpoint.frame > fromFrame)) {
+      this.restorePlaybackState(checkpoint.state);
+      this.currentFrame = checkpoint.frame;
+      if (toFrame === checkpoint.frame) return;
+    }
+
+    // Frames on the way rebuild state without dispatching their events;
+    // only tasks on the target frame are announced, whichever way the seek went
+    this.eventManager.setMuted(true);
+    try {
+      this.stepFrames(toFrame - this.currentFrame - 1);
+    } finally {
+      this.eventManager.setMuted(false);
+    }
+    this.stepFrames(1);
+  }
+
   /**
    * The main animation loop
    */
@@ -190,6 +282,9 @@ export class AnimationEngine {
       this.eventManager.updateFrame(this.currentFrame);
     }
 
+    // Time since the last whole frame, used to interpolate at the presentation timestamp
+    this.frameFraction = Math.min(Math.max((now - this.lastFrameTime) / frameTime, 0), 1 - 1e-6);
+
     // Request next frame if still playing
     if (this.isPlaying) {
       this.animationFrameId = requestAnimationFrame(() => this.animationLoop());
@@ -200,23 +295,159 @@ export class AnimationEngine {
    * Advance the animation by a number of frames
    */
   private advanceFrames(frames: number): void {
-    this.currentFrame += frames;
+    // Timelines that don't loop hold their last frame and stop there
+    if (this.timeline.loop === false) {
+      const remaining = Math.max(0, this.timeline.duration - 1 - this.currentFrame);
+      if (frames >= remaining) {
+        this.stepFrames(remaining);
+        this.pause();
+        return;
+      }
+    }
 
-    // Check if we've reached the end
-    if (this.currentFrame >= this.timeline.duration) {
-      // Loop back to beginning
-      this.currentFrame = this.currentFrame % this.timeline.duration;
+    const looped = this.stepFrames(frames);
 
+    if (looped) {
       // Trigger loop event
       this.eventManager.triggerPlaybackEvent(EventTriggerType.LOOP);
     }
   }
 
+  /**
+   * Move forward frame by frame, running scheduled continuations and recording
+   * checkpoints as they come due. Returns whether the timeline looped.
+   */
+  private stepFrames(frames: number): boolean {
+    let looped = false;
+
+    for (let i = 0; i < frames; i++) {
+      this.scheduler.advance(1);
+      this.currentFrame++;
+
+      // Loop back to beginning; checkpoints only describe the current pass
+      if (this.currentFrame >= this.timeline.duration) {
+        this.currentFrame = 0;
+        this.checkpoints.clear();
+        looped = true;
+      }
+
+      if (this.checkpoints.isDue(this.currentFrame)) {
+        this.checkpoints.record(this.currentFrame, this.capturePlaybackState());
+      }
+    }
+
+    return looped;
+  }
+
+  /**
+   * Copy the mutable playback state
+   */
+  private capturePlaybackState(): PlaybackState {
+    const sequences: PlaybackState['sequences'] = [];
+    this.activeSequences.forEach((active, id) => {
+      sequences.push({ id, currentStep: active.currentStep, iterations: active.iterations });
+    });
+
+    const groupTargets = new Map<Element, ElementAnimationState>();
+    this.groupTargets.forEach((_, element) => {
+      groupTargets.set(element, this.captureElementAnimations(element));
+    });
+
+    return {
+      sequences,
+      scheduler: this.scheduler.snapshot(),
+      groupTargets
+    };
+  }
+
+  /**
+   * Put back state captured by capturePlaybackState
+   */
+  private restorePlaybackState(state: PlaybackState): void {
+    this.activeSequences.clear();
+    state.sequences.forEach(({ id, currentStep, iterations }) => {
+      const sequence = this.sequences.get(id);
+      if (sequence) {
+        this.activeSequences.set(id, { sequence, currentStep, iterations });
+      }
+    });
+
+    this.scheduler.restore(state.scheduler);
+
+    // Elements first animated by a group after the checkpoint go back to pristine
+    this.groupTargets.forEach((pristine, element) => {
+      this.restoreElementAnimations(element, state.groupTargets.get(element) || pristine);
+    });
+  }
+
+  private captureElementAnimations(element: Element): ElementAnimationState {
+    return {
+      animations: element.animations ? element.animations.slice() : undefined,
+      keyframes: element.animations ? element.animations.map(animation => animation.keyframes) : []
+    };
+  }
+
+  private restoreElementAnimations(element: Element, state: ElementAnimationState): void {
+    if (!state.animations) {
+      delete element.animations;
+      return;
+    }
+
+    element.animations = state.animations.slice();
+    state.animations.forEach((animation, index) => {
+      animation.keyframes = state.keyframes[index];
+    });
+  }
+
+  /**
+   * Record that playback state changed outside of frame playback (a sequence
+   * started or stopped). Later checkpoints no longer describe what happens.
+   */
+  private playbackStateChanged(): void {
+    this.checkpoints.invalidateFrom(this.currentFrame);
+    this.checkpoints.record(this.currentFrame, this.capturePlaybackState());
+  }
+
+  /**
+   * Set how many frames apart playback checkpoints are recorded
+   */
+  public setCheckpointInterval(frames: number): void {
+    this.checkpoints = new CheckpointRing(frames);
+    this.checkpoints.record(this.currentFrame, this.capturePlaybackState());
+  }
+
+  /**
+   * Enable or disable interpolation between whole timeline frames
+   */
+  public setSubFrameInterpolation(enabled: boolean): void {
+    this.subFrameInterpolation = enabled;
+  }
+
+  /**
+   * Get the current whole timeline frame
+   */
+  public getCurrentFrame(): number {
+    return this.currentFrame;
+  }
+
+  /**
+   * Get the presentation time in (fractional) frames.
+   * Tracks and paths are evaluated at this time; triggers and frame spans use getCurrentFrame().
+   */
+  public getCurrentTime(): number {
+    if (!this.subFrameInterpolation) return this.currentFrame;
+
+    // Don't interpolate past the final frame into the loop
+    const time = this.currentFrame + this.frameFraction;
+    return Math.min(time, this.timeline.duration - 1);
+  }
+
   /**
    * Get the current elements to display with all animations applied
    */
   public getCurrentElements(): Element[] {
     let elements: Element[] = [];
+    const time = this.getCurrentTime();
 
     // For each layer
     for (const layer of this.timeline.layers) {
@@ -225,17 +456,56 @@ export class AnimationEngine {
       // Find the active frame for this layer at the current time
       const activeFrame = this.findActiveFrame(layer);
       if (activeFrame) {
-        // Apply standard animations to the elements
-        let animatedElements = this.applyAnimations(activeFrame.elements, activeFrame);
+        elements.push(...this.animateFrame(activeFrame, time));
+      }
+    }
+
+    return elements;
+  }
+
+  /**
+   * Get the current elements layer by layer, with each layer's mask.
+   * Mask and clip layers are listed whether or not they have elements:
+   * an empty mask hides what it masks. A hidden mask masks nothing.
+   */
+  public getCurrentLayers(): LayerElements[] {
+    const layers: LayerElements[] = [];
+    const time = this.getCurrentTime();
+    let mask = -1;
+    let masked = 0;             // Timeline layers the current mask still applies to
 
-        // Apply path-based animations
-        animatedElements = this.pathManager.applyPathAnimations(animatedElements, this.currentFrame);
+    for (const layer of this.timeline.layers) {
+      const isMask = layer.type === LayerType.MASK || layer.type === LayerType.CLIP;
+      let layerMask = -1;
+
+      if (isMask) {
+        mask = -1;
+        masked = Math.max(0, Math.floor(layer.masks ?? 1));
+      } else if (masked > 0) {
+        masked--;
+        layerMask = mask;
+      }
+      if (!layer.visible) continue;
 
-        elements.push(...animatedElements);
+      const activeFrame = this.findActiveFrame(layer);
+      const elements = activeFrame ? this.animateFrame(activeFrame, time) : [];
+      if (isMask) {
+        mask = layers.length;
+      } else if (elements.length === 0) {
+        continue;
       }
+      layers.push({ id: layer.id, type: layer.type, elements, mask: layerMask });
     }
 
-    return elements;
+    return layers;
+  }
+
+  /**
+   * A frame's elements with standard and path-based animations applied
+   */
+  private animateFrame(frame: Frame, time: number): Element[] {
+    const animatedElements = this.applyAnimations(frame.elements, frame, time);
+    return this.pathManager.applyPathAnimations(animatedElements, time);
   }
 
   /**
@@ -254,7 +524,7 @@ export class AnimationEngine {
   /**
    * Apply animations to elements
    */
-  private applyAnimations(elements: Element[], frame: Frame): Element[] {
+  private applyAnimations(elements: Element[], frame: Frame, time: number): Element[] {
     return elements.map(element => {
       // Deep clone the element to avoid modifying the original
       const animatedElement = JSON.parse(JSON.stringify(element)) as Element;
@@ -264,6 +534,8 @@ export class AnimationEngine {
 
       // For each animation on this element
       for (const animation of element.animations) {
+        const property = this.propertyPaths.resolve(animation);
+
         // Find the keyframes that bracket the current time
         let startKeyframe = null;
         let endKeyframe = null;
@@ -275,7 +547,7 @@ export class AnimationEngine {
           const absoluteCurrentFrame = frame.startFrame + currentKeyframe.frame;
           const absoluteNextFrame = frame.startFrame + nextKeyframe.frame;
 
-          if (this.currentFrame >= absoluteCurrentFrame && this.currentFrame <= absoluteNextFrame) {
+          if (time >= absoluteCurrentFrame && time <= absoluteNextFrame) {
             startKeyframe = currentKeyframe;
             endKeyframe = nextKeyframe;
             break;
@@ -286,7 +558,7 @@ export class AnimationEngine {
         if (startKeyframe && endKeyframe) {
           const absoluteStartFrame = frame.startFrame + startKeyframe.frame;
           const absoluteEndFrame = frame.startFrame + endKeyframe.frame;
-          const progress = (this.currentFrame - absoluteStartFrame) / (absoluteEndFrame - absoluteStartFrame);
+          const progress = (time - absoluteStartFrame) / (absoluteEndFrame - absoluteStartFrame);
 
           // Apply easing using our enhanced easing system
           const easingFunction = Easing.getEasingFunction(startKeyframe.easing || 'linear');
@@ -300,12 +572,12 @@ export class AnimationEngine {
           if (typeof startValue === 'number' && typeof endValue === 'number') {
             // Numeric values
             const interpolatedValue = startValue + (endValue - startValue) * easedProgress;
-            this.setNestedProperty(animatedElement.properties, animation.property, interpolatedValue);
+            this.propertyPaths.set(animatedElement.properties, property, interpolatedValue);
           } else if (typeof startValue === 'string' && typeof endValue === 'string') {
             // Check for color values
             if (startValue.startsWith('#') && endValue.startsWith('#')) {
               const interpolatedColor = this.interpolateColor(startValue, endValue, easedProgress);
-              this.setNestedProperty(animatedElement.properties, animation.property, interpolatedColor);
+              this.propertyPaths.set(animatedElement.properties, property, interpolatedColor);
             }
           } else if (
             Array.isArray(startValue) &&
@@ -320,7 +592,7 @@ export class AnimationEngine {
               }
               return end; // Fallback for non-numeric array values
             });
-            this.setNestedProperty(animatedElement.properties, animation.property, interpolatedArray);
+            this.propertyPaths.set(animatedElement.properties, property, interpolatedArray);
           }
         }
       }
@@ -368,41 +640,6 @@ export class AnimationEngine {
     return '#' + result.map(c => c.toString(16).padStart(2, '0')).join('');
   }
 
-  /**
-   * Get a nested property from an object
-   */
-  private getNestedProperty(obj: any, path: string): any {
-    const parts = path.split('.');
-    let current = obj;
-
-    for (const part of parts) {
-      if (current === null || current === undefined || !(part in current)) {
-        return undefined;
-      }
-      current = current[part];
-    }
-
-    return current;
-  }
-
-  /**
-   * Set a nested property on an object
-   */
-  private setNestedProperty(obj: any, path: string, value: any): void {
-    const parts = path.split('.');
-    let current = obj;
-
-    for (let i = 0; i < parts.length - 1; i++) {
-      const part = parts[i];
-      if (!(part in current)) {
-        current[part] = {};
-      }
-      current = current[part];
-    }
-
-    current[parts[parts.length - 1]] = value;
-  }
-
   /**************************************
    * Animation Group and Sequence Methods
    **************************************/
@@ -433,6 +670,9 @@ export class AnimationEngine {
     const sequence = this.sequences.get(sequenceId);
     if (!sequence) return;
 
+    // Drop continuations left over from an earlier run of this sequence
+    this.scheduler.cancelOwner(`sequence_${sequenceId}`);
+
     this.activeSequences.set(sequenceId, {
       sequence,
       currentStep: 0,
@@ -441,6 +681,7 @@ export class AnimationEngine {
 
     // Execute the first step
     this.executeSequenceStep(sequenceId);
+    this.playbackStateChanged();
 
     // Make sure animation is playing
     this.play();
@@ -451,6 +692,8 @@ export class AnimationEngine {
    */
   public stopSequence(sequenceId: string): void {
     this.activeSequences.delete(sequenceId);
+    this.scheduler.cancelOwner(`sequence_${sequenceId}`);
+    this.playbackStateChanged();
   }
 
   /**
@@ -495,16 +738,37 @@ export class AnimationEngine {
       return;
     }
 
+    // Delayed steps start once the playhead has moved on by `delay` frames
+    if (step.delay && step.delay > 0) {
+      this.scheduler.scheduleAfter(step.delay, () => {
+        this.startSequenceStep(sequenceId, group);
+      }, `sequence_${sequenceId}`);
+    } else {
+      this.startSequenceStep(sequenceId, group);
+    }
+  }
+
+  /**
+   * Play the group of the current sequence step and schedule what comes next
+   */
+  private startSequenceStep(sequenceId: string, group: AnimationGroup): void {
+    const activeSequence = this.activeSequences.get(sequenceId);
+    if (!activeSequence) return;
+
+    const { sequence, currentStep } = activeSequence;
+    const step = sequence.steps[currentStep];
+
     // Execute the group animations
-    this.playGroup(group);
+    const completionFrame = this.playGroup(group);
 
     // If we don't need to wait for completion, move to next step
     if (!step.waitForComplete) {
       activeSequence.currentStep++;
       this.executeSequenceStep(sequenceId);
     } else {
-      // Set up a one-time listener for group completion
-      const onComplete = (data: EventData) => {
+      // Continue when this group completes; the group's own completion task
+      // was scheduled first, so animationComplete fires before this runs
+      this.scheduler.scheduleAtAbsoluteFrame(completionFrame, () => {
         // Trigger step completion event if specified
         if (step.onComplete) {
           this.eventManager.dispatchEvent(step.onComplete, {
@@ -515,26 +779,25 @@ export class AnimationEngine {
           });
         }
 
-        // Move to next step
-        activeSequence.currentStep++;
+        // Move to next step; look the sequence up again, a checkpoint
+        // restore may have replaced its entry
+        const current = this.activeSequences.get(sequenceId);
+        if (!current) return;
+        current.currentStep++;
         this.executeSequenceStep(sequenceId);
-
-        // Remove this listener
-        this.eventManager.removeEventListener('animationComplete', onComplete);
-      };
-
-      this.eventManager.addEventListener('animationComplete', onComplete);
+      }, `sequence_${sequenceId}`);
     }
   }
 
   /**
-   * Play animations in a group
+   * Play animations in a group and return the frame it completes on
    */
-  private playGroup(group: AnimationGroup): void {
+  private playGroup(group: AnimationGroup): number {
     // Get all the elements in the group
     const elements = group.elementIds.map(id => this.findElementById(id)).filter(Boolean) as Element[];
 
     // Apply animations based on group type
+    let lastDelay = 0;
     switch (group.type) {
       case AnimationGroupType.PARALLEL:
         // Start all animations at the same time
@@ -548,6 +811,7 @@ export class AnimationEngine {
         elements.forEach((element, index) => {
           const delay = (group.duration / elements.length) * index;
           this.applyGroupAnimationToElement(element, group, delay);
+          lastDelay = delay;
         });
         break;
 
@@ -556,19 +820,23 @@ export class AnimationEngine {
         const staggerDelay = group.staggerDelay || 5; // Default to 5 frames if not specified
         elements.forEach((element, index) => {
           this.applyGroupAnimationToElement(element, group, staggerDelay * index);
+          lastDelay = staggerDelay * index;
         });
         break;
     }
 
-    // Set a timeout to trigger the completion event
-    const completionFrame = group.startFrame + group.duration;
+    // Trigger the completion event once the last element has finished, in
+    // a later loop if that's past the end of the timeline
+    const completionFrame = Math.ceil(group.startFrame + lastDelay + group.duration);
     this.addFrameListener(completionFrame, () => {
       this.eventManager.dispatchEvent('animationComplete', {
         triggerId: `group_${group.id}`,
         timestamp: Date.now(),
         groupId: group.id
       });
-    });
+    }, `group_${group.id}`);
+
+    return completionFrame;
   }
 
   /**
@@ -577,6 +845,11 @@ export class AnimationEngine {
   private applyGroupAnimationToElement(element: Element, group: AnimationGroup, delayFrames: number): void {
     if (!element) return;
 
+    // Remember what the element looked like before any group touched it
+    if (!this.groupTargets.has(element)) {
+      this.groupTargets.set(element, this.captureElementAnimations(element));
+    }
+
     if (!element.animations) {
       element.animations = [];
     }
@@ -599,7 +872,8 @@ export class AnimationEngine {
       const endFrame = startFrame + group.duration;
 
       // Get the element's current property value
-      const currentValue = this.getNestedProperty(element.properties, property) || 0;
+      const compiledProperty = this.propertyPaths.resolve(animation);
+      const currentValue = this.propertyPaths.get(element.properties, compiledProperty) || 0;
 
       // Create a simple animation that doubles the value (for demonstration)
       // In a real implementation, you'd use property-specific logic or values from the group definition
@@ -622,20 +896,48 @@ export class AnimationEngine {
    * Find an element by ID across all layers and frames
    */
   private findElementById(id: string): Element | null {
+    return this.elementIndex.findById(id);
+  }
+
+  /**
+   * Add an element to a frame of a layer
+   */
+  public addElement(layerId: string, frameIndex: number, element: Element): boolean {
+    const layer = this.timeline.layers.find(l => l.id === layerId);
+    if (!layer || !layer.frames[frameIndex]) return false;
+
+    layer.frames[frameIndex].elements.push(element);
+    this.elementIndex.insert(element);
+    return true;
+  }
+
+  /**
+   * Remove an element by ID from whichever frame holds it
+   */
+  public removeElement(id: string): boolean {
+    const element = this.elementIndex.findById(id);
+    if (!element) return false;
+
     for (const layer of this.timeline.layers) {
       for (const frame of layer.frames) {
-        const element = frame.elements.find(e => e.id === id);
-        if (element) return element;
+        const index = frame.elements.indexOf(element);
+        if (index !== -1) {
+          frame.elements.splice(index, 1);
+          this.elementIndex.remove(id, element);
+          return true;
+        }
       }
     }
-    return null;
+
+    return false;
   }
 
   /**
-   * Add a listener to be called at a specific frame
+   * Add a listener to be called at a specific frame, counted from the start
+   * of the current loop
    */
-  private addFrameListener(frame: number, callback: Function): void {
-    this.eventManager.addEventListener(`frame_${frame}`, callback as EventHandler);
+  private addFrameListener(frame: number, callback: () => void, owner?: string): number {
+    return this.scheduler.scheduleAtAbsoluteFrame(frame, callback, owner);
   }
 
   /**************************************
@@ -767,6 +1069,13 @@ export class AnimationEngine {
     }
   }
 
+  /**
+   * Process a batch of user interactions, such as one tick's worth of input
+   */
+  public handleElementInteractions(interactions: ElementInteraction[]): void {
+    this.eventManager.triggerInteractions(interactions);
+  }
+
   /**
    * Trigger a custom event
    */
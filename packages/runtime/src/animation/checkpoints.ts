@@ -0,0 +1,111 @@
+// Playback Checkpoints
+
+/**
+ * A saved copy of mutable playback state at a timeline frame
+ */
+export interface Checkpoint<T> {
+  frame: number;
+  state: T;
+}
+
+/**
+ * Bounded store of checkpoints ordered by frame.
+ *
+ * Playback records one every `interval` frames; a seek restores the nearest
+ * checkpoint at or before the target and replays the rest, so scrubbing costs
+ * at most `interval` frames of work instead of a replay from frame 0. When
+ * full, the earliest checkpoint is dropped.
+ */
+export class CheckpointRing<T> {
+  private entries: Checkpoint<T>[] = [];
+  private capacity: number;
+  public readonly interval: number;
+
+  constructor(interval: number = 30, capacity: number = 64) {
+    this.interval = Math.max(1, Math.floor(interval));
+    this.capacity = Math.max(1, Math.floor(capacity));
+  }
+
+  /**
+   * Whether playback should record a checkpoint on this frame
+   */
+  public isDue(frame: number): boolean {
+    return frame % this.interval === 0;
+  }
+
+  /**
+   * Store state for a frame, replacing any checkpoint already on it
+   */
+  public record(frame: number, state: T): void {
+    const index = this.lowerBound(frame);
+
+    if (index < this.entries.length && this.entries[index].frame === frame) {
+      this.entries[index].state = state;
+      return;
+    }
+
+    if (this.entries.length >= this.capacity) {
+      // Full: a checkpoint before everything we keep isn't worth keeping
+      if (index === 0) return;
+      this.entries.shift();
+      this.entries.splice(index - 1, 0, { frame, state });
+      return;
+    }
+
+    this.entries.splice(index, 0, { frame, state });
+  }
+
+  /**
+   * The latest checkpoint at or before a frame
+   */
+  public nearest(frame: number): Checkpoint<T> | null {
+    const index = this.lowerBound(frame + 1) - 1;
+    return index >= 0 ? this.entries[index] : null;
+  }
+
+  /**
+   * Drop checkpoints on or after a frame, once the history from there on changed
+   */
+  public invalidateFrom(frame: number): void {
+    this.entries.length = this.lowerBound(frame);
+  }
+
+  /**
+   * Drop every checkpoint
+   */
+  public clear(): void {
+    this.entries = [];
+  }
+
+  /**
+   * Frames that currently have a checkpoint
+   */
+  public getFrames(): number[] {
+    return this.entries.map(entry => entry.frame);
+  }
+
+  /**
+   * Number of stored checkpoints
+   */
+  public get size(): number {
+    return this.entries.length;
+  }
+
+  /**
+   * Index of the first checkpoint on or after a frame
+   */
+  private lowerBound(frame: number): number {
+    let low = 0;
+    let high = this.entries.length;
+
+    while (low < high) {
+      const mid = (low + high) >> 1;
+      if (this.entries[mid].frame < frame) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+}
@@ -0,0 +1,126 @@
+// Element ID Index
+
+import { Timeline, Element } from '@flare/shared';
+
+/**
+ * Interns element IDs into dense integer handles.
+ *
+ * Built once when a timeline is loaded and kept up to date as elements are
+ * inserted and removed, so resolving an ID is a single hash lookup instead of
+ * a walk over every layer, frame and element.
+ */
+export class ElementIndex {
+  private handles: Map<string, number> = new Map();
+  private elements: (Element | null)[] = [];
+  private freeHandles: number[] = [];
+  // Later elements with an already indexed ID, in order; the next one takes
+  // over the ID's handle when the element holding it is removed
+  private duplicates: Map<string, Element[]> = new Map();
+
+  /**
+   * Build an index over the top-level elements of every layer and frame.
+   * When IDs repeat, the first occurrence in layer/frame order wins.
+   */
+  public static fromTimeline(timeline: Timeline): ElementIndex {
+    const index = new ElementIndex();
+
+    for (const layer of timeline.layers) {
+      for (const frame of layer.frames) {
+        for (const element of frame.elements) {
+          index.insert(element);
+        }
+      }
+    }
+
+    return index;
+  }
+
+  /**
+   * Add an element and return its handle.
+   * If the ID is already indexed the existing handle is returned unchanged,
+   * and the element is kept in case the indexed one is removed.
+   */
+  public insert(element: Element): number {
+    const existing = this.handles.get(element.id);
+    if (existing !== undefined) {
+      if (this.elements[existing] !== element) {
+        const duplicates = this.duplicates.get(element.id);
+        if (duplicates) {
+          duplicates.push(element);
+        } else {
+          this.duplicates.set(element.id, [element]);
+        }
+      }
+      return existing;
+    }
+
+    const handle = this.freeHandles.length > 0
+      ? this.freeHandles.pop()!
+      : this.elements.length;
+
+    this.elements[handle] = element;
+    this.handles.set(element.id, handle);
+    return handle;
+  }
+
+  /**
+   * Remove an element by ID; its handle is recycled. When several elements
+   * share the ID, `element` picks which goes (the indexed one by default),
+   * and the next of the others takes over the handle.
+   */
+  public remove(id: string, element?: Element): boolean {
+    const handle = this.handles.get(id);
+    if (handle === undefined) return false;
+
+    const duplicates = this.duplicates.get(id);
+    if (element && element !== this.elements[handle]) {
+      const index = duplicates ? duplicates.indexOf(element) : -1;
+      if (index === -1) return false;
+
+      duplicates!.splice(index, 1);
+      if (duplicates!.length === 0) this.duplicates.delete(id);
+      return true;
+    }
+
+    if (duplicates) {
+      this.elements[handle] = duplicates.shift()!;
+      if (duplicates.length === 0) this.duplicates.delete(id);
+      return true;
+    }
+
+    this.handles.delete(id);
+    this.elements[handle] = null;
+    this.freeHandles.push(handle);
+    return true;
+  }
+
+  /**
+   * Get the handle for an ID, or -1 if it isn't indexed
+   */
+  public getHandle(id: string): number {
+    const handle = this.handles.get(id);
+    return handle === undefined ? -1 : handle;
+  }
+
+  /**
+   * Get the element for a handle
+   */
+  public getElement(handle: number): Element | null {
+    return this.elements[handle] || null;
+  }
+
+  /**
+   * Find an element by ID
+   */
+  public findById(id: string): Element | null {
+    const handle = this.handles.get(id);
+    return handle === undefined ? null : this.elements[handle];
+  }
+
+  /**
+   * Number of indexed elements
+   */
+  public get size(): number {
+    return this.handles.size;
+  }
+}
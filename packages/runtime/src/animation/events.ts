@@ -69,6 +69,15 @@ export interface InteractionEventTrigger extends EventTrigger {
     elementId: string;            // Element to attach interaction to
 }
 
+/**
+ * One user interaction in a batch passed to triggerInteractions
+ */
+export interface ElementInteraction {
+    type: InteractionEventTrigger['type'];
+    elementId: string;
+    eventData?: any;
+}
+
 /**
  * Custom event trigger
  */
@@ -111,6 +120,7 @@ export class EventTriggerManager {
     private activeRangeTriggers: Set<string> = new Set();
     private currentFrame: number = 0;
     private previousFrame: number = 0;
+    private muted: boolean = false;
 
     /**
      * Register an event trigger
@@ -159,7 +169,7 @@ export class EventTriggerManager {
      * Fire an event
      */
     public dispatchEvent(event: string, data: EventData): void {
-        if (!this.handlers.has(event)) return;
+        if (this.muted || !this.handlers.has(event)) return;
         
         const handlers = this.handlers.get(event);
         if (!handlers) return;
@@ -173,6 +183,13 @@ export class EventTriggerManager {
         });
     }
 
+    /**
+     * Suppress event dispatch, e.g. while replaying frames to rebuild state
+     */
+    public setMuted(muted: boolean): void {
+        this.muted = muted;
+    }
+
     /**
      * Update frame position and check for triggers
      */
@@ -211,6 +228,43 @@ export class EventTriggerManager {
         });
     }
 
+    /**
+     * Fire the interaction triggers for a batch of interactions, in order.
+     * The triggers are looked up once per batch instead of once per interaction.
+     */
+    public triggerInteractions(interactions: ElementInteraction[]): void {
+        if (interactions.length === 0) return;
+
+        // Index interaction triggers by type and element
+        const index = new Map<string, InteractionEventTrigger[]>();
+        for (const trigger of this.triggers) {
+            if (!('elementId' in trigger)) continue;
+            const key = trigger.type + ':' + trigger.elementId;
+            const matching = index.get(key);
+            if (matching) {
+                matching.push(trigger);
+            } else {
+                index.set(key, [trigger]);
+            }
+        }
+
+        const timestamp = Date.now();
+        for (const interaction of interactions) {
+            const matchingTriggers = index.get(interaction.type + ':' + interaction.elementId);
+            if (!matchingTriggers) continue;
+
+            matchingTriggers.forEach(trigger => {
+                this.executeTriggerAction(trigger, {
+                    triggerId: trigger.id,
+                    timestamp,
+                    currentFrame: this.currentFrame,
+                    elementId: interaction.elementId,
+                    ...interaction.eventData
+                });
+            });
+        }
+    }
+
     /**
      * Trigger a custom event
      */
@@ -254,23 +308,6 @@ export class EventTriggerManager {
         });
     }
 
-
-    private checkFrameEvents(): void {
-        const eventName = `frame_${this.currentFrame}`;
-        if (this.handlers.has(eventName)) {
-            const listeners = this.handlers.get(eventName);
-            if (listeners) {
-                listeners.forEach(callback => callback({
-                    triggerId: `frame_${this.currentFrame}`,
-                    timestamp: Date.now()
-                }));
-                
-                // Clear one-time frame listeners
-                this.handlers.set(eventName, []);
-            }
-        }
-    }
-
     /**
      * Check for frame-specific triggers
      */
@@ -3,6 +3,9 @@
 import { Timeline, Frame, Layer, Element } from '@flare/shared';
 import { Easing, EasingFunction } from './easing';
 import { EventTriggerManager } from './events';
+import { ElementIndex } from './element-index';
+import { PropertyPathTable } from './property-paths';
+import { FrameScheduler } from './scheduler';
 
 /**
  * Animation group types
@@ -34,6 +37,7 @@ export interface AnimationStep {
   groupId: string;        // Reference to an animation group
   waitForComplete: boolean; // Whether to wait for completion before next step
   onComplete?: string;    // Event to trigger when this step completes
+  delay?: number;         // Frames to wait before the step starts
 }
 
 /**
@@ -56,6 +60,9 @@ export class AnimationEngine {
   private lastFrameTime: number = 0;
   private animationFrameId: number = 0;
   private eventManager: EventTriggerManager;
+  private elementIndex: ElementIndex;
+  private propertyPaths: PropertyPathTable;
+  private scheduler: FrameScheduler;
   private eventListeners: Map<string, Function[]> = new Map(); // Add this if it's used in the class
 
   // Animation groups and sequences
@@ -71,6 +78,10 @@ export class AnimationEngine {
     this.timeline = timeline;
 
     this.eventManager = new EventTriggerManager(); // Initialize it
+    this.elementIndex = ElementIndex.fromTimeline(timeline);
+    this.propertyPaths = new PropertyPathTable();
+    this.propertyPaths.compileTimeline(timeline);
+    this.scheduler = new FrameScheduler(timeline.duration);
     // Initialize the eventListeners map if needed
     this.eventListeners = new Map();
 
@@ -124,6 +135,7 @@ export class AnimationEngine {
    */
   public stopSequence(sequenceId: string): void {
     this.activeSequences.delete(sequenceId);
+    this.scheduler.cancelOwner(`sequence_${sequenceId}`);
   }
 
   /**
@@ -224,7 +236,8 @@ export class AnimationEngine {
         break;
     }
 
-    // Set a timeout to trigger the completion event
+    // Trigger the completion event, in a later loop if the group ends past
+    // the end of the timeline
     const completionFrame = group.startFrame + group.duration;
     this.addFrameListener(completionFrame, () => {
       this.eventManager.dispatchEvent('animationComplete', {
@@ -265,7 +278,8 @@ export class AnimationEngine {
       const endFrame = startFrame + group.duration;
 
       // Get the element's current property value
-      const currentValue = this.getNestedProperty(element.properties, property) || 0;
+      const compiledProperty = this.propertyPaths.resolve(animation);
+      const currentValue = this.propertyPaths.get(element.properties, compiledProperty) || 0;
 
       // Create a simple animation that doubles the value (for demonstration)
       // In a real implementation, you'd use property-specific logic
@@ -288,63 +302,15 @@ export class AnimationEngine {
    * Find an element by ID across all layers and frames
    */
   private findElementById(id: string): Element | null {
-    for (const layer of this.timeline.layers) {
-      for (const frame of layer.frames) {
-        const element = frame.elements.find(e => e.id === id);
-        if (element) return element;
-      }
-    }
-    return null;
-  }
-
-  /**
-   * Add a listener to be called at a specific frame
-   */
-  private addFrameListener(frame: number, callback: Function): void {
-    const eventName = `frame_${frame}`;
-    if (!this.eventListeners.has(eventName)) {
-      this.eventListeners.set(eventName, []);
-    }
-
-    const listeners = this.eventListeners.get(eventName);
-    if (listeners) {
-      listeners.push(callback);
-    }
-  }
-
-  /**
-   * Get a nested property from an object
-   */
-  private getNestedProperty(obj: any, path: string): any {
-    const parts = path.split('.');
-    let current = obj;
-
-    for (const part of parts) {
-      if (current === null || current === undefined || !(part in current)) {
-        return undefined;
-      }
-      current = current[part];
-    }
-
-    return current;
+    return this.elementIndex.findById(id);
   }
 
   /**
-   * Set a nested property on an object
+   * Add a listener to be called at a specific frame, counted from the start
+   * of the current loop
    */
-  private setNestedProperty(obj: any, path: string, value: any): void {
-    const parts = path.split('.');
-    let current = obj;
-
-    for (let i = 0; i < parts.length - 1; i++) {
-      const part = parts[i];
-      if (!(part in current)) {
-        current[part] = {};
-      }
-      current = current[part];
-    }
-
-    current[parts[parts.length - 1]] = value;
+  private addFrameListener(frame: number, callback: () => void, owner?: string): number {
+    return this.scheduler.scheduleAtAbsoluteFrame(frame, callback, owner);
   }
 
   // Event system
@@ -427,6 +393,7 @@ export class AnimationEngine {
     this.pause();
     this.currentFrame = 0;
     this.activeSequences.clear();
+    this.scheduler.reset(0);
   }
 
   /**
@@ -442,26 +409,10 @@ export class AnimationEngine {
       newFrame: this.currentFrame
     });
 
-    // Check for frame-specific events
-    this.checkFrameEvents();
+    // Run or re-base frame listeners
+    this.scheduler.seek(this.currentFrame);
   }
 
-  /**
-   * Check if there are any events to trigger at the current frame
-   */
-  private checkFrameEvents(): void {
-    const eventName = `frame_${this.currentFrame}`;
-    if (this.eventListeners.has(eventName)) {
-        const listeners = this.eventListeners.get(eventName);
-        if (listeners) {
-            listeners.forEach(callback => callback());
-            
-            // Clear one-time frame listeners
-            this.eventListeners.set(eventName, []);
-        }
-    }
-}
-
   /**
    * The main animation loop
    */
@@ -487,9 +438,6 @@ export class AnimationEngine {
         oldFrame,
         newFrame: this.currentFrame
       });
-
-      // Check for frame-specific events
-      this.checkFrameEvents();
     }
 
     // Request next frame if still playing
@@ -502,6 +450,9 @@ export class AnimationEngine {
    * Advance the animation by a number of frames
    */
   private advanceFrames(frames: number): void {
+    // Run frame listeners frame by frame, including across the loop point
+    this.scheduler.advance(frames);
+
     this.currentFrame += frames;
 
     // Loop back to beginning if we reach the end
@@ -558,6 +509,8 @@ export class AnimationEngine {
 
       // For each animation on this element
       for (const animation of element.animations) {
+        const property = this.propertyPaths.resolve(animation);
+
         // Find the keyframes that bracket the current time
         let startKeyframe = null;
         let endKeyframe = null;
@@ -594,12 +547,12 @@ export class AnimationEngine {
           if (typeof startValue === 'number' && typeof endValue === 'number') {
             // Numeric values
             const interpolatedValue = startValue + (endValue - startValue) * easedProgress;
-            this.setNestedProperty(animatedElement.properties, animation.property, interpolatedValue);
+            this.propertyPaths.set(animatedElement.properties, property, interpolatedValue);
           } else if (typeof startValue === 'string' && typeof endValue === 'string') {
             // Check for color values
             if (startValue.startsWith('#') && endValue.startsWith('#')) {
               const interpolatedColor = this.interpolateColor(startValue, endValue, easedProgress);
-              this.setNestedProperty(animatedElement.properties, animation.property, interpolatedColor);
+              this.propertyPaths.set(animatedElement.properties, property, interpolatedColor);
             }
             // Add more string interpolation types here as needed
           } else if (
@@ -615,7 +568,7 @@ export class AnimationEngine {
               }
               return end; // Fallback for non-numeric array values
             });
-            this.setNestedProperty(animatedElement.properties, animation.property, interpolatedArray);
+            this.propertyPaths.set(animatedElement.properties, property, interpolatedArray);
           }
           // Add more value type handlers as needed
         }
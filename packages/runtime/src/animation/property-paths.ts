@@ -0,0 +1,106 @@
+// Compiled Property Paths
+
+import { Timeline, Element, PropertyAnimation } from '@flare/shared';
+
+/**
+ * A dotted property path, split once
+ */
+export interface CompiledProperty {
+  path: string;                 // Original dotted path
+  parents: string[];            // Intermediate keys of a nested path
+  key: string;                  // Final key that holds the value
+}
+
+// Where an animation keeps its compiled property. JSON skips symbol keys,
+// so animations still clone and serialize as before.
+const COMPILED = Symbol('compiledProperty');
+
+/**
+ * Splits PropertyAnimation.property strings once, at load, so the frame
+ * loop reads and writes values without splitting or re-parsing paths
+ */
+export class PropertyPathTable {
+  private byPath: Map<string, CompiledProperty> = new Map();
+
+  /**
+   * Compile every animated property in a timeline
+   */
+  public compileTimeline(timeline: Timeline): void {
+    const visit = (element: Element) => {
+      if (element.animations) {
+        for (const animation of element.animations) {
+          this.resolve(animation);
+        }
+      }
+      if (element.children) {
+        element.children.forEach(visit);
+      }
+    };
+
+    for (const layer of timeline.layers) {
+      for (const frame of layer.frames) {
+        frame.elements.forEach(visit);
+      }
+    }
+  }
+
+  /**
+   * Compile a property path; repeated paths share one entry
+   */
+  public compile(path: string): CompiledProperty {
+    let compiled = this.byPath.get(path);
+    if (compiled) return compiled;
+
+    const parts = path.split('.');
+    compiled = { path, parents: parts.slice(0, -1), key: parts[parts.length - 1] };
+    this.byPath.set(path, compiled);
+    return compiled;
+  }
+
+  /**
+   * Get the compiled property for an animation, compiling it on first use
+   * (animations created at runtime, e.g. by groups, land here). It's kept
+   * on the animation, so later frames only compare the path.
+   */
+  public resolve(animation: PropertyAnimation): CompiledProperty {
+    const cached = (animation as any)[COMPILED] as CompiledProperty | undefined;
+    if (cached && cached.path === animation.property) return cached;
+
+    const compiled = this.compile(animation.property);
+    (animation as any)[COMPILED] = compiled;
+    return compiled;
+  }
+
+  /**
+   * Read a compiled property from an element's properties
+   */
+  public get(properties: any, property: CompiledProperty): any {
+    let current = properties;
+
+    for (const part of property.parents) {
+      if (current === null || current === undefined || !(part in current)) {
+        return undefined;
+      }
+      current = current[part];
+    }
+
+    if (current === null || current === undefined) return undefined;
+    return current[property.key];
+  }
+
+  /**
+   * Write a compiled property into an element's properties
+   */
+  public set(properties: any, property: CompiledProperty, value: any): void {
+    let current = properties;
+
+    for (const part of property.parents) {
+      if (!(part in current)) {
+        current[part] = {};
+      }
+      current = current[part];
+    }
+
+    current[property.key] = value;
+  }
+}
@@ -0,0 +1,411 @@
+// Frame Scheduler
+
+/**
+ * Callback run when a scheduled task expires
+ */
+export type ScheduledCallback = () => void;
+
+/**
+ * A task waiting in the wheel
+ */
+interface WheelTask {
+  id: number;
+  due: number;              // Absolute tick the task expires on
+  seq: number;              // Insertion order, so same-tick tasks run FIFO
+  frame: number;            // Timeline frame the task was scheduled for
+  owner?: string;
+  callback: ScheduledCallback;
+  cancelled: boolean;
+}
+
+/**
+ * Pending scheduler state captured for a checkpoint
+ */
+export interface SchedulerSnapshot {
+  currentFrame: number;
+  tasks: {
+    remaining: number;        // Ticks until the task expires
+    frame: number;
+    owner?: string;
+    callback: ScheduledCallback;
+  }[];
+}
+
+const WHEEL_BITS = 6;
+const WHEEL_SLOTS = 1 << WHEEL_BITS;
+const WHEEL_MASK = WHEEL_SLOTS - 1;
+const WHEEL_LEVELS = 4;
+const WHEEL_SPAN = Math.pow(WHEEL_SLOTS, WHEEL_LEVELS);
+
+/**
+ * Hierarchical timing wheel over integer ticks.
+ *
+ * Each level has 64 slots; level n covers delays up to 64^(n+1) ticks.
+ * Inserting is O(1), and a task is moved down at most once per level before
+ * it expires. Tasks beyond the top level wait in an overflow list that is
+ * re-examined each time the top level wraps.
+ */
+export class TimingWheel {
+  private levels: WheelTask[][][] = [];
+  private overflow: WheelTask[] = [];
+  private tasks: Map<number, WheelTask> = new Map();
+  private owners: Map<string, Set<number>> = new Map();
+  private now: number = 0;
+  private nextId: number = 1;
+  private nextSeq: number = 0;
+
+  constructor() {
+    for (let level = 0; level < WHEEL_LEVELS; level++) {
+      const slots: WheelTask[][] = [];
+      for (let slot = 0; slot < WHEEL_SLOTS; slot++) {
+        slots.push([]);
+      }
+      this.levels.push(slots);
+    }
+  }
+
+  /**
+   * Schedule a callback `delay` ticks from now (at least one tick)
+   */
+  public schedule(delay: number, callback: ScheduledCallback, owner?: string, frame: number = -1): number {
+    const task: WheelTask = {
+      id: this.nextId++,
+      due: this.now + Math.max(1, Math.floor(delay)),
+      seq: this.nextSeq++,
+      frame,
+      owner,
+      callback,
+      cancelled: false
+    };
+
+    this.tasks.set(task.id, task);
+    if (owner !== undefined) {
+      let ids = this.owners.get(owner);
+      if (!ids) {
+        ids = new Set();
+        this.owners.set(owner, ids);
+      }
+      ids.add(task.id);
+    }
+
+    this.place(task);
+    return task.id;
+  }
+
+  /**
+   * Cancel a task. The slot entry is skipped lazily when it comes up.
+   */
+  public cancel(id: number): boolean {
+    const task = this.tasks.get(id);
+    if (!task) return false;
+
+    task.cancelled = true;
+    this.forget(task);
+    return true;
+  }
+
+  /**
+   * Cancel every task scheduled under an owner
+   */
+  public cancelOwner(owner: string): number {
+    const ids = this.owners.get(owner);
+    if (!ids) return 0;
+
+    let count = 0;
+    for (const id of Array.from(ids)) {
+      if (this.cancel(id)) count++;
+    }
+    this.owners.delete(owner);
+    return count;
+  }
+
+  /**
+   * Advance one tick and return the tasks that expired, in insertion order.
+   * Expired tasks are removed before being returned.
+   */
+  public tick(): WheelTask[] {
+    this.now++;
+
+    // Cascade higher levels down when the level below wraps
+    let level = 1;
+    while (level < WHEEL_LEVELS && (this.now & ((1 << (WHEEL_BITS * level)) - 1)) === 0) {
+      this.cascade(level, (this.now >> (WHEEL_BITS * level)) & WHEEL_MASK);
+      level++;
+    }
+    if (level === WHEEL_LEVELS && this.overflow.length > 0 && this.now % WHEEL_SPAN === 0) {
+      const overflow = this.overflow;
+      this.overflow = [];
+      overflow.forEach(task => this.place(task));
+    }
+
+    const slot = this.levels[0][this.now & WHEEL_MASK];
+    if (slot.length === 0) return [];
+
+    this.levels[0][this.now & WHEEL_MASK] = [];
+    const expired = slot.filter(task => !task.cancelled);
+    if (expired.length > 1) {
+      expired.sort((a, b) => a.seq - b.seq);
+    }
+    expired.forEach(task => this.forget(task));
+    return expired;
+  }
+
+  /**
+   * Remove and return every pending task along with its remaining delay
+   */
+  public drain(): { task: WheelTask, remaining: number }[] {
+    const pending = this.pending();
+    this.clear();
+    return pending;
+  }
+
+  /**
+   * Every pending task along with its remaining delay, in expiry order
+   */
+  public pending(): { task: WheelTask, remaining: number }[] {
+    return Array.from(this.tasks.values())
+      .sort((a, b) => a.due - b.due || a.seq - b.seq)
+      .map(task => ({ task, remaining: task.due - this.now }));
+  }
+
+  /**
+   * Drop every pending task
+   */
+  public clear(): void {
+    this.levels.forEach(slots => {
+      for (let slot = 0; slot < WHEEL_SLOTS; slot++) {
+        slots[slot] = [];
+      }
+    });
+    this.overflow = [];
+    this.tasks.clear();
+    this.owners.clear();
+  }
+
+  /**
+   * Number of pending tasks
+   */
+  public get size(): number {
+    return this.tasks.size;
+  }
+
+  /**
+   * Put a task in the slot matching its distance from now
+   */
+  private place(task: WheelTask): void {
+    const distance = task.due - this.now;
+
+    for (let level = 0; level < WHEEL_LEVELS; level++) {
+      if (distance < Math.pow(WHEEL_SLOTS, level + 1)) {
+        const slot = Math.floor(task.due / Math.pow(WHEEL_SLOTS, level)) & WHEEL_MASK;
+        this.levels[level][slot].push(task);
+        return;
+      }
+    }
+
+    this.overflow.push(task);
+  }
+
+  /**
+   * Re-place the tasks in a slot of a higher level
+   */
+  private cascade(level: number, slot: number): void {
+    const tasks = this.levels[level][slot];
+    if (tasks.length === 0) return;
+
+    this.levels[level][slot] = [];
+    tasks.forEach(task => {
+      if (!task.cancelled) this.place(task);
+    });
+  }
+
+  /**
+   * Drop bookkeeping for a task that expired or was cancelled
+   */
+  private forget(task: WheelTask): void {
+    this.tasks.delete(task.id);
+    if (task.owner !== undefined) {
+      const ids = this.owners.get(task.owner);
+      if (ids) {
+        ids.delete(task.id);
+        if (ids.size === 0) this.owners.delete(task.owner);
+      }
+    }
+  }
+}
+
+/**
+ * Schedules continuations against a looping timeline.
+ *
+ * Tasks are keyed on timeline frame numbers. Playback advances the wheel one
+ * tick per frame, so a task for a frame behind the playhead runs after the
+ * timeline loops. Seeking forward runs everything passed over; seeking
+ * backward re-bases the pending tasks and runs only those on the target frame.
+ */
+export class FrameScheduler {
+  private wheel: TimingWheel = new TimingWheel();
+  private duration: number;
+  private currentFrame: number = 0;
+
+  constructor(duration: number) {
+    this.duration = Math.max(1, Math.floor(duration));
+  }
+
+  /**
+   * Run a callback the next time playback reaches `frame`.
+   * `loops` adds whole timeline loops before it runs.
+   */
+  public scheduleAtFrame(frame: number, callback: ScheduledCallback, owner?: string, loops: number = 0): number {
+    const target = this.wrap(frame);
+    const delay = this.distanceTo(target) + Math.max(0, loops) * this.duration;
+    return this.wheel.schedule(delay, callback, owner, target);
+  }
+
+  /**
+   * Run a callback when playback reaches `frame`, counted from the start of
+   * the current loop, so frames past the end of the timeline run that many
+   * loops later. A frame the playhead has already passed in this loop runs
+   * on its next visit, as with scheduleAtFrame.
+   */
+  public scheduleAtAbsoluteFrame(frame: number, callback: ScheduledCallback, owner?: string): number {
+    const target = this.wrap(frame);
+    const nextVisit = this.currentFrame + this.distanceTo(target);
+    const loops = Math.max(0, Math.round((Math.floor(frame) - nextVisit) / this.duration));
+    return this.scheduleAtFrame(target, callback, owner, loops);
+  }
+
+  /**
+   * Run a callback after `frames` frames of playback (at least one)
+   */
+  public scheduleAfter(frames: number, callback: ScheduledCallback, owner?: string): number {
+    const delay = Math.max(1, Math.floor(frames));
+    return this.wheel.schedule(delay, callback, owner, this.wrap(this.currentFrame + delay));
+  }
+
+  /**
+   * Cancel a single task
+   */
+  public cancel(id: number): boolean {
+    return this.wheel.cancel(id);
+  }
+
+  /**
+   * Cancel every task scheduled under an owner
+   */
+  public cancelOwner(owner: string): number {
+    return this.wheel.cancelOwner(owner);
+  }
+
+  /**
+   * Advance playback by a number of frames, running tasks as they expire
+   */
+  public advance(frames: number): void {
+    for (let i = 0; i < frames; i++) {
+      this.currentFrame = this.wrap(this.currentFrame + 1);
+      const expired = this.wheel.tick();
+      expired.forEach(task => this.run(task.callback));
+    }
+  }
+
+  /**
+   * Move the playhead to a frame
+   */
+  public seek(frame: number): void {
+    const target = this.wrap(frame);
+    if (target === this.currentFrame) return;
+
+    if (target > this.currentFrame) {
+      this.advance(target - this.currentFrame);
+      return;
+    }
+
+    // Backward: nothing in between is replayed, but every pending task keeps
+    // its timeline frame and the number of extra loops it was waiting for
+    const from = this.currentFrame;
+    const pending = this.wheel.drain();
+    this.currentFrame = target;
+
+    const landed: ScheduledCallback[] = [];
+    pending.forEach(({ task, remaining }) => {
+      const firstVisit = this.distanceFrom(from, task.frame);
+      const extraLoops = Math.max(0, Math.round((remaining - firstVisit) / this.duration));
+
+      if (task.frame === target && extraLoops === 0) {
+        landed.push(task.callback);
+        return;
+      }
+
+      const delay = this.distanceTo(task.frame) + extraLoops * this.duration;
+      this.wheel.schedule(delay, task.callback, task.owner, task.frame);
+    });
+
+    landed.forEach(callback => this.run(callback));
+  }
+
+  /**
+   * Drop every pending task and move the playhead to a frame
+   */
+  public reset(frame: number = 0): void {
+    this.wheel.clear();
+    this.currentFrame = this.wrap(frame);
+  }
+
+  /**
+   * Capture the playhead and pending tasks. Callbacks are shared, not copied.
+   */
+  public snapshot(): SchedulerSnapshot {
+    return {
+      currentFrame: this.currentFrame,
+      tasks: this.wheel.pending().map(({ task, remaining }) => ({
+        remaining,
+        frame: task.frame,
+        owner: task.owner,
+        callback: task.callback
+      }))
+    };
+  }
+
+  /**
+   * Replace the pending tasks with a snapshot's. Tasks get new IDs but keep
+   * their expiry order.
+   */
+  public restore(snapshot: SchedulerSnapshot): void {
+    this.wheel.clear();
+    this.currentFrame = snapshot.currentFrame;
+
+    snapshot.tasks.forEach(task => {
+      this.wheel.schedule(task.remaining, task.callback, task.owner, task.frame);
+    });
+  }
+
+  /**
+   * Number of pending tasks
+   */
+  public get pendingCount(): number {
+    return this.wheel.size;
+  }
+
+  /**
+   * Frames from the playhead until `frame` next comes around (1..duration)
+   */
+  private distanceTo(frame: number): number {
+    return this.distanceFrom(this.currentFrame, frame);
+  }
+
+  private distanceFrom(from: number, frame: number): number {
+    const distance = (frame - from + this.duration) % this.duration;
+    return distance === 0 ? this.duration : distance;
+  }
+
+  private wrap(frame: number): number {
+    return ((Math.floor(frame) % this.duration) + this.duration) % this.duration;
+  }
+
+  private run(callback: ScheduledCallback): void {
+    try {
+      callback();
+    } catch (error) {
+      console.error('Error in scheduled callback:', error);
+    }
+  }
+}
@@ -0,0 +1,165 @@
+import { Element, ElementType, Timeline } from '@flare/shared';
+import { WasmRenderer, PackageArchive, AssetState, AssetSchedulerStats } from './wasm-bindings';
+
+/**
+ * Options for an asset prefetcher
+ */
+export interface AssetPrefetchOptions {
+  horizonSeconds?: number;    // How far ahead of the playhead to start loading
+  maxInFlight?: number;       // Loads running at once
+}
+
+/**
+ * Image entries of a package shown in each frame span of a timeline.
+ * Returns the asset names and, per asset, its [start, end) spans.
+ */
+export function collectAssetUses(timeline: Timeline, archive: PackageArchive): {
+  names: string[];
+  uses: [number, number][][];
+} {
+  const names: string[] = [];
+  const uses: [number, number][][] = [];
+  const indices = new Map<string, number>();
+
+  const visit = (element: Element, start: number, end: number) => {
+    const src = element.properties ? element.properties.src : undefined;
+    if (element.type === ElementType.IMAGE && typeof src === 'string' && archive.has(src)) {
+      let index = indices.get(src);
+      if (index === undefined) {
+        index = names.length;
+        indices.set(src, index);
+        names.push(src);
+        uses.push([]);
+      }
+      uses[index].push([start, end]);
+    }
+    if (element.children) {
+      for (const child of element.children) visit(child, start, end);
+    }
+  };
+
+  for (const layer of timeline.layers) {
+    for (const frame of layer.frames) {
+      const end = frame.startFrame + Math.max(1, frame.duration);
+      for (const element of frame.elements) visit(element, frame.startFrame, end);
+    }
+  }
+
+  return { names, uses };
+}
+
+/**
+ * Fetches and decodes a package's images ahead of the playhead.
+ *
+ * The native asset scheduler knows every frame span each image is shown in
+ * and hands out the pending ones in order of their next use. Each tick the
+ * prefetcher starts loads for whatever is due within the horizon, up to a
+ * fixed number in flight, so decoding happens before the frame that needs
+ * it rather than during it. Images that reach the screen before they're
+ * decoded are counted as deadline misses.
+ */
+export class AssetPrefetcher {
+  private wasm: WasmRenderer;
+  private archive: PackageArchive;
+  private scheduler: number;
+  private names: string[];
+  private images: Map<string, ImageBitmap> = new Map();
+  private horizon: number;
+  private maxInFlight: number;
+  private inFlight: number = 0;
+  private destroyed: boolean = false;
+
+  constructor(wasm: WasmRenderer, archive: PackageArchive, timeline: Timeline, options: AssetPrefetchOptions = {}) {
+    this.wasm = wasm;
+    this.archive = archive;
+    this.horizon = Math.ceil((options.horizonSeconds ?? 2) * timeline.frameRate);
+    this.maxInFlight = options.maxInFlight ?? 4;
+
+    const { names, uses } = collectAssetUses(timeline, archive);
+    this.names = names;
+    this.scheduler = names.length > 0 ? wasm.createAssetScheduler(timeline.duration, timeline.loop !== false, uses) : 0;
+  }
+
+  /**
+   * Record the playhead and start loads for assets coming due
+   */
+  public update(frame: number): void {
+    if (this.scheduler === 0) return;
+
+    const misses = this.wasm.advanceAssetScheduler(this.scheduler, frame);
+    if (misses > 0) {
+      console.warn(`${misses} asset(s) reached the screen before they were decoded`);
+    }
+
+    const free = this.maxInFlight - this.inFlight;
+    if (free <= 0) return;
+    for (const asset of this.wasm.nextScheduledAssets(this.scheduler, frame, this.horizon, free)) {
+      this.load(asset);
+    }
+  }
+
+  /**
+   * A decoded image, or null if it isn't ready yet
+   */
+  public get(name: string): ImageBitmap | null {
+    return this.images.get(name) || null;
+  }
+
+  /**
+   * Load counters and deadline misses so far
+   */
+  public getStats(): AssetSchedulerStats {
+    if (this.scheduler === 0) {
+      return { pending: 0, loading: 0, ready: 0, failed: 0, misses: 0, lateFrames: 0 };
+    }
+    return this.wasm.getAssetSchedulerStats(this.scheduler);
+  }
+
+  /**
+   * Release the scheduler and every decoded image
+   */
+  public destroy(): void {
+    this.destroyed = true;
+    if (this.scheduler !== 0) {
+      this.wasm.destroyAssetScheduler(this.scheduler);
+      this.scheduler = 0;
+    }
+    this.images.forEach(image => image.close());
+    this.images.clear();
+  }
+
+  /**
+   * Fetch an asset out of the package and decode it. createImageBitmap
+   * decodes off the main thread, so the render loop never waits on it.
+   */
+  private load(asset: number): void {
+    const name = this.names[asset];
+    this.wasm.setAssetState(this.scheduler, asset, AssetState.LOADING);
+    this.inFlight++;
+
+    this.archive.load(name)
+      .then(entry => {
+        const data = this.wasm.getPackageEntryData(entry);
+        if (!data) throw new Error(`Failed to read ${name} from package`);
+        // The view is only valid until the heap grows, so copy it out now
+        return createImageBitmap(new Blob([data.slice()]));
+      })
+      .then(
+        image => {
+          if (this.destroyed) {
+            image.close();
+            return;
+          }
+          this.images.set(name, image);
+          this.wasm.setAssetState(this.scheduler, asset, AssetState.READY);
+        },
+        error => {
+          console.error(`Failed to load asset ${name}:`, error);
+          if (!this.destroyed) this.wasm.setAssetState(this.scheduler, asset, AssetState.FAILED);
+        }
+      )
+      .then(() => {
+        this.inFlight--;
+      });
+  }
+}
@@ -0,0 +1,153 @@
+// Color Matrix Filters
+
+/**
+ * A 4x5 color matrix, row-major, as SVG's feColorMatrix takes it: each
+ * row maps straight-alpha RGBA in 0-1 to one output channel, with the
+ * offset last
+ */
+export type ColorMatrix = number[];
+
+/**
+ * Color filters an element can list in its `filters` property. Amounts
+ * follow the CSS filter functions: 1 is the full effect, or no change for
+ * brightness and saturate.
+ */
+export type ColorFilter =
+  | { type: 'brightness'; amount: number }
+  | { type: 'saturate'; amount: number }
+  | { type: 'grayscale'; amount: number }
+  | { type: 'hueRotate'; angle: number }                 // Degrees
+  | { type: 'tint'; color: string; amount: number }      // Color as #rgb or #rrggbb
+  | { type: 'matrix'; values: ColorMatrix };
+
+export const IDENTITY_MATRIX: ColorMatrix = [
+  1, 0, 0, 0, 0,
+  0, 1, 0, 0, 0,
+  0, 0, 1, 0, 0,
+  0, 0, 0, 1, 0,
+];
+
+// Luminance weights, as the CSS filter functions use them
+const LUMA_R = 0.2126;
+const LUMA_G = 0.7152;
+const LUMA_B = 0.0722;
+
+/**
+ * Matrix with the given 3x3 color part, leaving alpha alone
+ */
+function colorMatrix(rgb: number[]): ColorMatrix {
+  return [
+    rgb[0], rgb[1], rgb[2], 0, 0,
+    rgb[3], rgb[4], rgb[5], 0, 0,
+    rgb[6], rgb[7], rgb[8], 0, 0,
+    0, 0, 0, 1, 0,
+  ];
+}
+
+/**
+ * Parse #rgb or #rrggbb into channels in 0-1; anything else is black
+ */
+function parseHexColor(color: string): [number, number, number] {
+  let hex = typeof color === 'string' && color.startsWith('#') ? color.slice(1) : '';
+  if (hex.length === 3) hex = hex.split('').map((c) => c + c).join('');
+  if (hex.length !== 6 || !/^[0-9a-fA-F]{6}$/.test(hex)) return [0, 0, 0];
+
+  return [0, 2, 4].map((i) => parseInt(hex.slice(i, i + 2), 16) / 255) as [number, number, number];
+}
+
+/**
+ * The matrix a single filter applies; the identity for unknown ones
+ */
+export function filterMatrix(filter: ColorFilter): ColorMatrix {
+  switch (filter.type) {
+    case 'brightness': {
+      const b = Math.max(0, filter.amount);
+      return colorMatrix([b, 0, 0, 0, b, 0, 0, 0, b]);
+    }
+
+    case 'saturate': {
+      const s = Math.max(0, filter.amount);
+      return colorMatrix([
+        LUMA_R + (1 - LUMA_R) * s, LUMA_G - LUMA_G * s, LUMA_B - LUMA_B * s,
+        LUMA_R - LUMA_R * s, LUMA_G + (1 - LUMA_G) * s, LUMA_B - LUMA_B * s,
+        LUMA_R - LUMA_R * s, LUMA_G - LUMA_G * s, LUMA_B + (1 - LUMA_B) * s,
+      ]);
+    }
+
+    case 'grayscale':
+      // Grayscale is desaturation, capped at fully gray
+      return filterMatrix({ type: 'saturate', amount: 1 - Math.min(1, Math.max(0, filter.amount)) });
+
+    case 'hueRotate': {
+      const radians = filter.angle * Math.PI / 180;
+      const c = Math.cos(radians);
+      const s = Math.sin(radians);
+      return colorMatrix([
+        0.213 + c * 0.787 - s * 0.213, 0.715 - c * 0.715 - s * 0.715, 0.072 - c * 0.072 + s * 0.928,
+        0.213 - c * 0.213 + s * 0.143, 0.715 + c * 0.285 + s * 0.140, 0.072 - c * 0.072 - s * 0.283,
+        0.213 - c * 0.213 - s * 0.787, 0.715 - c * 0.715 + s * 0.715, 0.072 + c * 0.928 + s * 0.072,
+      ]);
+    }
+
+    case 'tint': {
+      // Each channel moves toward the tint color scaled by the pixel's luminance
+      const [r, g, b] = parseHexColor(filter.color);
+      const tint = colorMatrix([
+        r * LUMA_R, r * LUMA_G, r * LUMA_B,
+        g * LUMA_R, g * LUMA_G, g * LUMA_B,
+        b * LUMA_R, b * LUMA_G, b * LUMA_B,
+      ]);
+      return mixColorMatrix(tint, Math.min(1, Math.max(0, filter.amount)));
+    }
+
+    case 'matrix':
+      return Array.isArray(filter.values) && filter.values.length === 20 ? filter.values.slice() : IDENTITY_MATRIX.slice();
+
+    default:
+      // Timelines are untyped JSON; filters this doesn't know change nothing
+      return IDENTITY_MATRIX.slice();
+  }
+}
+
+/**
+ * `first` followed by `then`, as one matrix
+ */
+export function concatColorMatrices(first: ColorMatrix, then: ColorMatrix): ColorMatrix {
+  const result = new Array<number>(20);
+
+  for (let row = 0; row < 4; row++) {
+    for (let column = 0; column < 5; column++) {
+      let sum = column === 4 ? then[row * 5 + 4] : 0;
+      for (let k = 0; k < 4; k++) {
+        sum += then[row * 5 + k] * first[k * 5 + column];
+      }
+      result[row * 5 + column] = sum;
+    }
+  }
+  return result;
+}
+
+/**
+ * Compose a chain of filters, applied in order, into one matrix. Colors
+ * are clamped only once, after the whole chain. Returns null when the
+ * chain changes nothing, so the element needn't be filtered at all.
+ */
+export function composeColorFilters(filters: ColorFilter[]): ColorMatrix | null {
+  let matrix = IDENTITY_MATRIX;
+  for (const filter of filters) {
+    matrix = concatColorMatrices(matrix, filterMatrix(filter));
+  }
+  return isIdentity(matrix) ? null : matrix;
+}
+
+/**
+ * The matrix `amount` of the way from the identity to `matrix`, for fading
+ * a filter in and out
+ */
+export function mixColorMatrix(matrix: ColorMatrix, amount: number): ColorMatrix {
+  return matrix.map((value, i) => IDENTITY_MATRIX[i] + (value - IDENTITY_MATRIX[i]) * amount);
+}
+
+export function isIdentity(matrix: ColorMatrix): boolean {
+  return matrix.every((value, i) => Math.abs(value - IDENTITY_MATRIX[i]) < 1e-6);
+}
@@ -3,6 +3,8 @@ import { FlarePlayer, FlarePlayerOptions } from './player';
 // Export main classes
 export { FlarePlayer };
 export type { FlarePlayerOptions };
+export type { PackageArchive, PackageEntryInfo, AssetSchedulerStats } from './wasm-bindings';
+export type { ColorFilter, ColorMatrix } from './color-matrix';
 
 // Create namespace for UMD build
 declare global {
@@ -2,6 +2,17 @@ import { ElementType, Timeline } from '@flare/shared';
 import { FlareParser } from '@flare/file-format';
 import { FlareRenderer } from './renderer';
 import { AnimationEngine } from './animation/animation-engine';
+import { EventTriggerType, ElementInteraction } from './animation/events';
+import { WasmRenderer, PackageArchive, AssetSchedulerStats, InteractionType, decodeHeapText } from './wasm-bindings';
+import { AssetPrefetcher } from './asset-prefetcher';
+
+// Trigger types for the pointer interactions in InteractionType order
+const INTERACTION_TRIGGERS: ElementInteraction['type'][] = [
+  EventTriggerType.CLICK,
+  EventTriggerType.HOVER,
+  EventTriggerType.DRAG_START,
+  EventTriggerType.DRAG_END
+];
 
 export interface FlarePlayerOptions {
   container: HTMLElement | string;
@@ -18,6 +29,8 @@ export class FlarePlayer {
   private renderer: FlareRenderer | null = null;
   private animationEngine: AnimationEngine | null = null;
   private timeline: Timeline | null = null;
+  private package: PackageArchive | null = null;
+  private prefetcher: AssetPrefetcher | null = null;
   private container: HTMLElement;
   private width: number;
   private height: number;
@@ -95,7 +108,16 @@ export class FlarePlayer {
       // Create animation engine
       if (this.timeline) {
         this.animationEngine = new AnimationEngine(this.timeline);
+
+        // Start on the first frame's images before playback begins
+        if (this.package) {
+          this.prefetcher = new AssetPrefetcher(WasmRenderer.getInstance(), this.package, this.timeline);
+          this.prefetcher.update(0);
+        }
         
+        // Route canvas input to interaction triggers
+        this.renderer.attachInput();
+
         // Set up animation frame loop
         this.startRenderLoop();
         
@@ -128,6 +150,22 @@ export class FlarePlayer {
   private async loadSource(source: string): Promise<void> {
     try {
       console.log('Loading source:', source);
+
+      // Packages are opened for random access: only the timeline is fetched
+      // now, assets are fetched when first loaded
+      if (source.endsWith('.flare')) {
+        const wasm = WasmRenderer.getInstance();
+        this.package = await wasm.openPackage(source);
+
+        const entry = await this.package.load('timeline.json');
+        const data = wasm.getPackageEntryData(entry);
+        if (!data) {
+          throw new Error('Failed to read timeline.json from package');
+        }
+        this.timeline = FlareParser.parseJSON(decodeHeapText(data));
+        return;
+      }
+
       const response = await fetch(source);
       if (!response.ok) {
         throw new Error(`Failed to load source: ${response.statusText}`);
@@ -163,18 +201,78 @@ export class FlarePlayer {
     }
   }
 
+  /**
+   * The package the player was loaded from, for loading assets on demand
+   */
+  public getPackage(): PackageArchive | null {
+    return this.package;
+  }
+
+  /**
+   * A decoded image from the package, or null if it isn't ready yet
+   */
+  public getAsset(name: string): ImageBitmap | null {
+    return this.prefetcher ? this.prefetcher.get(name) : null;
+  }
+
+  /**
+   * Asset load counters and deadline misses, or null without a package
+   */
+  public getAssetStats(): AssetSchedulerStats | null {
+    return this.prefetcher ? this.prefetcher.getStats() : null;
+  }
+
+  /**
+   * Fire the triggers for the input that arrived since the last frame. Key
+   * events become "keydown"/"keyup" custom events carrying the key code.
+   */
+  private dispatchInput(): void {
+    if (!this.renderer || !this.animationEngine) return;
+
+    const engine = this.animationEngine;
+    let batch: ElementInteraction[] = [];
+    for (const interaction of this.renderer.drainInput()) {
+      if (interaction.type === InteractionType.KEY_DOWN || interaction.type === InteractionType.KEY_UP) {
+        // Keep key and pointer triggers in the order they happened
+        engine.handleElementInteractions(batch);
+        batch = [];
+        engine.triggerCustomEvent(interaction.type === InteractionType.KEY_DOWN ? 'keydown' : 'keyup', {
+          keyCode: interaction.detail
+        });
+        continue;
+      }
+
+      const elementId = this.renderer.getElementId(interaction.tag);
+      if (!elementId) continue;
+      batch.push({
+        type: INTERACTION_TRIGGERS[interaction.type],
+        elementId,
+        eventData: { x: interaction.x, y: interaction.y, buttons: interaction.detail }
+      });
+    }
+    engine.handleElementInteractions(batch);
+  }
+
   /**
    * Start the render loop
    */
   private startRenderLoop(): void {
     const renderFrame = () => {
       if (!this.renderer || !this.animationEngine) return;
+
+      // Input is applied once per frame, in a batch
+      this.dispatchInput();
+
+      // Keep asset loads ahead of the playhead
+      if (this.prefetcher) {
+        this.prefetcher.update(this.animationEngine.getCurrentFrame());
+      }
       
-      // Get current elements from the animation engine
-      const elements = this.animationEngine.getCurrentElements();
+      // Get the current layers from the animation engine
+      const layers = this.animationEngine.getCurrentLayers();
       
-      // Render them
-      this.renderer.render(elements);
+      // Render them, masks included
+      this.renderer.renderLayers(layers);
       
       // Request next frame
       requestAnimationFrame(renderFrame);
@@ -238,6 +336,11 @@ export class FlarePlayer {
     if (this.animationEngine) {
       this.animationEngine.stop();
     }
+
+    if (this.prefetcher) {
+      this.prefetcher.destroy();
+      this.prefetcher = null;
+    }
     
     if (this.renderer) {
       this.renderer.destroy();
@@ -1,11 +1,28 @@
-import { Element, ElementType } from '@flare/shared';
-import { WasmRenderer } from './wasm-bindings';
+import { Element, ElementType, LayerType } from '@flare/shared';
+import { WasmRenderer, InputEventType, Interaction, MaskMode, BlendMode } from './wasm-bindings';
+import { LayerElements } from './animation/animation-engine';
+import { ColorFilter, ColorMatrix, composeColorFilters, mixColorMatrix } from './color-matrix';
+
+// Element blendMode values and the modes they composite with
+const BLEND_MODES = new Map<string, BlendMode>([
+  ['normal', BlendMode.NORMAL],
+  ['multiply', BlendMode.MULTIPLY],
+  ['screen', BlendMode.SCREEN],
+  ['overlay', BlendMode.OVERLAY],
+  ['add', BlendMode.ADD],
+]);
 
 export class FlareRenderer {
   private canvas: HTMLCanvasElement;
   private wasmRenderer: WasmRenderer;
   private canvasId: number;
   private static canvasCounter: number = 0;
+  private elementTags: Map<string, number> = new Map();
+  private taggedElements: string[] = [];
+  private detachInput: (() => void) | null = null;
+  // Composed matrix of each element's filters, by element id. Elements are
+  // cloned every frame, so the list is matched by its contents.
+  private colorMatrices: Map<string, { key: string; matrix: ColorMatrix | null }> = new Map();
 
   constructor(container: HTMLElement | string, width: number, height: number) {
     // Get or create container element
@@ -70,15 +87,78 @@ export class FlareRenderer {
       console.log('Rendering element:', element.type, element.properties);
       this.renderElement(element);
     }
+
+    // Hand the recorded frame to the native pipeline
+    this.wasmRenderer.endFrame();
+  }
+
+  /**
+   * Render a frame layer by layer. Mask and clip layers aren't drawn
+   * themselves; the layers they apply to are drawn through them.
+   */
+  public renderLayers(layers: LayerElements[]): void {
+    this.wasmRenderer.clear();
+
+    let mask = -1;
+    for (const layer of layers) {
+      if (layer.type === LayerType.MASK || layer.type === LayerType.CLIP) continue;
+
+      // Consecutive layers with the same mask share it
+      if (layer.mask !== mask) {
+        if (mask >= 0) this.wasmRenderer.endMask();
+        mask = layer.mask;
+        if (mask >= 0) this.beginMask(layers[mask]);
+      }
+
+      for (const element of layer.elements) {
+        this.renderElement(element);
+      }
+    }
+    if (mask >= 0) this.wasmRenderer.endMask();
+
+    // Hand the recorded frame to the native pipeline
+    this.wasmRenderer.endFrame();
+  }
+
+  /**
+   * Draw a mask or clip layer's shapes as the mask for what follows
+   */
+  private beginMask(layer: LayerElements): void {
+    this.wasmRenderer.beginMask(layer.type === LayerType.CLIP ? MaskMode.CLIP : MaskMode.ALPHA);
+    for (const element of layer.elements) {
+      this.renderElement(element, false);
+    }
+    this.wasmRenderer.beginMasked();
   }
 
   /**
-   * Render a single element
+   * Render a single element. Mask shapes aren't tagged, since they can't
+   * be clicked themselves. An element with an opacity below 1, a blend
+   * mode, a blur, a shadow or color filters is drawn, children included,
+   * as one group.
    */
-  private renderElement(element: Element): void {
+  private renderElement(element: Element, tagged: boolean = true): void {
     const props = element.properties;
+    const opacity = typeof props.opacity === 'number' ? props.opacity : 1;
+    const blendMode = BLEND_MODES.get(props.blendMode) ?? BlendMode.NORMAL;
+    const blur = typeof props.blur === 'number' && props.blur > 0 ? props.blur : 0;
+    const shadow = props.shadow;
+    const colorMatrix = this.colorMatrixFor(element.id, props);
+    const grouped = opacity < 1 || blendMode !== BlendMode.NORMAL || blur > 0 || !!shadow || !!colorMatrix;
     
     console.log('Rendering element with WebAssembly:', element.type);
+
+    if (grouped) {
+      this.wasmRenderer.beginGroup(opacity, blendMode);
+      if (blur > 0) this.wasmRenderer.addBlur(blur);
+      if (shadow) {
+        this.wasmRenderer.addShadow(shadow.x || 0, shadow.y || 0, shadow.blur || 0, shadow.color || 'rgba(0,0,0,0.5)');
+      }
+      if (colorMatrix) this.wasmRenderer.addColorMatrix(colorMatrix);
+    }
+
+    // Tag what's drawn so input can be traced back to the element
+    this.wasmRenderer.setDrawTag(tagged ? this.tagFor(element.id) : 0);
     
     switch (element.type) {
       case ElementType.RECTANGLE:
@@ -102,6 +182,10 @@ export class FlareRenderer {
         );
         break;
 
+      case ElementType.GROUP:
+        // Only its children draw
+        break;
+
       // Additional element types would be implemented here
       
       default:
@@ -111,9 +195,107 @@ export class FlareRenderer {
     // Render children if any
     if (element.children && element.children.length > 0) {
       for (const child of element.children) {
-        this.renderElement(child);
+        this.renderElement(child, tagged);
       }
     }
+
+    if (grouped) this.wasmRenderer.endGroup();
+  }
+
+  /**
+   * Color matrix for an element's `filters`, faded by `filterAmount` (0-1,
+   * animatable), or null if it has none. The chain is only composed again
+   * when the element's list changes.
+   */
+  private colorMatrixFor(id: string, props: Record<string, any>): ColorMatrix | null {
+    const filters: ColorFilter[] = props.filters;
+    if (!Array.isArray(filters) || filters.length === 0) return null;
+
+    const key = JSON.stringify(filters);
+    let entry = this.colorMatrices.get(id);
+    if (!entry || entry.key !== key) {
+      entry = { key, matrix: composeColorFilters(filters) };
+      this.colorMatrices.set(id, entry);
+    }
+    const matrix = entry.matrix;
+    if (!matrix || typeof props.filterAmount !== 'number') return matrix;
+
+    const amount = Math.min(1, Math.max(0, props.filterAmount));
+    return amount > 0 ? mixColorMatrix(matrix, amount) : null;
+  }
+
+  /**
+   * Draw tag for an element, assigned the first time it's drawn
+   */
+  private tagFor(elementId: string): number {
+    let tag = this.elementTags.get(elementId);
+    if (tag === undefined) {
+      this.taggedElements.push(elementId);
+      tag = this.taggedElements.length;
+      this.elementTags.set(elementId, tag);
+    }
+    return tag;
+  }
+
+  /**
+   * The element a draw tag from an interaction belongs to
+   */
+  public getElementId(tag: number): string | null {
+    return tag > 0 ? this.taggedElements[tag - 1] || null : null;
+  }
+
+  /**
+   * Queue pointer and keyboard events on the canvas into the native input
+   * ring. Listeners only write to the ring; drainInput picks the events up
+   * once per frame.
+   */
+  public attachInput(): void {
+    if (this.detachInput) return;
+
+    const canvas = this.canvas;
+    const wasm = this.wasmRenderer;
+    // Events are in CSS pixels, draw lists in canvas pixels
+    const push = (type: InputEventType, event: PointerEvent) => {
+      wasm.pushInput(
+        type,
+        event.offsetX * (canvas.width / (canvas.clientWidth || canvas.width)),
+        event.offsetY * (canvas.height / (canvas.clientHeight || canvas.height)),
+        event.buttons
+      );
+    };
+
+    const listeners: [string, (event: any) => void][] = [
+      ['pointerdown', (event: PointerEvent) => {
+        // Keep receiving moves while dragging outside the canvas
+        canvas.setPointerCapture(event.pointerId);
+        push(InputEventType.POINTER_DOWN, event);
+      }],
+      ['pointerup', (event: PointerEvent) => push(InputEventType.POINTER_UP, event)],
+      ['pointermove', (event: PointerEvent) => push(InputEventType.POINTER_MOVE, event)],
+      ['pointerleave', (event: PointerEvent) => push(InputEventType.POINTER_LEAVE, event)],
+      ['pointercancel', (event: PointerEvent) => push(InputEventType.POINTER_CANCEL, event)],
+      ['keydown', (event: KeyboardEvent) => wasm.pushInput(InputEventType.KEY_DOWN, 0, 0, event.keyCode)],
+      ['keyup', (event: KeyboardEvent) => wasm.pushInput(InputEventType.KEY_UP, 0, 0, event.keyCode)]
+    ];
+
+    // Focusable, so keyboard events reach it
+    canvas.tabIndex = 0;
+    for (const [type, listener] of listeners) {
+      canvas.addEventListener(type, listener);
+    }
+    this.detachInput = () => {
+      for (const [type, listener] of listeners) {
+        canvas.removeEventListener(type, listener);
+      }
+    };
+  }
+
+  /**
+   * Interactions from the input queued since the last call, hit-tested
+   * against the frame on screen
+   */
+  public drainInput(): Interaction[] {
+    return this.wasmRenderer.dispatchInput();
   }
 
   /**
@@ -143,6 +325,10 @@ export class FlareRenderer {
    * Clean up resources
    */
   public destroy(): void {
+    if (this.detachInput) {
+      this.detachInput();
+      this.detachInput = null;
+    }
     this.wasmRenderer.destroy();
     if (this.canvas.parentNode) {
       this.canvas.parentNode.removeChild(this.canvas);
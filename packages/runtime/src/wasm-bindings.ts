@@ -9,32 +9,276 @@ declare global {
 // Type for module factory function
 type WasmModuleFactory = () => Promise<FlareWasmModule>;
 
+// WebAssembly features the loader can pick a module variant for
+export interface WasmFeatures {
+    simd: boolean;
+    threads: boolean;
+}
+
+// Smallest module that uses a v128 instruction (i8x16.splat + i8x16.popcnt);
+// it only validates when the engine supports simd128
+const SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0,
+    10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+]);
+
+// Detect optional WebAssembly features without instantiating anything
+export function detectWasmFeatures(): WasmFeatures {
+    const hasWasm = typeof WebAssembly === 'object' && typeof WebAssembly.validate === 'function';
+
+    let simd = false;
+    if (hasWasm) {
+      try {
+        simd = WebAssembly.validate(SIMD_PROBE);
+      } catch (e) {
+        simd = false;
+      }
+    }
+
+    // Threads need shared memory, which browsers only expose to cross-origin isolated pages
+    const threads = hasWasm &&
+      typeof SharedArrayBuffer !== 'undefined' &&
+      typeof self !== 'undefined' &&
+      (self as any).crossOriginIsolated === true;
+
+    return { simd, threads };
+}
+
+// How the renderer gets frames onto the canvas
+export type RenderBackend = 'canvas' | 'software';
+
+// Backend order used by renderer.h (RendererBackend)
+const RENDER_BACKENDS: RenderBackend[] = ['canvas', 'software'];
+
+// Keyframes for one track of an instanced symbol
+export interface SymbolTrackData {
+    frames: number[];
+    values: number[];
+    easings?: string[];
+}
+
+// Track order used by instancing.h (SymbolTrack)
+const SYMBOL_TRACKS = ['x', 'y', 'rotation', 'scaleX', 'scaleY', 'opacity'];
+
+// Easings instancing.h implements natively (SymbolEasing); anything else falls back to linear
+const SYMBOL_EASINGS = ['linear', 'ease-in', 'ease-out', 'ease-in-out', 'step'];
+
+// Output channels of symbol_evaluate: world transform (a b c d e f), then opacity
+const SYMBOL_OUTPUT_COUNT = 7;
+
+// Shapes a layer stack can draw per instance, in draw_list.h order (DrawCommandType)
+export type LayerShape = 'rectangle' | 'circle';
+const LAYER_SHAPES: LayerShape[] = ['rectangle', 'circle'];
+
+// An entry unpacked into the native heap by loadPackage
+export interface PackageEntryInfo {
+    name: string;
+    offset: number;     // HeapOffset of the entry's bytes
+    size: number;
+}
+
+// Entries of a package opened with openPackage
+export interface PackageArchive {
+    names(): string[];
+    has(name: string): boolean;
+    isLoaded(name: string): boolean;
+    // Fetch and unpack an entry on first use; later calls share the result
+    load(name: string): Promise<PackageEntryInfo>;
+}
+
+// An entry of a package's central directory
+interface IndexedEntry {
+    start: number;      // Byte range of its local header, data and descriptor
+    end: number;
+    compressedSize: number;
+    size: number;
+}
+
+// Bytes fetched from the end of a package: the end-of-central-directory
+// record plus the longest possible comment
+const PACKAGE_TAIL_SIZE = 22 + 65535;
+
+// Status codes of package_reader_push (PackageStatus)
+const PACKAGE_DONE = 1;
+const PACKAGE_ERROR = -1;
+
+// Entry holding the package's metadata, including its integrity map
+const PACKAGE_MANIFEST = 'manifest.json';
+
+// Decode UTF-8 text from a view of the native heap. The threaded build's
+// heap is a SharedArrayBuffer, and browsers' TextDecoder refuses views of
+// shared memory, so the bytes are copied out first.
+export function decodeHeapText(bytes: Uint8Array): string {
+    return new TextDecoder().decode(bytes.slice());
+}
+
+// Expected SHA-256 digests from the manifest's "integrity" map, which holds
+// Subresource Integrity strings ("sha256-<base64>") keyed by entry name.
+// Returns null for packages that don't declare one.
+function parseIntegrity(manifest: Uint8Array): Map<string, Uint8Array> | null {
+    const parsed = JSON.parse(decodeHeapText(manifest));
+    const integrity = parsed ? parsed.integrity : null;
+    if (!integrity || typeof integrity !== 'object') return null;
+
+    const digests = new Map<string, Uint8Array>();
+    for (const name of Object.keys(integrity)) {
+        const value = String(integrity[name]);
+        const binary = value.startsWith('sha256-') ? atob(value.slice(7)) : '';
+        if (binary.length !== 32) {
+            throw new Error(`Unsupported integrity value for ${name}: ${value}`);
+        }
+
+        const digest = new Uint8Array(32);
+        for (let i = 0; i < 32; i++) digest[i] = binary.charCodeAt(i);
+        digests.set(name, digest);
+    }
+    return digests;
+}
+
+// Load state of a scheduled asset, as in asset_scheduler.h (AssetState)
+export enum AssetState {
+    PENDING = 0,
+    LOADING = 1,
+    READY = 2,
+    FAILED = 3
+}
+
+// Counters kept by an asset scheduler
+export interface AssetSchedulerStats {
+    pending: number;
+    loading: number;
+    ready: number;
+    failed: number;
+    misses: number;         // Assets that were due on screen before they were ready
+    lateFrames: number;     // Frames assets spent on screen without being ready
+}
+
+// DOM events written to the input ring, as in input.h (InputEventType)
+export enum InputEventType {
+    POINTER_DOWN = 1,
+    POINTER_UP = 2,
+    POINTER_MOVE = 3,
+    POINTER_LEAVE = 4,
+    POINTER_CANCEL = 5,
+    KEY_DOWN = 6,
+    KEY_UP = 7
+}
+
+// Interactions drained from the input ring, as in input.h (InteractionType)
+export enum InteractionType {
+    CLICK = 0,
+    HOVER = 1,
+    DRAG_START = 2,
+    DRAG_END = 3,
+    KEY_DOWN = 4,
+    KEY_UP = 5
+}
+
+// How a mask limits what's drawn through it, as in draw_list.h (DrawMaskMode)
+export enum MaskMode {
+    ALPHA = 0,              // Coverage times fill alpha
+    CLIP = 1                // Coverage alone; rectangles cut on whole pixels
+}
+
+// How a group is composited onto what's below it, as in draw_list.h (DrawBlendMode)
+export enum BlendMode {
+    NORMAL = 0,
+    MULTIPLY = 1,
+    SCREEN = 2,
+    OVERLAY = 3,
+    ADD = 4                 // Saturating, like canvas "lighter"; alpha adds up too
+}
+
+// One interaction from dispatchInput
+export interface Interaction {
+    type: InteractionType;
+    tag: number;            // Draw tag of the element hit, 0 for key events
+    x: number;
+    y: number;
+    detail: number;         // Pressed buttons for pointer events, key code for keys
+}
+
+// Layout of input.h's InputRing and Interaction, in 32-bit words
+const INPUT_RING_HEAD = 0;
+const INPUT_RING_TAIL = 16;
+const INPUT_RING_DROPPED = 17;
+const INPUT_RING_EVENTS = 32;
+const INPUT_RING_CAPACITY = 256;
+const INPUT_EVENT_WORDS = 4;
+const INTERACTION_WORDS = 5;
+
+// Append an event to the input ring at byte offset `ring` of linear memory.
+// This is the ring's only producer, and it never calls into the module, so
+// a listener on another thread can use it with views over the shared memory.
+// Returns false if the ring is full and the event was dropped.
+export function writeInputEvent(
+    u32: Uint32Array,
+    f32: Float32Array,
+    ring: number,
+    type: InputEventType,
+    x: number,
+    y: number,
+    detail: number
+): boolean {
+    const base = ring >> 2;
+    const tail = u32[base + INPUT_RING_TAIL];
+    const head = Atomics.load(u32, base + INPUT_RING_HEAD);
+    if (((tail - head) >>> 0) >= INPUT_RING_CAPACITY) {
+        u32[base + INPUT_RING_DROPPED]++;
+        return false;
+    }
+
+    const slot = base + INPUT_RING_EVENTS + (tail & (INPUT_RING_CAPACITY - 1)) * INPUT_EVENT_WORDS;
+    u32[slot] = type;
+    f32[slot + 1] = x;
+    f32[slot + 2] = y;
+    u32[slot + 3] = detail;
+    // Publish the event only once it's written
+    Atomics.store(u32, base + INPUT_RING_TAIL, (tail + 1) >>> 0);
+    return true;
+}
+
+// Pick the best module variant the current browser can run
+function selectWasmVariant(features: WasmFeatures): string {
+    // The threaded build is SIMD too; browsers with shared memory all have simd128
+    if (features.threads && features.simd) return 'flare_runtime_threads';
+    return features.simd ? 'flare_runtime_simd' : 'flare_runtime';
+}
+
 // Replace the import with a more browser-friendly approach
 async function loadWasmModule(): Promise<WasmModuleFactory> {
 try {
     // For debugging
     console.log('Loading WebAssembly module...');
-    
+
+    const features = detectWasmFeatures();
+    const variant = selectWasmVariant(features);
+    console.log('WebAssembly features:', features, 'using variant:', variant);
+
     // Create a script element to load the WebAssembly module
-    const wasmScriptUrl = '/wasm/flare_runtime.js';
-    
+    const wasmScriptUrl = `/wasm/${variant}.js`;
+    const wasmBinaryUrl = `/wasm/${variant}.wasm`;
+
+    // Create a factory function that instantiates the module with the matching binary
+    const createFactory = (): WasmModuleFactory => {
+      return () => {
+        return Promise.resolve(window.FlareWasmModule({
+          locateFile: (path: string) => {
+            if (path.endsWith('.wasm')) {
+              return wasmBinaryUrl;
+            }
+            return path;
+          }
+        }));
+      };
+    };
+
     // Return a promise that resolves when the script is loaded
     return new Promise<WasmModuleFactory>((resolve, reject) => {
       // Check if FlareWasmModule is already defined
       if (window.FlareWasmModule) {
         console.log('FlareWasmModule already loaded, using existing instance');
-        // Create a factory function that returns the module
-        const factory = () => {
-          return Promise.resolve(window.FlareWasmModule({
-            locateFile: (path: string) => {
-              if (path.endsWith('.wasm')) {
-                return '/wasm/flare_runtime.wasm';
-              }
-              return path;
-            }
-          }));
-        };
-        resolve(factory);
+        resolve(createFactory());
         return;
       }
       
@@ -47,18 +291,7 @@ try {
         console.log('WebAssembly script loaded');
         // When the script is loaded, return a factory function
         if (window.FlareWasmModule) {
-          // Create a factory function that returns the module
-          const factory = () => {
-            return Promise.resolve(window.FlareWasmModule({
-              locateFile: (path: string) => {
-                if (path.endsWith('.wasm')) {
-                  return '/wasm/flare_runtime.wasm';
-                }
-                return path;
-              }
-            }));
-          };
-          resolve(factory);
+          resolve(createFactory());
         } else {
           reject(new Error('FlareWasmModule not found after script load'));
         }
@@ -105,6 +338,94 @@ interface FlareWasmModule {
       fillColorPtr: number
     ) => void;
     renderer_resize: (rendererHandle: number, width: number, height: number) => void;
+    renderer_end_frame: (rendererHandle: number) => void;
+    renderer_set_backend: (rendererHandle: number, backend: number) => number;
+    renderer_backend: (rendererHandle: number) => number;
+    renderer_set_latency: (rendererHandle: number, frames: number) => number;
+    renderer_threaded: (rendererHandle: number) => number;
+    renderer_set_tag: (rendererHandle: number, tag: number) => void;
+    renderer_presented_list: (rendererHandle: number) => number;
+    renderer_draw_layers: (rendererHandle: number, stackHandle: number, time: number) => number;
+    renderer_begin_mask: (rendererHandle: number, mode: number) => void;
+    renderer_begin_masked: (rendererHandle: number) => void;
+    renderer_end_mask: (rendererHandle: number) => void;
+    renderer_begin_group: (rendererHandle: number, opacity: number, mode: number) => void;
+    renderer_end_group: (rendererHandle: number) => void;
+    renderer_add_blur: (rendererHandle: number, radius: number) => void;
+    renderer_add_shadow: (rendererHandle: number, x: number, y: number, radius: number, color: string) => void;
+    renderer_add_color_matrix: (rendererHandle: number, matrix: Uint8Array) => void;
+    draw_color_parse: (color: string) => number;
+    flare_simd_enabled: () => number;
+    heap_create: (capacity: number) => number;
+    heap_destroy: (heapHandle: number) => void;
+    heap_used: (heapHandle: number) => number;
+    heap_base: (heapHandle: number) => number;
+    symbol_create: (duration: number, loop: number) => number;
+    symbol_destroy: (symbolHandle: number) => void;
+    symbol_set_track: (
+      symbolHandle: number,
+      track: number,
+      framesPtr: number,
+      valuesPtr: number,
+      easingsPtr: number,
+      count: number
+    ) => number;
+    symbol_add_instance: (symbolHandle: number, timeOffset: number, rate: number, rootTransformPtr: number) => number;
+    symbol_remove_instance: (symbolHandle: number, index: number) => void;
+    symbol_instance_count: (symbolHandle: number) => number;
+    symbol_evaluate: (symbolHandle: number, time: number) => void;
+    symbol_output: (symbolHandle: number, channel: number) => number;
+    layer_stack_create: () => number;
+    layer_stack_destroy: (stackHandle: number) => void;
+    layer_stack_add: (
+      stackHandle: number,
+      symbolHandle: number,
+      shape: number,
+      width: number,
+      height: number,
+      color: number,
+      tag: number
+    ) => number;
+    layer_stack_count: (stackHandle: number) => number;
+    layer_stack_workers: (stackHandle: number) => number;
+    package_reader_create: (heapHandle: number) => number;
+    package_reader_destroy: (readerHandle: number) => void;
+    package_reader_push: (readerHandle: number, dataPtr: number, size: number) => number;
+    package_reader_error: (readerHandle: number) => string;
+    package_reader_expect: (readerHandle: number, namePtr: string, digestPtr: number) => number;
+    package_reader_expect_sizes: (readerHandle: number, namePtr: string, compressedSize: number, size: number) => number;
+    package_entry_count: (readerHandle: number) => number;
+    package_entry_name: (readerHandle: number, index: number) => string;
+    package_entry_offset: (readerHandle: number, index: number) => number;
+    package_entry_size: (readerHandle: number, index: number) => number;
+    package_entry_digest: (readerHandle: number, index: number) => number;
+    package_find_entry: (readerHandle: number, namePtr: string) => number;
+    package_locate_directory: (tailPtr: number, tailSize: number, archiveSize: number, rangePtr: number) => number;
+    package_index_create: (directoryPtr: number, size: number, directoryOffset: number) => number;
+    package_index_destroy: (indexHandle: number) => void;
+    package_index_count: (indexHandle: number) => number;
+    package_index_name: (indexHandle: number, entry: number) => string;
+    package_index_size: (indexHandle: number, entry: number) => number;
+    package_index_compressed_size: (indexHandle: number, entry: number) => number;
+    package_index_range_start: (indexHandle: number, entry: number) => number;
+    package_index_range_end: (indexHandle: number, entry: number) => number;
+    asset_scheduler_create: (duration: number, loop: number) => number;
+    asset_scheduler_destroy: (schedulerHandle: number) => void;
+    asset_scheduler_add_asset: (schedulerHandle: number) => number;
+    asset_scheduler_add_use: (schedulerHandle: number, asset: number, start: number, end: number) => number;
+    asset_scheduler_set_state: (schedulerHandle: number, asset: number, state: number) => void;
+    asset_scheduler_next: (schedulerHandle: number, playhead: number, horizon: number, outPtr: number, max: number) => number;
+    asset_scheduler_advance: (schedulerHandle: number, playhead: number) => number;
+    asset_scheduler_miss_count: (schedulerHandle: number) => number;
+    asset_scheduler_late_frames: (schedulerHandle: number) => number;
+    asset_scheduler_count_state: (schedulerHandle: number, state: number) => number;
+    input_ring_create: () => number;
+    input_ring_destroy: (ringPtr: number) => void;
+    input_ring_dropped: (ringPtr: number) => number;
+    input_dispatcher_create: () => number;
+    input_dispatcher_destroy: (dispatcherHandle: number) => void;
+    input_dispatch: (dispatcherHandle: number, ringPtr: number, drawListHandle: number) => number;
+    input_dispatcher_batch: (dispatcherHandle: number) => number;
   }
   
   // Class to wrap and manage the WebAssembly module
@@ -113,6 +434,9 @@ interface FlareWasmModule {
     private module: FlareWasmModule | null = null;
     private functions: WasmFunctions | null = null;
     private rendererHandle: number = 0;
+    private heapHandle: number = 0;
+    private inputRing: number = 0;
+    private inputDispatcher: number = 0;
     private canvasId: number = 0;
     private initialized: boolean = false;
   
@@ -142,7 +466,81 @@ interface FlareWasmModule {
           renderer_draw_rectangle: this.module!.cwrap('renderer_draw_rectangle', null, ['number', 'number', 'number', 'number', 'number', 'number']),
           renderer_draw_circle: this.module!.cwrap('renderer_draw_circle', null, ['number', 'number', 'number', 'number', 'number']),
           renderer_resize: this.module!.cwrap('renderer_resize', null, ['number', 'number', 'number']),
+          renderer_end_frame: this.module!.cwrap('renderer_end_frame', null, ['number']),
+          renderer_set_backend: this.module!.cwrap('renderer_set_backend', 'number', ['number', 'number']),
+          renderer_backend: this.module!.cwrap('renderer_backend', 'number', ['number']),
+          renderer_set_latency: this.module!.cwrap('renderer_set_latency', 'number', ['number', 'number']),
+          renderer_threaded: this.module!.cwrap('renderer_threaded', 'number', ['number']),
+          renderer_set_tag: this.module!.cwrap('renderer_set_tag', null, ['number', 'number']),
+          renderer_presented_list: this.module!.cwrap('renderer_presented_list', 'number', ['number']),
+          renderer_draw_layers: this.module!.cwrap('renderer_draw_layers', 'number', ['number', 'number', 'number']),
+          renderer_begin_mask: this.module!.cwrap('renderer_begin_mask', null, ['number', 'number']),
+          renderer_begin_masked: this.module!.cwrap('renderer_begin_masked', null, ['number']),
+          renderer_end_mask: this.module!.cwrap('renderer_end_mask', null, ['number']),
+          renderer_begin_group: this.module!.cwrap('renderer_begin_group', null, ['number', 'number', 'number']),
+          renderer_end_group: this.module!.cwrap('renderer_end_group', null, ['number']),
+          renderer_add_blur: this.module!.cwrap('renderer_add_blur', null, ['number', 'number']),
+          renderer_add_shadow: this.module!.cwrap('renderer_add_shadow', null, ['number', 'number', 'number', 'number', 'string']),
+          renderer_add_color_matrix: this.module!.cwrap('renderer_add_color_matrix', null, ['number', 'array']),
+          draw_color_parse: this.module!.cwrap('draw_color_parse', 'number', ['string']),
+          flare_simd_enabled: this.module!.cwrap('flare_simd_enabled', 'number', []),
+          heap_create: this.module!.cwrap('heap_create', 'number', ['number']),
+          heap_destroy: this.module!.cwrap('heap_destroy', null, ['number']),
+          heap_used: this.module!.cwrap('heap_used', 'number', ['number']),
+          heap_base: this.module!.cwrap('heap_base', 'number', ['number']),
+          symbol_create: this.module!.cwrap('symbol_create', 'number', ['number', 'number']),
+          symbol_destroy: this.module!.cwrap('symbol_destroy', null, ['number']),
+          symbol_set_track: this.module!.cwrap('symbol_set_track', 'number', ['number', 'number', 'number', 'number', 'number', 'number']),
+          symbol_add_instance: this.module!.cwrap('symbol_add_instance', 'number', ['number', 'number', 'number', 'number']),
+          symbol_remove_instance: this.module!.cwrap('symbol_remove_instance', null, ['number', 'number']),
+          symbol_instance_count: this.module!.cwrap('symbol_instance_count', 'number', ['number']),
+          symbol_evaluate: this.module!.cwrap('symbol_evaluate', null, ['number', 'number']),
+          symbol_output: this.module!.cwrap('symbol_output', 'number', ['number', 'number']),
+          layer_stack_create: this.module!.cwrap('layer_stack_create', 'number', []),
+          layer_stack_destroy: this.module!.cwrap('layer_stack_destroy', null, ['number']),
+          layer_stack_add: this.module!.cwrap('layer_stack_add', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number']),
+          layer_stack_count: this.module!.cwrap('layer_stack_count', 'number', ['number']),
+          layer_stack_workers: this.module!.cwrap('layer_stack_workers', 'number', ['number']),
+          package_reader_create: this.module!.cwrap('package_reader_create', 'number', ['number']),
+          package_reader_destroy: this.module!.cwrap('package_reader_destroy', null, ['number']),
+          package_reader_push: this.module!.cwrap('package_reader_push', 'number', ['number', 'number', 'number']),
+          package_reader_error: this.module!.cwrap('package_reader_error', 'string', ['number']),
+          package_reader_expect: this.module!.cwrap('package_reader_expect', 'number', ['number', 'string', 'number']),
+          package_reader_expect_sizes: this.module!.cwrap('package_reader_expect_sizes', 'number', ['number', 'string', 'number', 'number']),
+          package_entry_count: this.module!.cwrap('package_entry_count', 'number', ['number']),
+          package_entry_name: this.module!.cwrap('package_entry_name', 'string', ['number', 'number']),
+          package_entry_offset: this.module!.cwrap('package_entry_offset', 'number', ['number', 'number']),
+          package_entry_size: this.module!.cwrap('package_entry_size', 'number', ['number', 'number']),
+          package_entry_digest: this.module!.cwrap('package_entry_digest', 'number', ['number', 'number']),
+          package_find_entry: this.module!.cwrap('package_find_entry', 'number', ['number', 'string']),
+          package_locate_directory: this.module!.cwrap('package_locate_directory', 'number', ['number', 'number', 'number', 'number']),
+          package_index_create: this.module!.cwrap('package_index_create', 'number', ['number', 'number', 'number']),
+          package_index_destroy: this.module!.cwrap('package_index_destroy', null, ['number']),
+          package_index_count: this.module!.cwrap('package_index_count', 'number', ['number']),
+          package_index_name: this.module!.cwrap('package_index_name', 'string', ['number', 'number']),
+          package_index_size: this.module!.cwrap('package_index_size', 'number', ['number', 'number']),
+          package_index_compressed_size: this.module!.cwrap('package_index_compressed_size', 'number', ['number', 'number']),
+          package_index_range_start: this.module!.cwrap('package_index_range_start', 'number', ['number', 'number']),
+          package_index_range_end: this.module!.cwrap('package_index_range_end', 'number', ['number', 'number']),
+          asset_scheduler_create: this.module!.cwrap('asset_scheduler_create', 'number', ['number', 'number']),
+          asset_scheduler_destroy: this.module!.cwrap('asset_scheduler_destroy', null, ['number']),
+          asset_scheduler_add_asset: this.module!.cwrap('asset_scheduler_add_asset', 'number', ['number']),
+          asset_scheduler_add_use: this.module!.cwrap('asset_scheduler_add_use', 'number', ['number', 'number', 'number', 'number']),
+          asset_scheduler_set_state: this.module!.cwrap('asset_scheduler_set_state', null, ['number', 'number', 'number']),
+          asset_scheduler_next: this.module!.cwrap('asset_scheduler_next', 'number', ['number', 'number', 'number', 'number', 'number']),
+          asset_scheduler_advance: this.module!.cwrap('asset_scheduler_advance', 'number', ['number', 'number']),
+          asset_scheduler_miss_count: this.module!.cwrap('asset_scheduler_miss_count', 'number', ['number']),
+          asset_scheduler_late_frames: this.module!.cwrap('asset_scheduler_late_frames', 'number', ['number']),
+          asset_scheduler_count_state: this.module!.cwrap('asset_scheduler_count_state', 'number', ['number', 'number']),
+          input_ring_create: this.module!.cwrap('input_ring_create', 'number', []),
+          input_ring_destroy: this.module!.cwrap('input_ring_destroy', null, ['number']),
+          input_ring_dropped: this.module!.cwrap('input_ring_dropped', 'number', ['number']),
+          input_dispatcher_create: this.module!.cwrap('input_dispatcher_create', 'number', []),
+          input_dispatcher_destroy: this.module!.cwrap('input_dispatcher_destroy', null, ['number']),
+          input_dispatch: this.module!.cwrap('input_dispatch', 'number', ['number', 'number', 'number']),
+          input_dispatcher_batch: this.module!.cwrap('input_dispatcher_batch', 'number', ['number']),
         };
+        console.log('WebAssembly module SIMD enabled:', this.functions.flare_simd_enabled() === 1);
   
         // Create the renderer
         this.canvasId = canvasId;
@@ -151,6 +549,19 @@ interface FlareWasmModule {
         if (this.rendererHandle === 0) {
           throw new Error('Failed to create renderer');
         }
+
+        // Create the heap that holds the native scene state
+        this.heapHandle = this.functions.heap_create(0);
+        if (this.heapHandle === 0) {
+          throw new Error('Failed to create native heap');
+        }
+
+        // Create the ring DOM listeners write input events to
+        this.inputRing = this.functions.input_ring_create();
+        this.inputDispatcher = this.functions.input_dispatcher_create();
+        if (this.inputRing === 0 || this.inputDispatcher === 0) {
+          throw new Error('Failed to create input ring');
+        }
   
         this.initialized = true;
       } catch (error) {
@@ -165,6 +576,12 @@ interface FlareWasmModule {
       
       this.functions.renderer_destroy(this.rendererHandle);
       this.rendererHandle = 0;
+      this.functions.heap_destroy(this.heapHandle);
+      this.heapHandle = 0;
+      this.functions.input_dispatcher_destroy(this.inputDispatcher);
+      this.inputDispatcher = 0;
+      this.functions.input_ring_destroy(this.inputRing);
+      this.inputRing = 0;
       this.initialized = false;
     }
   
@@ -173,7 +590,621 @@ interface FlareWasmModule {
       if (!this.initialized || !this.functions) return;
       this.functions.renderer_clear(this.rendererHandle);
     }
+
+    // Submit the frame drawn since clear() and present the newest finished one
+    public endFrame(): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_end_frame(this.rendererHandle);
+    }
+
+    // Replay draw lists through Canvas2D, or rasterize them natively
+    public setRenderBackend(backend: RenderBackend): boolean {
+      if (!this.initialized || !this.functions) return false;
+      return this.functions.renderer_set_backend(this.rendererHandle, RENDER_BACKENDS.indexOf(backend)) === 0;
+    }
+
+    public getRenderBackend(): RenderBackend | null {
+      if (!this.initialized || !this.functions) return null;
+      return RENDER_BACKENDS[this.functions.renderer_backend(this.rendererHandle)] || null;
+    }
+
+    // Frames the pipeline may hold a frame before presenting it (0-2). Only
+    // the threaded build uses it, to rasterize one frame while evaluating the next.
+    public setFrameLatency(frames: number): boolean {
+      if (!this.initialized || !this.functions) return false;
+      return this.functions.renderer_set_latency(this.rendererHandle, frames) === 0;
+    }
+
+    // Whether frames are rasterized on a worker thread
+    public isThreaded(): boolean {
+      if (!this.initialized || !this.functions) return false;
+      return this.functions.renderer_threaded(this.rendererHandle) === 1;
+    }
   
+    // Tag the following draw calls with an element, for hit testing; 0 clears the tag
+    public setDrawTag(tag: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_set_tag(this.rendererHandle, tag);
+    }
+
+    // Start a mask: the following draw calls make up its shapes
+    public beginMask(mode: MaskMode): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_begin_mask(this.rendererHandle, mode);
+    }
+
+    // Draw calls from here to endMask are drawn through the mask
+    public beginMasked(): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_begin_masked(this.rendererHandle);
+    }
+
+    // Go back to drawing unmasked
+    public endMask(): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_end_mask(this.rendererHandle);
+    }
+
+    // Start a group: draw calls up to the matching endGroup are composited
+    // together at `opacity` (0-1) with `mode`
+    public beginGroup(opacity: number, mode: BlendMode = BlendMode.NORMAL): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_begin_group(this.rendererHandle, opacity, mode);
+    }
+
+    public endGroup(): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_end_group(this.rendererHandle);
+    }
+
+    // Filters for the group just begun, before anything is drawn in it.
+    // `radius` is the blur's standard deviation, as in CSS blur().
+    public addBlur(radius: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_add_blur(this.rendererHandle, radius);
+    }
+
+    public addShadow(x: number, y: number, radius: number, color: string): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.renderer_add_shadow(this.rendererHandle, x, y, radius, color);
+    }
+
+    // A 4x5 color matrix, as feColorMatrix takes it (see color-matrix.ts).
+    // It's copied onto the stack for the call, as bytes.
+    public addColorMatrix(matrix: ArrayLike<number>): void {
+      if (!this.initialized || !this.functions || matrix.length !== 20) return;
+      const values = Float32Array.from(matrix);
+      this.functions.renderer_add_color_matrix(this.rendererHandle, new Uint8Array(values.buffer));
+    }
+
+    // Queue a DOM event for the next dispatchInput. Safe to call at any rate:
+    // it only writes to the ring in linear memory.
+    public pushInput(type: InputEventType, x: number, y: number, detail: number = 0): boolean {
+      if (!this.initialized || !this.module) return false;
+
+      const module = this.module as any;
+      return writeInputEvent(module.HEAPU32, module.HEAPF32, this.inputRing, type, x, y, detail);
+    }
+
+    // Where the input ring lives, for a producer on another thread. Only
+    // useful with the threaded build, whose memory is a SharedArrayBuffer.
+    public getInputRing(): { memory: ArrayBufferLike; ring: number } | null {
+      if (!this.initialized || !this.module) return null;
+      return { memory: ((this.module as any).HEAPU32 as Uint32Array).buffer, ring: this.inputRing };
+    }
+
+    // Drain the input ring, hit-testing against the frame on screen
+    public dispatchInput(): Interaction[] {
+      if (!this.initialized || !this.functions || !this.module) return [];
+
+      const count = this.functions.input_dispatch(
+        this.inputDispatcher,
+        this.inputRing,
+        this.functions.renderer_presented_list(this.rendererHandle)
+      );
+      if (count <= 0) return [];
+
+      const base = this.functions.input_dispatcher_batch(this.inputDispatcher) >> 2;
+      const HEAPU32 = (this.module as any).HEAPU32 as Uint32Array;
+      const HEAPF32 = (this.module as any).HEAPF32 as Float32Array;
+      const interactions: Interaction[] = [];
+      for (let i = 0; i < count; i++) {
+        const p = base + i * INTERACTION_WORDS;
+        interactions.push({
+          type: HEAPU32[p],
+          tag: HEAPU32[p + 1],
+          x: HEAPF32[p + 2],
+          y: HEAPF32[p + 3],
+          detail: HEAPU32[p + 4]
+        });
+      }
+      return interactions;
+    }
+
+    // Input events lost because the ring was full between ticks
+    public getDroppedInputCount(): number {
+      if (!this.initialized || !this.functions) return 0;
+      return this.functions.input_ring_dropped(this.inputRing);
+    }
+
+    // Create an instanced symbol; its tracks are copied into native memory once
+    public createSymbol(duration: number, loop: boolean, tracks: { [property: string]: SymbolTrackData }): number {
+      if (!this.initialized || !this.functions || !this.module) return 0;
+
+      const symbol = this.functions.symbol_create(duration, loop ? 1 : 0);
+      if (symbol === 0) return 0;
+
+      for (const property of Object.keys(tracks)) {
+        const track = SYMBOL_TRACKS.indexOf(property);
+        if (track === -1) {
+          console.warn(`Property ${property} can't be instanced`);
+          continue;
+        }
+
+        const data = tracks[property];
+        const count = Math.min(data.frames.length, data.values.length);
+        const easings = data.easings
+          ? new Uint8Array(data.easings.slice(0, count).map(name => Math.max(0, SYMBOL_EASINGS.indexOf(name))))
+          : null;
+
+        const framesPtr = this.copyToHeap(new Float32Array(data.frames.slice(0, count)));
+        const valuesPtr = this.copyToHeap(new Float32Array(data.values.slice(0, count)));
+        const easingsPtr = easings ? this.copyToHeap(easings) : 0;
+
+        const result = this.functions.symbol_set_track(symbol, track, framesPtr, valuesPtr, easingsPtr, count);
+
+        this.module._free(framesPtr);
+        this.module._free(valuesPtr);
+        if (easingsPtr) this.module._free(easingsPtr);
+
+        if (result !== 0) {
+          console.error(`Invalid keyframes for instanced property ${property}`);
+        }
+      }
+
+      return symbol;
+    }
+
+    // Destroy an instanced symbol and all of its instances
+    public destroySymbol(symbol: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.symbol_destroy(symbol);
+    }
+
+    // Add an instance of a symbol; rootTransform is [a, b, c, d, e, f]
+    public addSymbolInstance(symbol: number, timeOffset: number, rate: number = 1, rootTransform?: number[]): number {
+      if (!this.initialized || !this.functions || !this.module) return -1;
+
+      const transformPtr = rootTransform ? this.copyToHeap(new Float32Array(rootTransform.slice(0, 6))) : 0;
+      const index = this.functions.symbol_add_instance(symbol, timeOffset, rate, transformPtr);
+      if (transformPtr) this.module._free(transformPtr);
+      return index;
+    }
+
+    // Remove an instance; the last instance takes over its index
+    public removeSymbolInstance(symbol: number, index: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.symbol_remove_instance(symbol, index);
+    }
+
+    // Evaluate every instance of a symbol. Returns views of the a, b, c, d, e, f
+    // and opacity channels, valid until the next instance is added.
+    public evaluateSymbol(symbol: number, time: number): Float32Array[] {
+      if (!this.initialized || !this.functions || !this.module) return [];
+
+      this.functions.symbol_evaluate(symbol, time);
+
+      const count = this.functions.symbol_instance_count(symbol);
+      const HEAPF32 = (this.module as any).HEAPF32 as Float32Array;
+      const channels: Float32Array[] = [];
+      for (let channel = 0; channel < SYMBOL_OUTPUT_COUNT; channel++) {
+        const ptr = this.functions.symbol_output(symbol, channel);
+        channels.push(HEAPF32.subarray(ptr >> 2, (ptr >> 2) + count));
+      }
+      return channels;
+    }
+
+    // Create a stack of instanced layers, evaluated natively and in
+    // parallel on threaded builds
+    public createLayerStack(): number {
+      if (!this.initialized || !this.functions) return 0;
+      return this.functions.layer_stack_create();
+    }
+
+    // Destroy a layer stack; its symbols stay alive
+    public destroyLayerStack(stack: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.layer_stack_destroy(stack);
+    }
+
+    // Add a layer on top, drawing `shape` for every instance of `symbol`.
+    // Circles take their radius from `width`. Returns the layer index, or -1.
+    public addLayer(
+      stack: number,
+      symbol: number,
+      shape: LayerShape,
+      width: number,
+      height: number,
+      color: string,
+      tag: number = 0
+    ): number {
+      if (!this.initialized || !this.functions) return -1;
+
+      const color32 = this.functions.draw_color_parse(color) >>> 0;
+      return this.functions.layer_stack_add(stack, symbol, LAYER_SHAPES.indexOf(shape), width, height, color32, tag);
+    }
+
+    // Draw a layer stack at timeline frame `time` into the current frame
+    public drawLayers(stack: number, time: number): boolean {
+      if (!this.initialized || !this.functions) return false;
+      return this.functions.renderer_draw_layers(this.rendererHandle, stack, time) === 0;
+    }
+
+    // Threads evaluating layers alongside the main thread; 0 unless threaded
+    public getLayerWorkerCount(stack: number): number {
+      if (!this.initialized || !this.functions) return 0;
+      return this.functions.layer_stack_workers(stack);
+    }
+
+    // Unpack a ZIP-based .flare package into the native heap as it downloads.
+    // Each chunk is copied into linear memory once and inflated from there
+    // straight into the entry's final heap allocation. Entries are hashed as
+    // they unpack and checked against the manifest's integrity map before
+    // any of them is returned.
+    public async loadPackage(stream: ReadableStream<Uint8Array>): Promise<PackageEntryInfo[]> {
+      if (!this.initialized || !this.functions || !this.module) {
+        throw new Error('WebAssembly module not initialized');
+      }
+
+      const functions = this.functions;
+      const reader = functions.package_reader_create(this.heapHandle);
+      if (reader === 0) {
+        throw new Error('Failed to create package reader');
+      }
+
+      try {
+        const status = await this.pushPackageStream(reader, stream);
+        if (status !== PACKAGE_DONE) {
+          throw new Error('Package ended before its central directory');
+        }
+
+        const entries: PackageEntryInfo[] = [];
+        const count = functions.package_entry_count(reader);
+        for (let i = 0; i < count; i++) {
+          entries.push({
+            name: functions.package_entry_name(reader, i),
+            offset: functions.package_entry_offset(reader, i),
+            size: functions.package_entry_size(reader, i)
+          });
+        }
+
+        // The manifest can be anywhere in the archive, so the digests are
+        // compared once everything is in; each was computed during the download
+        const manifest = entries.find(entry => entry.name === PACKAGE_MANIFEST);
+        const digests = manifest ? parseIntegrity(this.getPackageEntryData(manifest)!) : null;
+        if (digests) {
+          const HEAPU8 = (this.module as any).HEAPU8 as Uint8Array;
+          for (let i = 0; i < count; i++) {
+            const name = entries[i].name;
+            if (name === PACKAGE_MANIFEST) continue;
+
+            const expected = digests.get(name);
+            const ptr = functions.package_entry_digest(reader, i);
+            if (!expected) {
+              throw new Error(`No integrity digest for ${name}`);
+            }
+            if (!expected.every((byte, k) => HEAPU8[ptr + k] === byte)) {
+              throw new Error(`Integrity check failed for ${name}`);
+            }
+          }
+        }
+        return entries;
+      } finally {
+        functions.package_reader_destroy(reader);
+      }
+    }
+
+    // Open a package for random access. Only the central directory is fetched
+    // up front; each entry is fetched by byte range and unpacked the first time
+    // it's loaded. Servers that ignore Range get the whole package streamed in
+    // once, and entries are then served from that in-memory index.
+    public async openPackage(url: string): Promise<PackageArchive> {
+      if (!this.initialized || !this.functions || !this.module) {
+        throw new Error('WebAssembly module not initialized');
+      }
+
+      const functions = this.functions;
+      const module = this.module;
+
+      const tailResponse = await fetch(url, { headers: { Range: `bytes=-${PACKAGE_TAIL_SIZE}` } });
+      const contentRange = tailResponse.headers.get('Content-Range');
+      const archiveSize = contentRange ? parseInt(contentRange.split('/')[1], 10) : NaN;
+
+      if (tailResponse.status !== 206 || !(archiveSize > 0) || !tailResponse.body) {
+        if (!tailResponse.ok || !tailResponse.body) {
+          throw new Error(`Failed to fetch package ${url}: ${tailResponse.status}`);
+        }
+        const entries = await this.loadPackage(tailResponse.body);
+        const loaded = new Map(entries.map(entry => [entry.name, entry] as [string, PackageEntryInfo]));
+        return {
+          names: () => entries.map(entry => entry.name),
+          has: name => loaded.has(name),
+          isLoaded: name => loaded.has(name),
+          load: async name => {
+            const entry = loaded.get(name);
+            if (!entry) throw new Error(`No entry ${name} in package`);
+            return entry;
+          }
+        };
+      }
+
+      // Locate the central directory in the tail, fetching it separately if
+      // it starts before the tail does
+      const tail = new Uint8Array(await tailResponse.arrayBuffer());
+      const tailStart = archiveSize - tail.length;
+      const HEAPU8 = (): Uint8Array => (module as any).HEAPU8 as Uint8Array;
+
+      const tailPtr = this.copyToHeap(tail);
+      const rangePtr = module._malloc(8);
+      const found = functions.package_locate_directory(tailPtr, tail.length, archiveSize, rangePtr);
+      const directoryOffset = new Uint32Array(HEAPU8().buffer, rangePtr, 2)[0];
+      const directorySize = new Uint32Array(HEAPU8().buffer, rangePtr, 2)[1];
+      module._free(rangePtr);
+
+      let directoryPtr = tailPtr + (directoryOffset - tailStart);
+      let ownedPtr = 0;
+      if (found && directoryOffset < tailStart) {
+        const response = await fetch(url, {
+          headers: { Range: `bytes=${directoryOffset}-${directoryOffset + directorySize - 1}` }
+        });
+        const directory = new Uint8Array(await response.arrayBuffer());
+        if (response.status !== 206 || directory.length !== directorySize) {
+          module._free(tailPtr);
+          throw new Error(`Failed to fetch the central directory of ${url}`);
+        }
+        directoryPtr = ownedPtr = this.copyToHeap(directory);
+      }
+
+      const index = found ? functions.package_index_create(directoryPtr, directorySize, directoryOffset) : 0;
+      module._free(tailPtr);
+      if (ownedPtr) module._free(ownedPtr);
+      if (index === 0) {
+        throw new Error(`Invalid package ${url}: no central directory`);
+      }
+
+      // Copy the index out so the native one can go
+      const ranges = new Map<string, IndexedEntry>();
+      const count = functions.package_index_count(index);
+      for (let i = 0; i < count; i++) {
+        ranges.set(functions.package_index_name(index, i), {
+          start: functions.package_index_range_start(index, i),
+          end: functions.package_index_range_end(index, i),
+          compressedSize: functions.package_index_compressed_size(index, i),
+          size: functions.package_index_size(index, i)
+        });
+      }
+      functions.package_index_destroy(index);
+
+      const loaded = new Map<string, PackageEntryInfo>();
+      const pending = new Map<string, Promise<PackageEntryInfo>>();
+
+      // Digests from the manifest, fetched alongside the first entries rather
+      // than ahead of them. Each entry's digest is handed to its reader, which
+      // checks it as the last byte unpacks, so a load only resolves verified.
+      let integrity: Promise<Map<string, Uint8Array> | null> = Promise.resolve(null);
+
+      const fetchEntry = async (name: string, range: IndexedEntry): Promise<PackageEntryInfo> => {
+        const response = await fetch(url, { headers: { Range: `bytes=${range.start}-${range.end - 1}` } });
+        if (response.status !== 206 || !response.body) {
+          throw new Error(`Failed to fetch ${name} from ${url}: ${response.status}`);
+        }
+
+        // A reader per load, so concurrent loads don't interleave their bytes
+        const reader = functions.package_reader_create(this.heapHandle);
+        if (reader === 0) {
+          throw new Error('Failed to create package reader');
+        }
+
+        try {
+          // Streamed entries only declare their sizes in the central directory
+          if (!functions.package_reader_expect_sizes(reader, name, range.compressedSize, range.size)) {
+            throw new Error('Failed to register entry sizes');
+          }
+          if (name !== PACKAGE_MANIFEST) {
+            const digests = await integrity;
+            if (digests) this.expectDigest(reader, name, digests);
+          }
+
+          await this.pushPackageStream(reader, response.body);
+          const entry = functions.package_find_entry(reader, name);
+          if (entry === -1) {
+            throw new Error(`Entry ${name} missing from its byte range`);
+          }
+          return {
+            name,
+            offset: functions.package_entry_offset(reader, entry),
+            size: functions.package_entry_size(reader, entry)
+          };
+        } finally {
+          functions.package_reader_destroy(reader);
+        }
+      };
+
+      const load = (name: string): Promise<PackageEntryInfo> => {
+        const entry = loaded.get(name);
+        if (entry) return Promise.resolve(entry);
+
+        let promise = pending.get(name);
+        if (!promise) {
+          const range = ranges.get(name);
+          if (!range) return Promise.reject(new Error(`No entry ${name} in package`));
+
+          promise = fetchEntry(name, range).then(
+            info => {
+              pending.delete(name);
+              loaded.set(name, info);
+              return info;
+            },
+            error => {
+              pending.delete(name);
+              throw error;
+            }
+          );
+          pending.set(name, promise);
+        }
+        return promise;
+      };
+
+      if (ranges.has(PACKAGE_MANIFEST)) {
+        integrity = load(PACKAGE_MANIFEST).then(entry => parseIntegrity(this.getPackageEntryData(entry)!));
+        // Loads that need it report the failure
+        integrity.catch(() => {});
+      }
+
+      return {
+        names: () => Array.from(ranges.keys()),
+        has: name => ranges.has(name),
+        isLoaded: name => loaded.has(name),
+        load
+      };
+    }
+
+    // Have a reader check an entry against its manifest digest. Packages with
+    // an integrity map must list every entry, so unlisted ones are refused.
+    private expectDigest(reader: number, name: string, digests: Map<string, Uint8Array>): void {
+      const digest = digests.get(name);
+      if (!digest) {
+        throw new Error(`No integrity digest for ${name}`);
+      }
+
+      const ptr = this.copyToHeap(digest);
+      const registered = this.functions!.package_reader_expect(reader, name, ptr);
+      this.module!._free(ptr);
+      if (!registered) {
+        throw new Error('Failed to register integrity digest');
+      }
+    }
+
+    // Push a stream into a package reader until it ends or the reader reaches
+    // the central directory. Each chunk is copied into linear memory once,
+    // through a staging buffer that's reused across chunks.
+    private async pushPackageStream(reader: number, stream: ReadableStream<Uint8Array>): Promise<number> {
+      const functions = this.functions!;
+      const module = this.module!;
+      const source = stream.getReader();
+      let staging = 0;
+      let stagingSize = 0;
+      let status = 0;
+
+      try {
+        while (status !== PACKAGE_DONE) {
+          const { done, value } = await source.read();
+          if (done) break;
+          if (!value || value.length === 0) continue;
+
+          if (value.length > stagingSize) {
+            if (staging) module._free(staging);
+            staging = module._malloc(value.length);
+            stagingSize = value.length;
+          }
+          ((module as any).HEAPU8 as Uint8Array).set(value, staging);
+
+          status = functions.package_reader_push(reader, staging, value.length);
+          if (status === PACKAGE_ERROR) {
+            throw new Error('Invalid package: ' + functions.package_reader_error(reader));
+          }
+        }
+        return status;
+      } finally {
+        // Anything left is after the central directory started, so it isn't needed
+        source.cancel().catch(() => {});
+        if (staging) module._free(staging);
+      }
+    }
+
+    // Create an asset scheduler. `uses` holds, per asset, the [start, end)
+    // frame spans it's shown for; asset indices follow the array.
+    public createAssetScheduler(duration: number, loop: boolean, uses: [number, number][][]): number {
+      if (!this.initialized || !this.functions) return 0;
+
+      const scheduler = this.functions.asset_scheduler_create(Math.max(1, Math.ceil(duration)), loop ? 1 : 0);
+      if (scheduler === 0) return 0;
+
+      for (const spans of uses) {
+        const asset = this.functions.asset_scheduler_add_asset(scheduler);
+        for (const [start, end] of spans) {
+          this.functions.asset_scheduler_add_use(scheduler, asset, start, end);
+        }
+      }
+      return scheduler;
+    }
+
+    // Destroy an asset scheduler
+    public destroyAssetScheduler(scheduler: number): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.asset_scheduler_destroy(scheduler);
+    }
+
+    // Move the playhead; returns how many assets just missed their deadline
+    public advanceAssetScheduler(scheduler: number, playhead: number): number {
+      if (!this.initialized || !this.functions) return 0;
+      return this.functions.asset_scheduler_advance(scheduler, Math.floor(playhead));
+    }
+
+    // Up to `max` pending assets due within `horizon` frames, soonest first
+    public nextScheduledAssets(scheduler: number, playhead: number, horizon: number, max: number): number[] {
+      if (!this.initialized || !this.functions || !this.module || max <= 0) return [];
+
+      const outPtr = this.module._malloc(max * 4);
+      const count = this.functions.asset_scheduler_next(scheduler, Math.floor(playhead), horizon, outPtr, max);
+      const HEAP32 = (this.module as any).HEAP32 as Int32Array;
+      const assets = Array.from(HEAP32.subarray(outPtr >> 2, (outPtr >> 2) + count));
+      this.module._free(outPtr);
+      return assets;
+    }
+
+    // Update an asset's load state
+    public setAssetState(scheduler: number, asset: number, state: AssetState): void {
+      if (!this.initialized || !this.functions) return;
+      this.functions.asset_scheduler_set_state(scheduler, asset, state);
+    }
+
+    public getAssetSchedulerStats(scheduler: number): AssetSchedulerStats {
+      const stats = { pending: 0, loading: 0, ready: 0, failed: 0, misses: 0, lateFrames: 0 };
+      if (!this.initialized || !this.functions) return stats;
+
+      const functions = this.functions;
+      stats.pending = functions.asset_scheduler_count_state(scheduler, AssetState.PENDING);
+      stats.loading = functions.asset_scheduler_count_state(scheduler, AssetState.LOADING);
+      stats.ready = functions.asset_scheduler_count_state(scheduler, AssetState.READY);
+      stats.failed = functions.asset_scheduler_count_state(scheduler, AssetState.FAILED);
+      stats.misses = functions.asset_scheduler_miss_count(scheduler);
+      stats.lateFrames = functions.asset_scheduler_late_frames(scheduler);
+      return stats;
+    }
+
+    // View of a package entry's bytes in the native heap, valid until the heap next grows
+    public getPackageEntryData(entry: PackageEntryInfo): Uint8Array | null {
+      if (!this.initialized || !this.functions || !this.module) return null;
+      if (entry.size === 0) return new Uint8Array(0);
+      // Entries unpacked into another heap aren't in this one
+      if (entry.offset + entry.size > this.functions.heap_used(this.heapHandle)) return null;
+
+      const base = this.functions.heap_base(this.heapHandle);
+      const HEAPU8 = (this.module as any).HEAPU8 as Uint8Array;
+      return HEAPU8.subarray(base + entry.offset, base + entry.offset + entry.size);
+    }
+
+    // Helper to copy a typed array into linear memory; the caller frees it
+    private copyToHeap(data: Float32Array | Uint8Array): number {
+      if (!this.module) return 0;
+
+      const ptr = this.module._malloc(data.byteLength);
+      const HEAPU8 = (this.module as any).HEAPU8 as Uint8Array;
+      HEAPU8.set(new Uint8Array(data.buffer, data.byteOffset, data.byteLength), ptr);
+      return ptr;
+    }
+
     // Helper to create a C string
     private createCString(str: string): number {
       if (!this.module) return 0;
@@ -0,0 +1,527 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <emscripten.h>
+#include "vertex.h"
+#include "raster.h"
+#include "simd.h"
+#include "heap.h"
+#include "package.h"
+
+// Native kernel benchmarks. Configure with -DFLARE_BUILD_BENCH=ON and run
+// the result under node:
+//
+//   node flare_bench.js [vertices] [frames] [elements]
+//
+// Each frame transforms every vertex by a different matrix and gathers the
+// bounds, as the renderer would for a scene's flattened geometry. Then the
+// same number of frames of overlapping rectangles, opaque and translucent,
+// are rasterized in each framebuffer format. Last, stress scenes of 1000
+// elements and ten times as many, up to `elements`, are recorded and
+// rasterized, for the cost per element as scenes grow. Two small packages
+// are unpacked first, as a check on the reader rather than a benchmark.
+
+#define BENCH_DEFAULT_VERTICES 10000000
+#define BENCH_DEFAULT_FRAMES 30
+#define BENCH_DEFAULT_ELEMENTS 100000
+
+#define BENCH_FILL_WIDTH 1024
+#define BENCH_FILL_HEIGHT 768
+#define BENCH_FILL_RECTANGLES 300
+
+// Stress scenes are drawn at generateStressScene's default size
+#define BENCH_STRESS_WIDTH 1920
+#define BENCH_STRESS_HEIGHT 1080
+
+// Translucent fills checked in RGB565 against RGBA8 before fills are timed
+#define BENCH_CHECK_FILLS 64
+
+// Package as Python's zipfile streams it to an unseekable file: every
+// local header has flag 0x08 and zero sizes, and a data descriptor follows
+// the data. "images/" is a stored directory, "images/a.txt" is deflated and
+// "manifest.json" is stored.
+static const unsigned char bench_streamed_package[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x69, 0x6d,
+    0x61, 0x67, 0x65, 0x73, 0x2f, 0x50, 0x4b, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00,
+    0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c,
+    0x00, 0x00, 0x00, 0x69, 0x6d, 0x61, 0x67, 0x65, 0x73, 0x2f, 0x61, 0x2e, 0x74, 0x78, 0x74, 0xcb,
+    0x48, 0xcd, 0xc9, 0xc9, 0x57, 0x48, 0xcb, 0x49, 0x2c, 0x4a, 0x55, 0xc8, 0x40, 0xb0, 0x01, 0x50,
+    0x4b, 0x07, 0x08, 0x14, 0x6e, 0x6e, 0x84, 0x10, 0x00, 0x00, 0x00, 0x17, 0x00, 0x00, 0x00, 0x50,
+    0x4b, 0x03, 0x04, 0x14, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x6e,
+    0x69, 0x66, 0x65, 0x73, 0x74, 0x2e, 0x6a, 0x73, 0x6f, 0x6e, 0x7b, 0x22, 0x6e, 0x61, 0x6d, 0x65,
+    0x22, 0x3a, 0x22, 0x66, 0x69, 0x78, 0x74, 0x75, 0x72, 0x65, 0x22, 0x7d, 0x50, 0x4b, 0x07, 0x08,
+    0xbb, 0xab, 0x56, 0x8e, 0x12, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00, 0x50, 0x4b, 0x01, 0x02,
+    0x14, 0x03, 0x14, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x69, 0x6d, 0x61, 0x67, 0x65, 0x73,
+    0x2f, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21,
+    0x00, 0x14, 0x6e, 0x6e, 0x84, 0x10, 0x00, 0x00, 0x00, 0x17, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x35, 0x00, 0x00, 0x00, 0x69,
+    0x6d, 0x61, 0x67, 0x65, 0x73, 0x2f, 0x61, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14,
+    0x03, 0x14, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0xbb, 0xab, 0x56, 0x8e, 0x12,
+    0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x80, 0x01, 0x7f, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x6e, 0x69, 0x66, 0x65, 0x73,
+    0x74, 0x2e, 0x6a, 0x73, 0x6f, 0x6e, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x03, 0x00, 0xaa, 0x00, 0x00, 0x00, 0xcc, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// Package as zipfile writes it to a seekable file: sizes in every local
+// header and no descriptors. "empty.txt" and "last.txt" are empty and
+// stored, so their byte ranges end with their names, and "logo.txt" is
+// deflated.
+static const unsigned char bench_seekable_package[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x42, 0x51, 0x5d, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x65, 0x6d,
+    0x70, 0x74, 0x79, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08,
+    0x00, 0x7a, 0x42, 0x51, 0x5d, 0xff, 0x12, 0x64, 0xc8, 0x07, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+    0x00, 0x08, 0x00, 0x00, 0x00, 0x6c, 0x6f, 0x67, 0x6f, 0x2e, 0x74, 0x78, 0x74, 0x4b, 0xcb, 0x49,
+    0x2c, 0x4a, 0x05, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x42,
+    0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00,
+    0x00, 0x00, 0x6c, 0x61, 0x73, 0x74, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03,
+    0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x42, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x65, 0x6d, 0x70, 0x74, 0x79, 0x2e, 0x74, 0x78,
+    0x74, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x7a, 0x42, 0x51,
+    0x5d, 0xff, 0x12, 0x64, 0xc8, 0x07, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x27, 0x00, 0x00, 0x00, 0x6c,
+    0x6f, 0x67, 0x6f, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x7a, 0x42, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x54, 0x00, 0x00, 0x00, 0x6c, 0x61, 0x73, 0x74, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x05,
+    0x06, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x03, 0x00, 0xa3, 0x00, 0x00, 0x00, 0x7a, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+};
+
+// An entry of a check package and its contents
+typedef struct {
+    const char* name;
+    const char* contents;
+} BenchPackageEntry;
+
+// A package to unpack before timing. Read straight through from the start,
+// the first `readable` entries can be found to end.
+typedef struct {
+    const char* label;
+    const unsigned char* data;
+    unsigned int size;
+    const BenchPackageEntry* entries;
+    int count;
+    int readable;
+} BenchPackage;
+
+static const BenchPackageEntry bench_streamed_entries[] = {
+    { "images/a.txt", "hello flare hello flare" },
+    { "manifest.json", "{\"name\":\"fixture\"}" }
+};
+
+static const BenchPackageEntry bench_seekable_entries[] = {
+    { "empty.txt", "" },
+    { "logo.txt", "flare" },
+    { "last.txt", "" }
+};
+
+// The stored manifest of the streamed package can only be found to end
+// with the central directory's sizes
+static const BenchPackage bench_packages[] = {
+    { "streamed", bench_streamed_package, sizeof(bench_streamed_package), bench_streamed_entries, 2, 1 },
+    { "seekable", bench_seekable_package, sizeof(bench_seekable_package), bench_seekable_entries, 3, 3 }
+};
+
+// Reference: plain loops, with the bounds in a second pass
+static void transform_reference(const float* m, const float* xs, const float* ys,
+                                float* out_xs, float* out_ys, int count, VertexBounds* bounds) {
+    int i;
+    for (i = 0; i < count; i++) {
+        float x = xs[i], y = ys[i];
+        out_xs[i] = m[0] * x + m[2] * y + m[4];
+        out_ys[i] = m[1] * x + m[3] * y + m[5];
+    }
+
+    bounds->min_x = bounds->min_y = INFINITY;
+    bounds->max_x = bounds->max_y = -INFINITY;
+    for (i = 0; i < count; i++) {
+        if (out_xs[i] < bounds->min_x) bounds->min_x = out_xs[i];
+        if (out_ys[i] < bounds->min_y) bounds->min_y = out_ys[i];
+        if (out_xs[i] > bounds->max_x) bounds->max_x = out_xs[i];
+        if (out_ys[i] > bounds->max_y) bounds->max_y = out_ys[i];
+    }
+}
+
+static void frame_transform(int frame, float* m) {
+    float angle = frame * 0.05f;
+    float scale = 1.0f + 0.01f * frame;
+    m[0] = cosf(angle) * scale;
+    m[1] = sinf(angle) * scale;
+    m[2] = -m[1];
+    m[3] = m[0];
+    m[4] = 400.0f + frame;
+    m[5] = 300.0f - frame;
+}
+
+// Rasterize `frames` frames of the list in each format
+static int bench_fill(DrawListHandle list, const char* label, int frames) {
+    static const char* names[] = { "rgba8", "bgra8", "rgb565", "a8" };
+    Framebuffer framebuffer;
+    double start, ms;
+    int format, frame;
+
+    for (format = PIXEL_RGBA8; format <= PIXEL_A8; format++) {
+        if (framebuffer_init_format(&framebuffer, BENCH_FILL_WIDTH, BENCH_FILL_HEIGHT, format) != 0) {
+            fprintf(stderr, "flare_bench: out of memory for a %s framebuffer\n", names[format]);
+            return -1;
+        }
+
+        start = emscripten_get_now();
+        for (frame = 0; frame < frames; frame++) {
+            raster_clear(&framebuffer, 0);
+            raster_draw_list(&framebuffer, list, NULL);
+        }
+        ms = (emscripten_get_now() - start) / frames;
+        printf("  %-12s %-6s %8.2f ms/frame\n", label, names[format], ms);
+        framebuffer_release(&framebuffer);
+    }
+    return 0;
+}
+
+// Largest difference between two RGBA8 framebuffers' color channels
+static int max_channel_difference(const Framebuffer* a, const Framebuffer* b) {
+    const unsigned int* pa = (const unsigned int*)a->pixels;
+    const unsigned int* pb = (const unsigned int*)b->pixels;
+    int i, shift, worst = 0;
+
+    for (i = 0; i < a->width * a->height; i++) {
+        for (shift = 0; shift < 24; shift += 8) {
+            int difference = abs((int)((pa[i] >> shift) & 0xffu) - (int)((pb[i] >> shift) & 0xffu));
+            if (difference > worst) worst = difference;
+        }
+    }
+    return worst;
+}
+
+// Fill an RGB565 framebuffer with `color` over and over. Every fill must be
+// RGBA8's blend of the same pixels, rounded to RGB565. After the last, the
+// result must be within `tolerance` of doing every fill in RGBA8, unless
+// it's negative: fills that move a pixel by less than half an RGB565 step
+// leave it alone, so faint enough fills stop short of RGBA8's result.
+static int check_fill_rgb565(unsigned int background, unsigned int color, int tolerance) {
+    Framebuffer fill, step, expected, exact;
+    int i, result = -1;
+
+    if (framebuffer_init_format(&fill, 4, 1, PIXEL_RGB565) != 0 ||
+        framebuffer_init_format(&step, 4, 1, PIXEL_RGBA8) != 0 ||
+        framebuffer_init_format(&expected, 4, 1, PIXEL_RGB565) != 0 ||
+        framebuffer_init_format(&exact, 4, 1, PIXEL_RGBA8) != 0) {
+        fprintf(stderr, "flare_bench: out of memory for the fill check\n");
+        return -1;
+    }
+
+    raster_clear(&fill, background);
+    raster_clear(&exact, background);
+    for (i = 0; i < BENCH_CHECK_FILLS; i++) {
+        raster_blit(&fill, &step);
+        raster_fill_rect(&step, 0, 0, 4, 1, color);
+        raster_blit(&step, &expected);
+        raster_fill_rect(&fill, 0, 0, 4, 1, color);
+        raster_fill_rect(&exact, 0, 0, 4, 1, color);
+        if (memcmp(fill.pixels, expected.pixels, 4 * sizeof(unsigned short)) != 0) break;
+    }
+
+    if (i == BENCH_CHECK_FILLS) {
+        raster_blit(&fill, &step);
+        if (tolerance < 0 || max_channel_difference(&step, &exact) <= tolerance) result = 0;
+    }
+    if (result != 0) {
+        fprintf(stderr, "flare_bench: rgb565 fills of %08x over %08x disagree with rgba8\n", color, background);
+    }
+
+    framebuffer_release(&fill);
+    framebuffer_release(&step);
+    framebuffer_release(&expected);
+    framebuffer_release(&exact);
+    return result;
+}
+
+// Push archive bytes [start, end) a byte at a time, so every record
+// straddles a chunk boundary, and check the entries it should complete
+static int check_package_range(HeapHandle heap, PackageReaderHandle reader, const BenchPackage* package,
+                               unsigned int start, unsigned int end, int first, int count) {
+    PackageStatus status = PACKAGE_OK;
+    unsigned int pos;
+    int i;
+
+    for (pos = start; pos < end && status != PACKAGE_ERROR; pos++) {
+        status = package_reader_push(reader, package->data + pos, 1);
+    }
+    if (status == PACKAGE_ERROR) {
+        fprintf(stderr, "flare_bench: %s package failed: %s\n", package->label, package_reader_error(reader));
+        return -1;
+    }
+    if (package_entry_count(reader) != count) {
+        fprintf(stderr, "flare_bench: %s package has %d entries\n", package->label, package_entry_count(reader));
+        return -1;
+    }
+
+    for (i = first; i < first + count; i++) {
+        const char* contents = package->entries[i].contents;
+        unsigned int size = (unsigned int)strlen(contents);
+        int entry = package_find_entry(reader, package->entries[i].name);
+        const void* data = entry < 0 || size == 0 ? contents : heap_ptr(heap, package_entry_offset(reader, entry), size);
+
+        // Empty entries have no allocation
+        if (entry < 0 || !data || package_entry_size(reader, entry) != size || memcmp(data, contents, size) != 0) {
+            fprintf(stderr, "flare_bench: %s package entry %s unpacked wrong\n", package->label, package->entries[i].name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Unpack a package entry by entry through its central directory, as
+// openPackage does, then straight through from the start as far as it can
+// be read that way
+static int check_package(const BenchPackage* package) {
+    HeapHandle heap = heap_create(4096);
+    PackageIndexHandle index = NULL;
+    PackageReaderHandle reader = NULL;
+    unsigned int range[2], end;
+    int entry, result = -1;
+
+    if (!heap) {
+        fprintf(stderr, "flare_bench: out of memory for the package check\n");
+        return -1;
+    }
+    if (package_locate_directory(package->data, package->size, package->size, range)) {
+        index = package_index_create(package->data + range[0], range[1], range[0]);
+    }
+    if (!index || package_index_count(index) != package->count) {
+        fprintf(stderr, "flare_bench: %s package has no central directory\n", package->label);
+        package_index_destroy(index);
+        heap_destroy(heap);
+        return -1;
+    }
+
+    for (entry = 0; entry < package->count; entry++) {
+        reader = package_reader_create(heap);
+        if (!reader || strcmp(package_index_name(index, entry), package->entries[entry].name) != 0) break;
+        package_reader_expect_sizes(reader, package_index_name(index, entry),
+                                    package_index_compressed_size(index, entry), package_index_size(index, entry));
+        if (check_package_range(heap, reader, package, package_index_range_start(index, entry),
+                                package_index_range_end(index, entry), entry, 1) != 0) break;
+        package_reader_destroy(reader);
+        reader = NULL;
+    }
+
+    if (entry == package->count) {
+        end = package->readable < package->count ? package_index_range_start(index, package->readable) : range[0];
+        reader = package_reader_create(heap);
+        if (reader && check_package_range(heap, reader, package, 0, end, 0, package->readable) == 0) result = 0;
+    }
+
+    package_reader_destroy(reader);
+    package_index_destroy(index);
+    heap_destroy(heap);
+    return result;
+}
+
+// A leaf of a stress scene, as drawn on its first frame
+typedef struct {
+    int circle;
+    float x, y, width, height;      // Radius in width for circles
+    unsigned int color;
+} StressShape;
+
+// mulberry32, as generateStressScene seeds it
+static double stress_random(unsigned int* state) {
+    unsigned int t;
+    *state += 0x6d2b79f5u;
+    t = *state;
+    t = (t ^ (t >> 15)) * (t | 1u);
+    t ^= t + (t ^ (t >> 7)) * (t | 61u);
+    return (t ^ (t >> 14)) / 4294967296.0;
+}
+
+// The leaves of generateStressScene({ elementCount: count, tracksPerElement: 0 })
+// in packages/file-format/src/stress-scene.ts. Random numbers are drawn in
+// the same order, so the shapes are the ones that scene's timeline holds.
+static void generate_stress_shapes(StressShape* shapes, int count) {
+    unsigned int state = 1;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        StressShape* shape = &shapes[i];
+        unsigned int fill;
+
+        shape->circle = stress_random(&state) < 0.5;
+        shape->x = (float)floor(stress_random(&state) * BENCH_STRESS_WIDTH + 0.5);
+        shape->y = (float)floor(stress_random(&state) * BENCH_STRESS_HEIGHT + 0.5);
+        fill = (unsigned int)(stress_random(&state) * 0x1000000);
+        shape->color = 0xff000000u | ((fill >> 16) & 0xffu) | (fill & 0xff00u) | ((fill & 0xffu) << 16);
+
+        if (shape->circle) {
+            shape->width = 2 + (float)floor(stress_random(&state) * 30 + 0.5);
+        } else {
+            shape->width = 4 + (float)floor(stress_random(&state) * 60 + 0.5);
+            shape->height = 4 + (float)floor(stress_random(&state) * 60 + 0.5);
+        }
+    }
+}
+
+// Record and rasterize `frames` frames of a stress scene of `count` elements
+static int bench_stress(DrawListHandle list, int count, int frames) {
+    StressShape* shapes = (StressShape*)calloc((size_t)count, sizeof(StressShape));
+    Framebuffer framebuffer;
+    double start, record_ms = 0, raster_ms = 0;
+    int frame, i;
+
+    if (!shapes || framebuffer_init(&framebuffer, BENCH_STRESS_WIDTH, BENCH_STRESS_HEIGHT) != 0) {
+        fprintf(stderr, "flare_bench: out of memory for %d stress elements\n", count);
+        free(shapes);
+        return -1;
+    }
+    generate_stress_shapes(shapes, count);
+
+    for (frame = 0; frame < frames; frame++) {
+        start = emscripten_get_now();
+        draw_list_reset(list);
+        for (i = 0; i < count; i++) {
+            const StressShape* shape = &shapes[i];
+            if (shape->circle) {
+                draw_list_add_circle(list, shape->x, shape->y, shape->width, shape->color);
+            } else {
+                draw_list_add_rectangle(list, shape->x, shape->y, shape->width, shape->height, shape->color);
+            }
+        }
+        record_ms += emscripten_get_now() - start;
+
+        start = emscripten_get_now();
+        raster_clear(&framebuffer, 0);
+        raster_draw_list(&framebuffer, list, NULL);
+        raster_ms += emscripten_get_now() - start;
+    }
+
+    printf("  %8d elements  record %8.2f ms/frame  raster %8.2f ms/frame  %6.3f us/element\n", count,
+           record_ms / frames, raster_ms / frames, (record_ms + raster_ms) * 1000.0 / frames / count);
+    framebuffer_release(&framebuffer);
+    free(shapes);
+    return 0;
+}
+
+static int bounds_equal(const VertexBounds* a, const VertexBounds* b) {
+    return a->min_x == b->min_x && a->min_y == b->min_y && a->max_x == b->max_x && a->max_y == b->max_y;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_VERTICES;
+    int frames = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_FRAMES;
+    int elements = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_ELEMENTS;
+    float *xs, *ys, *out_xs, *out_ys;
+    double start, kernel_ms, reference_ms;
+    VertexBounds bounds, expected;
+    DrawListHandle list;
+    float m[6];
+    unsigned int seed = 12345;
+    int frame, pass, i;
+
+    if (count <= 0 || frames <= 0 || elements <= 0) {
+        fprintf(stderr, "usage: flare_bench [vertices] [frames] [elements]\n");
+        return 1;
+    }
+
+    xs = (float*)malloc((size_t)count * sizeof(float));
+    ys = (float*)malloc((size_t)count * sizeof(float));
+    out_xs = (float*)malloc((size_t)count * sizeof(float));
+    out_ys = (float*)malloc((size_t)count * sizeof(float));
+    if (!xs || !ys || !out_xs || !out_ys) {
+        fprintf(stderr, "flare_bench: out of memory for %d vertices\n", count);
+        return 1;
+    }
+
+    for (i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        xs[i] = (float)(seed >> 8) / 16777216.0f * 2000.0f - 1000.0f;
+        seed = seed * 1664525u + 1013904223u;
+        ys[i] = (float)(seed >> 8) / 16777216.0f * 2000.0f - 1000.0f;
+    }
+
+    // Both must agree before either is timed
+    frame_transform(0, m);
+    transform_reference(m, xs, ys, out_xs, out_ys, count, &expected);
+    vertex_transform(m, xs, ys, out_xs, out_ys, count, &bounds);
+    if (!bounds_equal(&bounds, &expected)) {
+        fprintf(stderr, "flare_bench: vertex_transform bounds disagree with the reference\n");
+        return 1;
+    }
+
+    start = emscripten_get_now();
+    for (frame = 0; frame < frames; frame++) {
+        frame_transform(frame, m);
+        transform_reference(m, xs, ys, out_xs, out_ys, count, &expected);
+    }
+    reference_ms = (emscripten_get_now() - start) / frames;
+
+    start = emscripten_get_now();
+    for (frame = 0; frame < frames; frame++) {
+        frame_transform(frame, m);
+        vertex_transform(m, xs, ys, out_xs, out_ys, count, &bounds);
+    }
+    kernel_ms = (emscripten_get_now() - start) / frames;
+
+    printf("vertex_transform (simd %s): %d vertices, %d frames\n", flare_simd_enabled() ? "on" : "off", count, frames);
+    printf("  kernel:    %8.2f ms/frame  %8.1f Mvertices/s\n", kernel_ms, count / kernel_ms / 1000.0);
+    printf("  reference: %8.2f ms/frame  %8.1f Mvertices/s\n", reference_ms, count / reference_ms / 1000.0);
+    printf("  bounds: (%.1f, %.1f) - (%.1f, %.1f)\n", bounds.min_x, bounds.min_y, bounds.max_x, bounds.max_y);
+
+    for (i = 0; i < (int)(sizeof(bench_packages) / sizeof(bench_packages[0])); i++) {
+        if (check_package(&bench_packages[i]) != 0) return 1;
+    }
+
+    // Colors are straight-alpha RGBA8 with red in the low byte
+    if (check_fill_rgb565(0xffffffffu, 0x80ffffffu, 0) != 0 ||
+        check_fill_rgb565(0xffffffffu, 0x08ffffffu, 0) != 0 ||
+        check_fill_rgb565(0xffffffffu, 0x04ffffffu, 0) != 0 ||
+        check_fill_rgb565(0xff000000u, 0x80ffffffu, 8) != 0 ||
+        check_fill_rgb565(0xff336699u, 0x802080e0u, 8) != 0 ||
+        check_fill_rgb565(0xffffffffu, 0x402080e0u, 16) != 0 ||
+        check_fill_rgb565(0xff000000u, 0x04ffffffu, -1) != 0 ||
+        check_fill_rgb565(0xff336699u, 0x08000000u, -1) != 0) {
+        return 1;
+    }
+
+    list = draw_list_create();
+    if (!list) {
+        fprintf(stderr, "flare_bench: out of memory for the draw list\n");
+        return 1;
+    }
+    printf("raster fill: %d rectangles on %dx%d, %d frames\n",
+           BENCH_FILL_RECTANGLES, BENCH_FILL_WIDTH, BENCH_FILL_HEIGHT, frames);
+    for (pass = 0; pass < 2; pass++) {
+        unsigned int alpha = pass == 0 ? 0xff000000u : 0x80000000u;
+        draw_list_reset(list);
+        for (i = 0; i < BENCH_FILL_RECTANGLES; i++) {
+            float x, y;
+            seed = seed * 1664525u + 1013904223u;
+            x = (float)(seed >> 8) / 16777216.0f * BENCH_FILL_WIDTH - 100.0f;
+            seed = seed * 1664525u + 1013904223u;
+            y = (float)(seed >> 8) / 16777216.0f * BENCH_FILL_HEIGHT - 100.0f;
+            draw_list_add_rectangle(list, x, y, 300.0f, 200.0f, alpha | (seed & 0x00ffffffu));
+        }
+        if (bench_fill(list, pass == 0 ? "opaque" : "translucent", frames) != 0) return 1;
+    }
+
+    printf("stress scene: %dx%d, %d frames\n", BENCH_STRESS_WIDTH, BENCH_STRESS_HEIGHT, frames);
+    for (i = 1000; i <= elements; i *= 10) {
+        if (bench_stress(list, i, frames) != 0) return 1;
+        if (i > elements / 10) break;
+    }
+    draw_list_destroy(list);
+
+    free(xs);
+    free(ys);
+    free(out_xs);
+    free(out_ys);
+    return 0;
+}
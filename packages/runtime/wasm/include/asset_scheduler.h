@@ -0,0 +1,70 @@
+#ifndef ASSET_SCHEDULER_H
+#define ASSET_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Timeline-aware asset scheduling.
+// Each asset is registered with the frame spans the timeline shows it in.
+// The scheduler hands out assets to fetch and decode in order of their next
+// use relative to the playhead, wrapping around for looping timelines, and
+// counts a deadline miss whenever the playhead reaches an asset that isn't
+// ready yet.
+
+typedef enum {
+    ASSET_PENDING = 0,      // Not requested yet
+    ASSET_LOADING = 1,      // Fetch or decode in flight
+    ASSET_READY = 2,
+    ASSET_FAILED = 3
+} AssetState;
+
+// Opaque pointer to the scheduler structure
+typedef struct AssetScheduler* AssetSchedulerHandle;
+
+// Create a scheduler for a timeline of `duration` frames; looping timelines
+// count the distance to a use past the end from the start again
+AssetSchedulerHandle asset_scheduler_create(int duration, int loop);
+
+// Destroy a scheduler
+void asset_scheduler_destroy(AssetSchedulerHandle scheduler);
+
+// Add an asset. Returns its index, or -1 on error.
+int asset_scheduler_add_asset(AssetSchedulerHandle scheduler);
+
+// Record that an asset is shown for frames [start, end). Returns 0 on success, -1 on error.
+int asset_scheduler_add_use(AssetSchedulerHandle scheduler, int asset, int start, int end);
+
+// Number of assets
+int asset_scheduler_asset_count(AssetSchedulerHandle scheduler);
+
+// First frame an asset is shown on, or -1 if it never is
+int asset_scheduler_first_use(AssetSchedulerHandle scheduler, int asset);
+
+// Frames from `playhead` until an asset is next shown: 0 if it's on screen,
+// -1 if it won't be shown again
+int asset_scheduler_deadline(AssetSchedulerHandle scheduler, int asset, int playhead);
+
+// Asset state (AssetState)
+void asset_scheduler_set_state(AssetSchedulerHandle scheduler, int asset, int state);
+int asset_scheduler_state(AssetSchedulerHandle scheduler, int asset);
+
+// Write up to `max` pending assets due within `horizon` frames of `playhead`
+// to `out`, soonest first. Returns the number written.
+int asset_scheduler_next(AssetSchedulerHandle scheduler, int playhead, int horizon, int* out, int max);
+
+// Move the playhead. Assets on screen that aren't ready count a miss when
+// they first come due and accumulate late frames while they stay missing.
+// Returns the number of new misses.
+int asset_scheduler_advance(AssetSchedulerHandle scheduler, int playhead);
+
+// Statistics
+int asset_scheduler_miss_count(AssetSchedulerHandle scheduler);
+int asset_scheduler_late_frames(AssetSchedulerHandle scheduler);
+int asset_scheduler_count_state(AssetSchedulerHandle scheduler, int state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_SCHEDULER_H
@@ -0,0 +1,157 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Draw lists.
+// A frame's draw calls are recorded here instead of being issued straight
+// to the canvas, so the frame can be handed to another pipeline stage and
+// rasterized or replayed as a whole.
+
+typedef enum {
+    DRAW_RECTANGLE = 0,
+    DRAW_CIRCLE = 1,
+    DRAW_MASK_BEGIN = 2,        // The shapes up to DRAW_MASK_CONTENT form a mask; color holds its DrawMaskMode
+    DRAW_MASK_CONTENT = 3,      // Commands up to DRAW_MASK_END are drawn through the mask
+    DRAW_MASK_END = 4,
+    DRAW_GROUP_BEGIN = 5,       // Commands up to the matching DRAW_GROUP_END are composited together;
+                                // color holds the DrawBlendMode, x the opacity
+    DRAW_GROUP_END = 6,
+    DRAW_BLUR = 7,              // Filters follow their group's DRAW_GROUP_BEGIN, applied in order.
+                                // Blur: width is the standard deviation in pixels
+    DRAW_SHADOW = 8,            // Drop shadow: color, x and y offset, width the blur's standard deviation
+    DRAW_COLOR_MATRIX = 9       // Color matrix: color holds its index among the list's matrices
+} DrawCommandType;
+
+// How a mask's shapes limit what's drawn through it
+typedef enum {
+    DRAW_MASK_ALPHA = 0,        // By coverage times fill alpha
+    DRAW_MASK_CLIP = 1          // By coverage alone; rectangles cut on whole pixels
+} DrawMaskMode;
+
+// How a group is composited onto what's below it. Colors are premultiplied,
+// and every mode but DRAW_BLEND_ADD treats alpha as source-over does.
+typedef enum {
+    DRAW_BLEND_NORMAL = 0,
+    DRAW_BLEND_MULTIPLY = 1,
+    DRAW_BLEND_SCREEN = 2,
+    DRAW_BLEND_OVERLAY = 3,
+    DRAW_BLEND_ADD = 4          // Saturating, like canvas "lighter"; alpha adds up too
+} DrawBlendMode;
+
+// Groups of at most this many shapes that don't overlap are folded into
+// their shapes' colors instead of being composited as a group
+#define DRAW_GROUP_FOLD_LIMIT 8
+
+// Floats in a color matrix: 4 rows of 5, mapping straight-alpha RGBA in
+// 0-1 as SVG's feColorMatrix does, with the offsets in the last column
+#define DRAW_COLOR_MATRIX_SIZE 20
+
+// One recorded draw call. The layout is read directly by the canvas replay
+// in renderer.c, so it's fixed at 32-bit fields.
+typedef struct {
+    unsigned int type;          // DrawCommandType
+    unsigned int color;         // RGBA8 with straight alpha, red in the low byte
+    float x;
+    float y;
+    float width;                // Radius for circles
+    float height;
+    unsigned int tag;           // Element the command draws, 0 for none; used for hit testing
+    unsigned int geometry;      // Geometry id for path caching, 0 for none (see geometry.h)
+    unsigned int version;       // Geometry version
+} DrawCommand;
+
+// 32-bit words per command
+#define DRAW_COMMAND_WORDS 9
+
+// Opaque pointer to the draw list structure
+typedef struct DrawList* DrawListHandle;
+
+// Create an empty draw list
+DrawListHandle draw_list_create(void);
+
+// Destroy a draw list
+void draw_list_destroy(DrawListHandle list);
+
+// Remove every command, keeping the allocation, and clear the tag
+void draw_list_reset(DrawListHandle list);
+
+// Tag the commands recorded from now on
+void draw_list_set_tag(DrawListHandle list, unsigned int tag);
+unsigned int draw_list_tag(DrawListHandle list);
+
+// Give the next command recorded a geometry id and version. Applies to that
+// command only, since the version describes one shape.
+void draw_list_set_geometry(DrawListHandle list, unsigned int geometry, unsigned int version);
+
+// Record commands. Return 0 on success, -1 if out of memory.
+int draw_list_add_rectangle(DrawListHandle list, float x, float y, float width, float height, unsigned int color);
+int draw_list_add_circle(DrawListHandle list, float x, float y, float radius, unsigned int color);
+
+// Masks. Shapes recorded after draw_list_begin_mask make up the mask,
+// commands after draw_list_begin_masked are drawn through it, and
+// draw_list_end_mask goes back to drawing unmasked. Masks don't nest.
+// Return 0 on success, -1 on error.
+int draw_list_begin_mask(DrawListHandle list, int mode);
+int draw_list_begin_masked(DrawListHandle list);
+int draw_list_end_mask(DrawListHandle list);
+
+// Groups. Commands recorded between draw_list_begin_group and the matching
+// draw_list_end_group are composited as one layer at `opacity` (0-1) with a
+// DrawBlendMode, so overlapping children don't show through each other.
+// Groups nest. Groups that can be drawn without isolating them aren't
+// recorded as groups at all: a normal, opaque group is just its commands,
+// a normal group of a few shapes that don't overlap has the opacity folded
+// into their colors, and a transparent or empty group is dropped. Inside a
+// mask's shapes, groups only count when folded. Return 0 on success, -1 on error.
+int draw_list_begin_group(DrawListHandle list, float opacity, int mode);
+int draw_list_end_group(DrawListHandle list);
+
+// Filters for the innermost open group, applied to everything it draws
+// before it's composited. They must come before the group's first command,
+// and make the group be recorded whatever its opacity. A blur's `radius` is
+// its standard deviation, as in CSS blur(). Return 0 on success, -1 on error.
+int draw_list_add_blur(DrawListHandle list, float radius);
+int draw_list_add_shadow(DrawListHandle list, float dx, float dy, float radius, unsigned int color);
+
+// A color matrix filter. The matrix is copied into the list; one added
+// straight after another is composed into it, so any chain of them costs
+// a single pass. Colors are only clamped after the whole chain, not
+// between its matrices. Return 0 on success, -1 on error.
+int draw_list_add_color_matrix(DrawListHandle list, const float* matrix);
+
+// The list's color matrices, DRAW_COLOR_MATRIX_SIZE floats each, indexed
+// by its DRAW_COLOR_MATRIX commands
+int draw_list_matrix_count(DrawListHandle list);
+const float* draw_list_matrices(DrawListHandle list);
+
+// Append already built commands, keeping their tags and geometry. Color
+// matrix commands keep their indices, so they can't come from another list.
+// Returns 0 on success, -1 on error.
+int draw_list_append(DrawListHandle list, const DrawCommand* commands, int count);
+
+// Recorded commands, in order
+int draw_list_count(DrawListHandle list);
+const DrawCommand* draw_list_commands(DrawListHandle list);
+
+// Replace `list`'s commands with a copy of `source`'s. Returns 0 on success, -1 on error.
+int draw_list_copy(DrawListHandle list, DrawListHandle source);
+
+// Tag of the topmost tagged command covering (x, y), or 0. Masked commands
+// only count where their mask covers the point.
+unsigned int draw_list_hit_test(DrawListHandle list, float x, float y);
+
+// Parse a CSS color into RGBA8: hex (#rgb, #rgba, #rrggbb, #rrggbbaa),
+// rgb(), rgba(), hsl(), hsla() or a named color, in any case and with
+// whitespace around it. Functions take comma or space separated arguments,
+// percentages and angle units. Colors that don't parse are opaque black, as
+// canvas leaves fillStyle unchanged from its default for them.
+unsigned int draw_color_parse(const char* color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DRAW_LIST_H
@@ -0,0 +1,33 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Geometry versions.
+// Shapes are identified across frames by a geometry id, so a backend can
+// keep a shape's path (in its local space, before translation) between
+// frames. The table gives each id a version that changes only when the
+// shape's type or size does; a cached path is valid while the version
+// matches. Moving a shape doesn't change its version.
+
+// Opaque pointer to the geometry table structure
+typedef struct GeometryTable* GeometryTableHandle;
+
+// Create an empty table
+GeometryTableHandle geometry_table_create(void);
+
+// Destroy a table
+void geometry_table_destroy(GeometryTableHandle table);
+
+// Version of geometry `id` for a shape of `type` (DrawCommandType) and local
+// size width x height, starting at 1. Returns 0 for id 0 or if out of memory.
+unsigned int geometry_table_version(GeometryTableHandle table, unsigned int id,
+                                    unsigned int type, float width, float height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GEOMETRY_H
@@ -0,0 +1,45 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Arena for package entries.
+// The package reader (package.h) unpacks entries into the arena and hands
+// out byte offsets from its base, never pointers, so they stay valid when
+// the arena grows and moves.
+
+// Offset into a heap; 0 is never handed out and means null
+typedef unsigned int HeapOffset;
+
+// Opaque pointer to the heap structure
+typedef struct Heap* HeapHandle;
+
+// Create an empty heap with room for at least `capacity` bytes
+HeapHandle heap_create(unsigned int capacity);
+
+// Destroy a heap and free its arena
+void heap_destroy(HeapHandle heap);
+
+// Allocate `size` zeroed bytes aligned to `align` (a power of two).
+// The arena grows as needed; offsets stay valid, pointers do not.
+HeapOffset heap_alloc(HeapHandle heap, unsigned int size, unsigned int align);
+
+// Copy a NUL-terminated string into the heap
+HeapOffset heap_strdup(HeapHandle heap, const char* str);
+
+// Resolve an offset to a pointer to `size` allocated bytes; NULL for
+// offset 0 or a span that runs past what's allocated
+void* heap_ptr(HeapHandle heap, HeapOffset offset, unsigned int size);
+
+// Bytes in use, offset 0 included, and the arena they start at. The base
+// moves when the arena grows.
+unsigned int heap_used(HeapHandle heap);
+const unsigned char* heap_base(HeapHandle heap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HEAP_H
@@ -0,0 +1,62 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming DEFLATE (RFC 1951) decoder.
+// Input can arrive in chunks of any size; the decoder keeps the few bytes of
+// a symbol or block header split across chunks, never the whole stream.
+// Output goes straight into a caller-owned buffer that also serves as the
+// back-reference window, so nothing is copied twice.
+
+typedef enum {
+    INFLATE_OK = 0,             // All input consumed, more is needed
+    INFLATE_DONE = 1,           // Final block decoded
+    INFLATE_NEED_OUTPUT = 2,    // Output buffer full; see inflate_set_output
+    INFLATE_ERROR = -1
+} InflateStatus;
+
+// Most bytes inflate_leftover can return
+#define INFLATE_MAX_LEFTOVER 1024
+
+// Opaque pointer to the decoder structure
+typedef struct Inflater* InflateHandle;
+
+// Create a decoder
+InflateHandle inflate_create(void);
+
+// Destroy a decoder
+void inflate_destroy(InflateHandle inflater);
+
+// Start a new stream writing into `out` (`capacity` bytes)
+void inflate_reset(InflateHandle inflater, unsigned char* out, unsigned int capacity);
+
+// Point the decoder at a new output buffer holding the bytes written so far,
+// e.g. after the old one was reallocated or moved
+void inflate_set_output(InflateHandle inflater, unsigned char* out, unsigned int capacity);
+
+// Feed the next chunk of compressed data
+InflateStatus inflate_push(InflateHandle inflater, const unsigned char* in, unsigned int size);
+
+// Bytes of the last pushed chunk that were used. Less than the chunk size
+// after INFLATE_DONE (the rest follows the stream) or INFLATE_NEED_OUTPUT
+// (push the rest again once there is room).
+unsigned int inflate_consumed(InflateHandle inflater);
+
+// After INFLATE_DONE: bytes past the end of the stream that had already been
+// taken from earlier chunks. They come before the unconsumed part of the last chunk.
+unsigned int inflate_leftover(InflateHandle inflater, const unsigned char** data);
+
+// Bytes written to the output so far
+unsigned int inflate_output_size(InflateHandle inflater);
+
+// Description of the last error
+const char* inflate_error(InflateHandle inflater);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INFLATE_H
@@ -0,0 +1,105 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "draw_list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Input event ring and interaction dispatch.
+// DOM listeners append pointer and keyboard events to a ring in linear
+// memory without calling into the module; the ring is single-producer/
+// single-consumer and lock-free like spsc.h, so the listeners may run on a
+// different thread from the one draining it. Once per tick the core drains
+// the ring, hit-tests pointer events against the frame on screen and turns
+// them into a batch of interactions.
+//
+// The JS producer writes through heap views, so the layout is fixed: head
+// at byte 0, tail at 64, dropped at 68, events from 128, 16 bytes each.
+
+#define INPUT_RING_CAPACITY 256         // Power of two
+
+typedef enum {
+    INPUT_POINTER_DOWN = 1,
+    INPUT_POINTER_UP = 2,
+    INPUT_POINTER_MOVE = 3,
+    INPUT_POINTER_LEAVE = 4,
+    INPUT_POINTER_CANCEL = 5,
+    INPUT_KEY_DOWN = 6,
+    INPUT_KEY_UP = 7
+} InputEventType;
+
+// One DOM event
+typedef struct {
+    unsigned int type;          // InputEventType
+    float x;                    // Canvas pixels
+    float y;
+    unsigned int detail;        // Pressed buttons for pointer events, key code for keys
+} InputEvent;
+
+typedef struct {
+    unsigned int head;          // Next event to drain, written by the consumer
+    char pad0[60];
+    unsigned int tail;          // Next free slot, written by the producer
+    unsigned int dropped;       // Events lost to a full ring, written by the producer
+    char pad1[56];
+    InputEvent events[INPUT_RING_CAPACITY];
+} InputRing;
+
+// Interactions, numbered to match the trigger types they fire
+typedef enum {
+    INTERACTION_CLICK = 0,
+    INTERACTION_HOVER = 1,
+    INTERACTION_DRAG_START = 2,
+    INTERACTION_DRAG_END = 3,
+    INTERACTION_KEY_DOWN = 4,
+    INTERACTION_KEY_UP = 5
+} InteractionType;
+
+// One interaction to dispatch. 5 32-bit words, read directly by JS.
+typedef struct {
+    unsigned int type;          // InteractionType
+    unsigned int tag;           // Element hit (see renderer_set_tag), 0 for key events
+    float x;
+    float y;
+    unsigned int detail;        // As in InputEvent
+} Interaction;
+
+// A drained event yields at most two interactions (hover and drag start)
+#define INPUT_BATCH_CAPACITY (INPUT_RING_CAPACITY * 2)
+
+// Pointer movement, in canvas pixels, that turns a press into a drag
+#define INPUT_DRAG_THRESHOLD 4.0f
+
+// Opaque pointer to the dispatcher structure
+typedef struct InputDispatcher* InputDispatcherHandle;
+
+// Create and destroy an empty ring
+InputRing* input_ring_create(void);
+void input_ring_destroy(InputRing* ring);
+
+// Producer side, for native callers; JS writes the ring directly. Returns 0
+// if the ring is full, in which case the event is counted as dropped.
+int input_ring_push(InputRing* ring, int type, float x, float y, unsigned int detail);
+
+// Events lost to a full ring so far
+int input_ring_dropped(InputRing* ring);
+
+// Create and destroy a dispatcher, which tracks hover, press and drag state
+InputDispatcherHandle input_dispatcher_create(void);
+void input_dispatcher_destroy(InputDispatcherHandle dispatcher);
+
+// Drain every event in the ring and hit-test it against `hits` (usually
+// renderer_presented_list). Runs of pointer moves collapse to the last one.
+// Returns the number of interactions in the batch, or -1 on error.
+int input_dispatch(InputDispatcherHandle dispatcher, InputRing* ring, DrawListHandle hits);
+
+// The batch from the last input_dispatch
+const Interaction* input_dispatcher_batch(InputDispatcherHandle dispatcher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_H
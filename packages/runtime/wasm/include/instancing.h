@@ -0,0 +1,92 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Animation instancing.
+// A symbol holds a single immutable copy of its tracks. Each instance only
+// carries a time offset, a playback rate and a root transform, and every
+// instance of a symbol is evaluated in one pass into structure-of-arrays
+// output channels (one float per instance per channel).
+
+// Tracks a symbol can animate
+typedef enum {
+    SYMBOL_TRACK_X = 0,
+    SYMBOL_TRACK_Y,
+    SYMBOL_TRACK_ROTATION,      // Degrees
+    SYMBOL_TRACK_SCALE_X,
+    SYMBOL_TRACK_SCALE_Y,
+    SYMBOL_TRACK_OPACITY,
+    SYMBOL_TRACK_COUNT
+} SymbolTrack;
+
+// Easing applied from a keyframe to the next one
+typedef enum {
+    SYMBOL_EASE_LINEAR = 0,
+    SYMBOL_EASE_IN,
+    SYMBOL_EASE_OUT,
+    SYMBOL_EASE_IN_OUT,
+    SYMBOL_EASE_STEP
+} SymbolEasing;
+
+// Output channels: world transform as (a b c d e f), then opacity
+typedef enum {
+    SYMBOL_OUT_A = 0,
+    SYMBOL_OUT_B,
+    SYMBOL_OUT_C,
+    SYMBOL_OUT_D,
+    SYMBOL_OUT_E,
+    SYMBOL_OUT_F,
+    SYMBOL_OUT_OPACITY,
+    SYMBOL_OUT_COUNT
+} SymbolOutput;
+
+// Opaque pointer to the symbol structure
+typedef struct Symbol* SymbolHandle;
+
+// Create a symbol whose tracks run for `duration` frames; looping symbols
+// wrap instance time, others hold the last keyframe
+SymbolHandle symbol_create(float duration, int loop);
+
+// Destroy a symbol along with its tracks and instances
+void symbol_destroy(SymbolHandle symbol);
+
+// Copy keyframes into a track. `frames` must be ascending; `easings` may be
+// NULL for linear. Returns 0 on success, -1 on error.
+int symbol_set_track(SymbolHandle symbol, int track,
+                     const float* frames, const float* values,
+                     const unsigned char* easings, int count);
+
+// Add an instance; `root_transform` is (a b c d e f) or NULL for identity.
+// Returns the instance index, or -1 on error.
+int symbol_add_instance(SymbolHandle symbol, float time_offset, float rate,
+                        const float* root_transform);
+
+// Update an existing instance. Returns 0 on success, -1 on error.
+int symbol_set_instance(SymbolHandle symbol, int index, float time_offset, float rate,
+                        const float* root_transform);
+
+// Remove an instance; the last instance moves into its index
+void symbol_remove_instance(SymbolHandle symbol, int index);
+
+// Number of instances
+int symbol_instance_count(SymbolHandle symbol);
+
+// Evaluate every instance at timeline frame `time`
+void symbol_evaluate(SymbolHandle symbol, float time);
+
+// Evaluate instances [first, first + count) only. `first` must be a multiple
+// of 4; disjoint ranges may be evaluated on different threads at once.
+void symbol_evaluate_range(SymbolHandle symbol, float time, int first, int count);
+
+// Output channel from the last evaluation (symbol_instance_count floats).
+// Valid until the next instance is added.
+const float* symbol_output(SymbolHandle symbol, int channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSTANCING_H
@@ -0,0 +1,58 @@
+#ifndef LAYERS_H
+#define LAYERS_H
+
+#include "draw_list.h"
+#include "instancing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layer stacks.
+// A layer draws one shape per instance of an instanced symbol (see
+// instancing.h), placed and scaled by the instance's world transform and
+// faded by its opacity. Layers are independent until they're stacked, so a
+// stack evaluates them, and large layers in chunks, in parallel on a thread
+// pool. Every instance writes its own slot, and the slots are merged into
+// the draw list in layer order afterwards, so the result is the same
+// whichever thread evaluated what.
+//
+// Draw commands are axis-aligned, so instance rotation isn't drawn yet;
+// the scale is taken from the length of the transform's axes.
+
+// Instances evaluated per task; a multiple of 4, as symbol_evaluate_range needs
+#define LAYER_CHUNK_INSTANCES 2048
+
+// Opaque pointer to the layer stack structure
+typedef struct LayerStack* LayerStackHandle;
+
+// Create an empty stack. In threaded builds, stacks share a pool of up to
+// THREAD_POOL_MAX_WORKERS worker threads; evaluate them from one thread.
+LayerStackHandle layer_stack_create(void);
+
+// Destroy a stack. Its symbols belong to the caller and aren't destroyed.
+void layer_stack_destroy(LayerStackHandle stack);
+
+// Add a layer on top of the others. `shape` is a DrawCommandType; `width`
+// and `height` are the rectangle size, or the circle radius in `width`.
+// `color` is RGBA8 with straight alpha and `tag` is copied to every command
+// (0 for none). A symbol can back only one layer of a stack, since layers
+// are evaluated concurrently. Returns the layer index, or -1 on error.
+int layer_stack_add(LayerStackHandle stack, SymbolHandle symbol, int shape,
+                    float width, float height, unsigned int color, unsigned int tag);
+
+// Number of layers
+int layer_stack_count(LayerStackHandle stack);
+
+// Threads evaluating alongside the caller
+int layer_stack_workers(LayerStackHandle stack);
+
+// Evaluate every layer at timeline frame `time` and append its commands to
+// `list`, bottom layer first. Returns 0 on success, -1 on error.
+int layer_stack_evaluate(LayerStackHandle stack, float time, DrawListHandle list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAYERS_H
@@ -0,0 +1,101 @@
+#ifndef PACKAGE_H
+#define PACKAGE_H
+
+#include "heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Readers for ZIP-based .flare packages.
+// The streaming reader takes the archive in chunks as it downloads. Each entry is read from
+// its local header and inflated straight into a heap allocation of its final
+// size, so neither the archive nor a compressed entry is ever buffered whole.
+// Stored (0) and deflated (8) entries are supported; encrypted and ZIP64
+// entries are rejected. A stored entry streamed with a data descriptor
+// needs its sizes registered from the central directory, unless it's a
+// directory. CRC-32 and SHA-256 are computed chunk by chunk as
+// each entry is written, so verifying an entry needs no second pass.
+
+typedef enum {
+    PACKAGE_OK = 0,         // Chunk consumed, more is expected
+    PACKAGE_DONE = 1,       // Reached the central directory; later bytes are ignored
+    PACKAGE_ERROR = -1
+} PackageStatus;
+
+// Opaque pointer to the reader structure
+typedef struct PackageReader* PackageReaderHandle;
+
+// Create a reader that allocates entry data in `heap`
+PackageReaderHandle package_reader_create(HeapHandle heap);
+
+// Destroy a reader. Entry data stays in the heap.
+void package_reader_destroy(PackageReaderHandle reader);
+
+// Require the entry called `name` to have this SHA-256 digest (32 bytes).
+// A mismatch fails the push that completes the entry, so it never reaches
+// the entry table. Returns 0 if out of memory.
+int package_reader_expect(PackageReaderHandle reader, const char* name, const unsigned char* digest);
+
+// Give the entry called `name` the sizes its central directory record
+// declares. Entries streamed with a data descriptor leave them zero in their
+// local header, and stored data can't otherwise be told where it ends.
+// Returns 0 if out of memory.
+int package_reader_expect_sizes(PackageReaderHandle reader, const char* name,
+                                unsigned int compressed_size, unsigned int size);
+
+// Feed the next chunk of the archive
+PackageStatus package_reader_push(PackageReaderHandle reader, const unsigned char* data, unsigned int size);
+
+// Description of the last error
+const char* package_reader_error(PackageReaderHandle reader);
+
+// Entries completed so far, in archive order. Directories are skipped.
+int package_entry_count(PackageReaderHandle reader);
+const char* package_entry_name(PackageReaderHandle reader, int index);
+HeapOffset package_entry_offset(PackageReaderHandle reader, int index);
+unsigned int package_entry_size(PackageReaderHandle reader, int index);
+
+// SHA-256 digest (32 bytes) of an entry's data, computed as it was unpacked
+const unsigned char* package_entry_digest(PackageReaderHandle reader, int index);
+
+// Index of the entry called `name`, or -1
+int package_find_entry(PackageReaderHandle reader, const char* name);
+
+// Central directory index for random access.
+// Read the archive's tail, locate the directory, then fetch and index it.
+// Each entry can then be fetched on its own by byte range and pushed
+// into a PackageReader, which unpacks it like any streamed entry.
+
+// Opaque pointer to the index structure
+typedef struct PackageIndex* PackageIndexHandle;
+
+// Find the end-of-central-directory record in the last `tail_size` bytes of
+// an archive of `archive_size` bytes. Writes the directory's offset and size
+// to range[0] and range[1] and returns 1, or returns 0 if there is none.
+int package_locate_directory(const unsigned char* tail, unsigned int tail_size, unsigned int archive_size, unsigned int* range);
+
+// Index a central directory that starts at `directory_offset` in the archive
+PackageIndexHandle package_index_create(const unsigned char* directory, unsigned int size, unsigned int directory_offset);
+
+// Destroy an index
+void package_index_destroy(PackageIndexHandle index);
+
+// Entries in directory order. Directories are skipped.
+int package_index_count(PackageIndexHandle index);
+const char* package_index_name(PackageIndexHandle index, int entry);
+unsigned int package_index_size(PackageIndexHandle index, int entry);
+unsigned int package_index_compressed_size(PackageIndexHandle index, int entry);
+
+// Index of the entry called `name`, or -1
+int package_index_find(PackageIndexHandle index, const char* name);
+
+// Byte range [start, end) of an entry's local header, data and descriptor
+unsigned int package_index_range_start(PackageIndexHandle index, int entry);
+unsigned int package_index_range_end(PackageIndexHandle index, int entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACKAGE_H
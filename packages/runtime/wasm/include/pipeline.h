@@ -0,0 +1,85 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "draw_list.h"
+#include "raster.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Three-stage frame pipeline: evaluate, rasterize, present.
+// Frames travel as packets (a draw list plus a framebuffer) through
+// lock-free single-producer/single-consumer queues. The caller records
+// frame N+1 while a worker thread rasterizes frame N, and the caller
+// presents frame N-1 when it submits. Three packets are in rotation, so
+// the framebuffers are triple-buffered.
+//
+// Only threaded builds (-pthread) have a worker. Elsewhere rasterization
+// runs inline at submit, and every frame is presented as it's submitted.
+
+#define PIPELINE_PACKETS 3
+
+// PixelFormat frames are rasterized in, picked at build time. Builds for
+// 16-bit displays set PIXEL_RGB565 to halve the bytes each frame writes.
+#ifndef FLARE_PIXEL_FORMAT
+#define FLARE_PIXEL_FORMAT PIXEL_RGBA8
+#endif
+
+// A frame in flight
+typedef struct {
+    int frame;                  // Submission sequence number
+    DrawListHandle list;
+    Framebuffer framebuffer;    // In FLARE_PIXEL_FORMAT, with straight alpha once rasterized;
+                                // empty unless rasterizing
+} FramePacket;
+
+// Called on the submitting thread with each frame to show
+typedef void (*FramePresentCallback)(void* context, const FramePacket* packet);
+
+// Opaque pointer to the pipeline structure
+typedef struct FramePipeline* FramePipelineHandle;
+
+// Create a pipeline for width x height frames. With `rasterize` unset,
+// packets carry only draw lists and the present callback draws them itself.
+FramePipelineHandle pipeline_create(int width, int height, int rasterize,
+                                    FramePresentCallback present, void* context);
+
+// Destroy a pipeline, stopping its worker
+void pipeline_destroy(FramePipelineHandle pipeline);
+
+// 1 when the pipeline has a worker thread, which rasterizing pipelines use
+int pipeline_threaded(FramePipelineHandle pipeline);
+
+// Frames a submitted frame may wait before it's presented, 0 to
+// PIPELINE_PACKETS - 1. Only threaded, rasterizing pipelines delay frames;
+// the others always behave as latency 0. Returns 0 on success, -1 on error.
+int pipeline_set_latency(FramePipelineHandle pipeline, int frames);
+int pipeline_latency(FramePipelineHandle pipeline);
+
+// Switch rasterization on or off once the frames in flight are presented.
+// Returns 0 on success, -1 if the framebuffers can't be allocated.
+int pipeline_set_rasterize(FramePipelineHandle pipeline, int rasterize);
+
+// Resize the framebuffers once the frames in flight are presented.
+// Returns 0 on success, -1 on error.
+int pipeline_resize(FramePipelineHandle pipeline, int width, int height);
+
+// Start recording a frame; returns its emptied draw list. Calling it again
+// before submitting restarts the same frame.
+DrawListHandle pipeline_begin_frame(FramePipelineHandle pipeline);
+
+// Hand the recorded frame on to rasterization, then present the newest
+// finished frame. Waits only if more frames would be in flight than the
+// latency allows.
+void pipeline_submit_frame(FramePipelineHandle pipeline);
+
+// Frames presented, and frames finished but superseded before they could be
+int pipeline_presented_frames(FramePipelineHandle pipeline);
+int pipeline_dropped_frames(FramePipelineHandle pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIPELINE_H
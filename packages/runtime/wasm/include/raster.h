@@ -0,0 +1,111 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "draw_list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Software rasterizer.
+// Framebuffers hold premultiplied RGBA8 by default, one 32-bit pixel per
+// element with red in the low byte, so the bytes are in canvas ImageData
+// order. Shapes are composited source-over with analytic edge coverage.
+//
+// Framebuffers can also be in another PixelFormat. Colors are always
+// worked on as premultiplied RGBA8; each format's fill, composite and
+// blend kernels are specialized for it at compile time, converting only
+// as pixels are loaded and stored, and the framebuffer's format picks
+// which run. Opaque spans are stored without converting each pixel, so a
+// 16-bit framebuffer moves half the bytes of an RGBA8 one. RGB565 pixels
+// are rounded to 5 and 6 bits after each blend, so a fill too faint to move
+// a pixel by half a step leaves it as it was, and many faint layers don't
+// build up as far as they do in RGBA8.
+//
+// Masked commands (see DRAW_MASK_BEGIN) are drawn into an offscreen buffer
+// covering the mask's bounds, then multiplied by the mask's 8-bit coverage
+// as they're composited. Coverage is kept in a raster cache and only
+// rasterized again when the mask's shapes change. A mask that is a single
+// rectangle on whole pixels needs no coverage at all: the masked commands
+// are drawn straight into the framebuffer with their spans narrowed to it.
+//
+// Groups (see DRAW_GROUP_BEGIN) are drawn into an offscreen tile covering
+// their children's bounds and blended onto what's below at the group's
+// opacity, in its blend mode. The cache pools one tile per nesting level,
+// up to four; groups nested deeper are drawn straight onto their parent
+// with the opacity folded into their colors, and lose their blend mode
+// and filters.
+//
+// A group's filters run on its tile before it's blended, and the tile is
+// widened to what they spread the group over. Blurs are three box passes
+// along rows and then columns, with sliding sums, so their cost doesn't
+// depend on the radius. Drop shadows are kept in the cache with the
+// group's commands, and only drawn and blurred again when those change.
+// Color matrices take each pixel's four channels through the matrix as one
+// vector; a chain of them was composed into one as it was recorded. As
+// with the canvas's feColorMatrix, transparent pixels come out as the
+// matrix's offsets, so a matrix with an alpha offset widens its group's
+// tile to the whole framebuffer.
+
+// How a framebuffer stores its pixels
+typedef enum {
+    PIXEL_RGBA8 = 0,            // Premultiplied, red in the low byte
+    PIXEL_BGRA8 = 1,            // Premultiplied, blue in the low byte
+    PIXEL_RGB565 = 2,           // 16 bits, red in the top 5. Opaque: what's drawn is seen over black.
+    PIXEL_A8 = 3                // Alpha alone; masks rasterize their coverage in it
+} PixelFormat;
+
+// Framebuffer; embed it or allocate it, release it with framebuffer_release
+typedef struct {
+    void* pixels;
+    int width;
+    int height;
+    int stride;                 // Pixels per row
+    int format;                 // PixelFormat
+} Framebuffer;
+
+// Bytes per pixel of a PixelFormat, 0 for an unknown one
+int pixel_format_bytes(int format);
+
+// Allocate pixels for a width x height framebuffer, in RGBA8 or in
+// `format`. Returns 0 on success, -1 on error.
+int framebuffer_init(Framebuffer* framebuffer, int width, int height);
+int framebuffer_init_format(Framebuffer* framebuffer, int width, int height, int format);
+
+// Free a framebuffer's pixels
+void framebuffer_release(Framebuffer* framebuffer);
+
+// Premultiply a straight-alpha RGBA8 color
+unsigned int raster_premultiply(unsigned int color);
+
+// Fill every pixel with a premultiplied color
+void raster_clear(Framebuffer* framebuffer, unsigned int color);
+
+// Composite shapes in a straight-alpha RGBA8 color
+void raster_fill_rect(Framebuffer* framebuffer, float x, float y, float width, float height, unsigned int color);
+void raster_fill_circle(Framebuffer* framebuffer, float cx, float cy, float radius, unsigned int color);
+
+// Rasterization state kept from frame to frame. Not thread-safe: one
+// rasterizing thread at a time.
+typedef struct RasterCache* RasterCacheHandle;
+
+RasterCacheHandle raster_cache_create(void);
+void raster_cache_destroy(RasterCacheHandle cache);
+
+// Composite a whole draw list, in order. With no cache, mask coverage is
+// rasterized on every call.
+void raster_draw_list(Framebuffer* framebuffer, DrawListHandle list, RasterCacheHandle cache);
+
+// Convert to straight alpha in place, for handing the pixels to ImageData.
+// Formats without color and alpha both are left as they are.
+void raster_unpremultiply(Framebuffer* framebuffer);
+
+// Copy pixels into a framebuffer of the same size in another format,
+// keeping whether they're premultiplied. Returns 0 on success, -1 on error.
+int raster_blit(const Framebuffer* source, Framebuffer* target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RASTER_H
@@ -1,10 +1,19 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "draw_list.h"
+#include "layers.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// How frames reach the canvas
+typedef enum {
+    RENDERER_BACKEND_CANVAS = 0,    // Draw lists replayed through the Canvas2D API
+    RENDERER_BACKEND_SOFTWARE = 1   // Rasterized natively and copied in with putImageData
+} RendererBackend;
+
 // Opaque pointer to the renderer structure
 typedef struct Renderer* RendererHandle;
 
@@ -14,9 +23,31 @@ RendererHandle renderer_create(int canvas_id, int width, int height);
 // Destroy a renderer and free resources
 void renderer_destroy(RendererHandle renderer);
 
-// Clear the canvas
+// Start a new frame. Draw calls are recorded until renderer_end_frame, which
+// hands the frame to the pipeline (see pipeline.h).
 void renderer_clear(RendererHandle renderer);
 
+// Submit the recorded frame and present the newest finished one
+void renderer_end_frame(RendererHandle renderer);
+
+// Choose the backend (RendererBackend). Threaded builds start out with the
+// software backend, the others with the canvas one. Returns 0 on success, -1 on error.
+int renderer_set_backend(RendererHandle renderer, int backend);
+int renderer_backend(RendererHandle renderer);
+
+// Frames of presentation latency the pipeline may add, 0-2. Returns 0 on success, -1 on error.
+int renderer_set_latency(RendererHandle renderer, int frames);
+
+// 1 when frames are rasterized on a worker thread
+int renderer_threaded(RendererHandle renderer);
+
+// Tag the following draw calls with an element, so input landing on them can
+// be traced back to it. Tags last until the next frame; 0 means untagged.
+void renderer_set_tag(RendererHandle renderer, unsigned int tag);
+
+// The frame currently on screen, for hit testing (see draw_list_hit_test)
+DrawListHandle renderer_presented_list(RendererHandle renderer);
+
 // Draw a rectangle
 void renderer_draw_rectangle(RendererHandle renderer, 
                             double x, double y, 
@@ -29,6 +60,35 @@ void renderer_draw_circle(RendererHandle renderer,
                          double radius, 
                          const char* fill_color);
 
+// Masks (see draw_list_begin_mask). Draw calls after renderer_begin_mask
+// make up the mask (DrawMaskMode), draw calls after renderer_begin_masked
+// are drawn through it, and renderer_end_mask goes back to drawing unmasked.
+void renderer_begin_mask(RendererHandle renderer, int mode);
+void renderer_begin_masked(RendererHandle renderer);
+void renderer_end_mask(RendererHandle renderer);
+
+// Groups (see draw_list_begin_group). Draw calls between renderer_begin_group
+// and the matching renderer_end_group are composited together at `opacity`
+// (0-1) with a DrawBlendMode.
+void renderer_begin_group(RendererHandle renderer, double opacity, int mode);
+void renderer_end_group(RendererHandle renderer);
+
+// Filters for the group just begun (see draw_list_add_blur): a blur, and a
+// drop shadow offset by (x, y), both with `radius` as standard deviation
+void renderer_add_blur(RendererHandle renderer, double radius);
+void renderer_add_shadow(RendererHandle renderer,
+                         double x, double y,
+                         double radius,
+                         const char* color);
+
+// A color matrix filter for the group just begun, DRAW_COLOR_MATRIX_SIZE
+// floats (see draw_list_add_color_matrix)
+void renderer_add_color_matrix(RendererHandle renderer, const float* matrix);
+
+// Evaluate a layer stack at timeline frame `time` into the frame, on top of
+// what's drawn so far. Returns 0 on success, -1 on error.
+int renderer_draw_layers(RendererHandle renderer, LayerStackHandle stack, float time);
+
 // Resize the renderer
 void renderer_resize(RendererHandle renderer, double width, double height);
 
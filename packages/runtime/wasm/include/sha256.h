@@ -0,0 +1,34 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Incremental SHA-256 (FIPS 180-4).
+// Data can be fed in pieces of any size as it arrives, so a digest is ready
+// as soon as the last byte is in.
+
+#define SHA256_DIGEST_SIZE 32
+
+// Hashing state; embed it or allocate it, there is nothing to free
+typedef struct {
+    unsigned int state[8];
+    unsigned int length_low;        // Message length in bytes
+    unsigned int length_high;
+    unsigned char buffer[64];       // Partial block
+    unsigned int buffered;
+} Sha256;
+
+void sha256_init(Sha256* sha);
+void sha256_update(Sha256* sha, const unsigned char* data, unsigned int size);
+void sha256_final(Sha256* sha, unsigned char* digest);
+
+// Hash a whole buffer at once
+void sha256_digest(const unsigned char* data, unsigned int size, unsigned char* digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHA256_H
@@ -0,0 +1,254 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Thin 4-lane vector abstraction shared by all kernels.
+// With -msimd128 these map onto wasm_simd128.h intrinsics; otherwise they
+// fall back to plain scalar loops, so each kernel has a single source.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__wasm_simd128__)
+
+#include <wasm_simd128.h>
+
+#define FLARE_SIMD 1
+
+typedef v128_t f32x4;
+
+static inline f32x4 f32x4_load(const float* p) { return wasm_v128_load(p); }
+static inline void f32x4_store(float* p, f32x4 v) { wasm_v128_store(p, v); }
+static inline f32x4 f32x4_splat(float x) { return wasm_f32x4_splat(x); }
+static inline f32x4 f32x4_make(float a, float b, float c, float d) { return wasm_f32x4_make(a, b, c, d); }
+static inline f32x4 f32x4_add(f32x4 a, f32x4 b) { return wasm_f32x4_add(a, b); }
+static inline f32x4 f32x4_sub(f32x4 a, f32x4 b) { return wasm_f32x4_sub(a, b); }
+static inline f32x4 f32x4_mul(f32x4 a, f32x4 b) { return wasm_f32x4_mul(a, b); }
+static inline f32x4 f32x4_min(f32x4 a, f32x4 b) { return wasm_f32x4_pmin(a, b); }
+static inline f32x4 f32x4_max(f32x4 a, f32x4 b) { return wasm_f32x4_pmax(a, b); }
+
+// Four RGBA8 pixels
+typedef v128_t u32x4;
+
+static inline u32x4 u32x4_load(const unsigned int* p) { return wasm_v128_load(p); }
+static inline void u32x4_store(unsigned int* p, u32x4 v) { wasm_v128_store(p, v); }
+static inline u32x4 u32x4_splat(unsigned int x) { return wasm_i32x4_splat((int)x); }
+static inline u32x4 u32x4_add(u32x4 a, u32x4 b) { return wasm_i32x4_add(a, b); }
+static inline u32x4 u32x4_sub(u32x4 a, u32x4 b) { return wasm_i32x4_sub(a, b); }
+static inline u32x4 u32x4_mul(u32x4 a, u32x4 b) { return wasm_i32x4_mul(a, b); }
+static inline u32x4 u32x4_shr(u32x4 a, int bits) { return wasm_u32x4_shr(a, bits); }
+
+// Lanes rounded toward zero; negative lanes become 0
+static inline u32x4 u32x4_from_f32x4(f32x4 v) { return wasm_u32x4_trunc_sat_f32x4(v); }
+
+// Four bytes, one per lane
+static inline u32x4 u32x4_load_u8(const unsigned char* p) {
+    return wasm_u32x4_extend_low_u16x8(wasm_u16x8_extend_low_u8x16(wasm_v128_load32_zero(p)));
+}
+
+// The low byte of each lane, saturated, packed into one 32-bit value with
+// lane 0 in the low byte; the inverse of u32x4_load_u8
+static inline unsigned int u32x4_pack_u8(u32x4 v) {
+    v128_t words = wasm_i16x8_narrow_i32x4(v, v);
+    return (unsigned int)wasm_i32x4_extract_lane(wasm_u8x16_narrow_i16x8(words, words), 0);
+}
+
+// Multiply each byte of `a` by the matching byte of `b` / 255, rounded.
+// Matches the scalar version bit for bit.
+static inline u32x4 u32x4_mul_bytes(u32x4 a, u32x4 b) {
+    v128_t bias = wasm_i16x8_splat(0x80);
+    v128_t lo = wasm_i16x8_add(wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(a),
+                                              wasm_u16x8_extend_low_u8x16(b)), bias);
+    v128_t hi = wasm_i16x8_add(wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(a),
+                                              wasm_u16x8_extend_high_u8x16(b)), bias);
+    lo = wasm_u16x8_shr(wasm_i16x8_add(lo, wasm_u16x8_shr(lo, 8)), 8);
+    hi = wasm_u16x8_shr(wasm_i16x8_add(hi, wasm_u16x8_shr(hi, 8)), 8);
+    return wasm_u8x16_narrow_i16x8(lo, hi);
+}
+
+// Multiply every byte of each lane by that lane's `scale` (0-255) / 255, rounded
+static inline u32x4 u32x4_scale_bytes(u32x4 pixels, u32x4 scale) {
+    return u32x4_mul_bytes(pixels, wasm_i32x4_mul(scale, wasm_i32x4_splat(0x01010101)));
+}
+
+// Byte-wise saturating add and subtract, and a compare giving 0xff where
+// a <= b and 0 elsewhere
+static inline u32x4 u32x4_adds_bytes(u32x4 a, u32x4 b) { return wasm_u8x16_add_sat(a, b); }
+static inline u32x4 u32x4_subs_bytes(u32x4 a, u32x4 b) { return wasm_u8x16_sub_sat(a, b); }
+static inline u32x4 u32x4_le_bytes(u32x4 a, u32x4 b) { return wasm_u8x16_le(a, b); }
+
+// Bits of `a` where `mask` is set, of `b` elsewhere
+static inline u32x4 u32x4_select(u32x4 mask, u32x4 a, u32x4 b) { return wasm_v128_bitselect(a, b, mask); }
+
+#else
+
+#define FLARE_SIMD 0
+
+typedef struct {
+    float v[4];
+} f32x4;
+
+static inline f32x4 f32x4_load(const float* p) {
+    f32x4 r;
+    r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+    return r;
+}
+
+static inline void f32x4_store(float* p, f32x4 v) {
+    p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3];
+}
+
+static inline f32x4 f32x4_splat(float x) {
+    f32x4 r;
+    r.v[0] = x; r.v[1] = x; r.v[2] = x; r.v[3] = x;
+    return r;
+}
+
+static inline f32x4 f32x4_make(float a, float b, float c, float d) {
+    f32x4 r;
+    r.v[0] = a; r.v[1] = b; r.v[2] = c; r.v[3] = d;
+    return r;
+}
+
+#define FLARE_F32X4_BINARY(name, expr)                      \
+    static inline f32x4 name(f32x4 a, f32x4 b) {            \
+        f32x4 r;                                            \
+        int i;                                              \
+        for (i = 0; i < 4; i++) {                           \
+            float x = a.v[i], y = b.v[i];                   \
+            r.v[i] = (expr);                                \
+        }                                                   \
+        return r;                                           \
+    }
+
+FLARE_F32X4_BINARY(f32x4_add, x + y)
+FLARE_F32X4_BINARY(f32x4_sub, x - y)
+FLARE_F32X4_BINARY(f32x4_mul, x * y)
+FLARE_F32X4_BINARY(f32x4_min, y < x ? y : x)
+FLARE_F32X4_BINARY(f32x4_max, x < y ? y : x)
+
+#undef FLARE_F32X4_BINARY
+
+typedef struct {
+    unsigned int v[4];
+} u32x4;
+
+static inline u32x4 u32x4_load(const unsigned int* p) {
+    u32x4 r;
+    r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+    return r;
+}
+
+static inline void u32x4_store(unsigned int* p, u32x4 v) {
+    p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3];
+}
+
+static inline u32x4 u32x4_splat(unsigned int x) {
+    u32x4 r;
+    r.v[0] = x; r.v[1] = x; r.v[2] = x; r.v[3] = x;
+    return r;
+}
+
+static inline u32x4 u32x4_load_u8(const unsigned char* p) {
+    u32x4 r;
+    r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+    return r;
+}
+
+static inline unsigned int u32x4_pack_u8(u32x4 v) {
+    unsigned int r = 0;
+    int i;
+    for (i = 0; i < 4; i++) r |= (v.v[i] > 255 ? 255 : v.v[i]) << (8 * i);
+    return r;
+}
+
+// One lane of u32x4_scale_bytes, two channels at a time
+static inline unsigned int flare_scale_bytes(unsigned int pixel, unsigned int scale) {
+    unsigned int rb = (pixel & 0x00ff00ffu) * scale + 0x00800080u;
+    unsigned int ag = ((pixel >> 8) & 0x00ff00ffu) * scale + 0x00800080u;
+    rb = ((rb + ((rb >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+    ag = (ag + ((ag >> 8) & 0x00ff00ffu)) & 0xff00ff00u;
+    return rb | ag;
+}
+
+// One lane of u32x4_mul_bytes
+static inline unsigned int flare_mul_bytes(unsigned int a, unsigned int b) {
+    unsigned int r = 0;
+    int shift;
+    for (shift = 0; shift < 32; shift += 8) {
+        unsigned int t = ((a >> shift) & 0xff) * ((b >> shift) & 0xff) + 0x80;
+        r |= ((t + (t >> 8)) >> 8) << shift;
+    }
+    return r;
+}
+
+// One lane of the other byte-wise operations
+#define FLARE_BYTEWISE(name, expr)                                          \
+    static inline unsigned int name(unsigned int a, unsigned int b) {       \
+        unsigned int r = 0;                                                 \
+        int shift;                                                          \
+        for (shift = 0; shift < 32; shift += 8) {                           \
+            unsigned int x = (a >> shift) & 0xff, y = (b >> shift) & 0xff; \
+            r |= (unsigned int)(expr) << shift;                             \
+        }                                                                   \
+        return r;                                                           \
+    }
+
+FLARE_BYTEWISE(flare_adds_bytes, x + y > 255 ? 255 : x + y)
+FLARE_BYTEWISE(flare_subs_bytes, x > y ? x - y : 0)
+FLARE_BYTEWISE(flare_le_bytes, x <= y ? 0xff : 0)
+
+#undef FLARE_BYTEWISE
+
+#define FLARE_U32X4_BINARY(name, expr)                      \
+    static inline u32x4 name(u32x4 a, u32x4 b) {            \
+        u32x4 r;                                            \
+        int i;                                              \
+        for (i = 0; i < 4; i++) {                           \
+            unsigned int x = a.v[i], y = b.v[i];            \
+            r.v[i] = (expr);                                \
+        }                                                   \
+        return r;                                           \
+    }
+
+FLARE_U32X4_BINARY(u32x4_add, x + y)
+FLARE_U32X4_BINARY(u32x4_sub, x - y)
+FLARE_U32X4_BINARY(u32x4_mul, x * y)
+FLARE_U32X4_BINARY(u32x4_mul_bytes, flare_mul_bytes(x, y))
+FLARE_U32X4_BINARY(u32x4_scale_bytes, flare_scale_bytes(x, y))
+FLARE_U32X4_BINARY(u32x4_adds_bytes, flare_adds_bytes(x, y))
+FLARE_U32X4_BINARY(u32x4_subs_bytes, flare_subs_bytes(x, y))
+FLARE_U32X4_BINARY(u32x4_le_bytes, flare_le_bytes(x, y))
+
+#undef FLARE_U32X4_BINARY
+
+static inline u32x4 u32x4_shr(u32x4 a, int bits) {
+    u32x4 r;
+    r.v[0] = a.v[0] >> bits; r.v[1] = a.v[1] >> bits; r.v[2] = a.v[2] >> bits; r.v[3] = a.v[3] >> bits;
+    return r;
+}
+
+static inline u32x4 u32x4_from_f32x4(f32x4 v) {
+    u32x4 r;
+    int i;
+    for (i = 0; i < 4; i++) r.v[i] = v.v[i] > 0 ? (v.v[i] < 4294967040.0f ? (unsigned int)v.v[i] : 0xffffffffu) : 0;
+    return r;
+}
+
+static inline u32x4 u32x4_select(u32x4 mask, u32x4 a, u32x4 b) {
+    u32x4 r;
+    int i;
+    for (i = 0; i < 4; i++) r.v[i] = (a.v[i] & mask.v[i]) | (b.v[i] & ~mask.v[i]);
+    return r;
+}
+
+#endif
+
+// Returns 1 when this module was built with simd128, 0 for the baseline build
+int flare_simd_enabled(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMD_H
@@ -0,0 +1,53 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lock-free single-producer/single-consumer queue of small integers.
+// One thread pushes and one thread pops; neither ever waits on the other.
+// Head and tail sit on separate cache lines so the two sides don't contend.
+
+#define SPSC_CAPACITY 8         // Power of two
+
+typedef struct {
+    unsigned int head;          // Next slot to pop, written by the consumer
+    char pad0[60];
+    unsigned int tail;          // Next slot to push, written by the producer
+    char pad1[60];
+    int slots[SPSC_CAPACITY];
+} SpscQueue;
+
+static inline void spsc_init(SpscQueue* queue) {
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+// Producer side. Returns 0 if the queue is full.
+static inline int spsc_push(SpscQueue* queue, int value) {
+    unsigned int tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    unsigned int head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    if (tail - head == SPSC_CAPACITY) return 0;
+
+    queue->slots[tail & (SPSC_CAPACITY - 1)] = value;
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Consumer side. Returns 0 if the queue is empty.
+static inline int spsc_pop(SpscQueue* queue, int* value) {
+    unsigned int head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    unsigned int tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    if (head == tail) return 0;
+
+    *value = queue->slots[head & (SPSC_CAPACITY - 1)];
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPSC_H
@@ -0,0 +1,43 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fork-join pool for data-parallel work.
+// thread_pool_run hands out task indices to the workers and the calling
+// thread alike and returns once every task has finished, so callers need no
+// synchronization of their own as long as tasks write disjoint memory.
+//
+// Only threaded builds (-pthread) start workers. Elsewhere, or if the
+// workers can't be started, tasks run in order on the calling thread.
+
+// Most workers a pool starts. Each is a pthread from the module's pool, so
+// PTHREAD_POOL_SIZE in CMakeLists.txt must leave room for them.
+#define THREAD_POOL_MAX_WORKERS 3
+
+// Runs task `index` of a batch
+typedef void (*ThreadPoolTask)(void* context, int index);
+
+// Opaque pointer to the pool structure
+typedef struct ThreadPool* ThreadPoolHandle;
+
+// Create a pool with up to `workers` threads besides the caller
+ThreadPoolHandle thread_pool_create(int workers);
+
+// Destroy a pool, stopping its workers
+void thread_pool_destroy(ThreadPoolHandle pool);
+
+// Worker threads actually running
+int thread_pool_workers(ThreadPoolHandle pool);
+
+// Run task(context, i) for every i in [0, count) and wait for all of them.
+// Not reentrant: tasks mustn't run batches on the same pool.
+void thread_pool_run(ThreadPoolHandle pool, ThreadPoolTask task, void* context, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,37 @@
+#ifndef VERTEX_H
+#define VERTEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Vertex transforms.
+// Flattened geometry is kept as structure-of-arrays x and y streams, so a
+// 2D affine transform runs four vertices per instruction. The bounds of the
+// result are gathered in the same pass, so culling and hit testing get them
+// without reading the vertices again.
+
+// Axis-aligned bounds; empty when min > max
+typedef struct {
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+} VertexBounds;
+
+// Transform `count` vertices by (a b c d e f):
+//   x' = a * x + c * y + e
+//   y' = b * x + d * y + f
+// The outputs may be the inputs, for transforming in place, but mustn't
+// otherwise overlap them. `bounds` may be NULL; with no vertices it's set empty.
+void vertex_transform(const float* transform, const float* xs, const float* ys,
+                      float* out_xs, float* out_ys, int count, VertexBounds* bounds);
+
+// Bounds of `count` vertices without transforming them
+void vertex_bounds(const float* xs, const float* ys, int count, VertexBounds* bounds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VERTEX_H
@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <emscripten.h>
+#include "asset_scheduler.h"
+
+// Frames an asset is shown for
+typedef struct {
+    int start;
+    int end;        // Exclusive
+} AssetUse;
+
+// Scheduled asset
+typedef struct {
+    AssetUse* uses;
+    int use_count;
+    int use_capacity;
+    int first_use;
+    int state;
+    int late;       // On screen without being ready as of the last advance
+} Asset;
+
+// Candidate for asset_scheduler_next
+typedef struct {
+    int deadline;
+    int asset;
+} AssetCandidate;
+
+// Scheduler structure
+struct AssetScheduler {
+    int duration;
+    int loop;
+    int playhead;               // As of the last advance
+
+    Asset* assets;
+    int asset_count;
+    int asset_capacity;
+    AssetCandidate* candidates; // Scratch space, one per asset
+
+    int misses;
+    int late_frames;
+};
+
+static int valid_asset(struct AssetScheduler* scheduler, int asset) {
+    return scheduler && asset >= 0 && asset < scheduler->asset_count;
+}
+
+// Frames from `playhead` until the use starts, 0 while it's showing, or -1
+// if it's over and the timeline doesn't loop
+static int use_deadline(struct AssetScheduler* scheduler, const AssetUse* use, int playhead) {
+    if (playhead >= use->start && playhead < use->end) return 0;
+    if (use->start > playhead) return use->start - playhead;
+    return scheduler->loop ? use->start + scheduler->duration - playhead : -1;
+}
+
+static int compare_candidates(const void* a, const void* b) {
+    const AssetCandidate* x = (const AssetCandidate*)a;
+    const AssetCandidate* y = (const AssetCandidate*)b;
+    if (x->deadline != y->deadline) return x->deadline < y->deadline ? -1 : 1;
+    return x->asset < y->asset ? -1 : x->asset > y->asset;
+}
+
+EMSCRIPTEN_KEEPALIVE AssetSchedulerHandle asset_scheduler_create(int duration, int loop) {
+    struct AssetScheduler* scheduler;
+    if (duration <= 0) return NULL;
+
+    scheduler = (struct AssetScheduler*)calloc(1, sizeof(struct AssetScheduler));
+    if (!scheduler) return NULL;
+
+    scheduler->duration = duration;
+    scheduler->loop = loop;
+    return scheduler;
+}
+
+EMSCRIPTEN_KEEPALIVE void asset_scheduler_destroy(AssetSchedulerHandle scheduler) {
+    int i;
+    if (!scheduler) return;
+
+    for (i = 0; i < scheduler->asset_count; i++) free(scheduler->assets[i].uses);
+    free(scheduler->assets);
+    free(scheduler->candidates);
+    free(scheduler);
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_add_asset(AssetSchedulerHandle scheduler) {
+    Asset* asset;
+    if (!scheduler) return -1;
+
+    if (scheduler->asset_count == scheduler->asset_capacity) {
+        int capacity = scheduler->asset_capacity ? scheduler->asset_capacity * 2 : 16;
+        Asset* assets = (Asset*)realloc(scheduler->assets, capacity * sizeof(Asset));
+        AssetCandidate* candidates;
+        if (!assets) return -1;
+        scheduler->assets = assets;
+
+        candidates = (AssetCandidate*)realloc(scheduler->candidates, capacity * sizeof(AssetCandidate));
+        if (!candidates) return -1;
+        scheduler->candidates = candidates;
+        scheduler->asset_capacity = capacity;
+    }
+
+    asset = &scheduler->assets[scheduler->asset_count];
+    asset->uses = NULL;
+    asset->use_count = 0;
+    asset->use_capacity = 0;
+    asset->first_use = -1;
+    asset->state = ASSET_PENDING;
+    asset->late = 0;
+    return scheduler->asset_count++;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_add_use(AssetSchedulerHandle scheduler, int asset, int start, int end) {
+    Asset* entry;
+    if (!valid_asset(scheduler, asset)) return -1;
+
+    // Clamp to the timeline; uses entirely outside it never come due
+    if (start < 0) start = 0;
+    if (end > scheduler->duration) end = scheduler->duration;
+    if (start >= end) return 0;
+
+    entry = &scheduler->assets[asset];
+    if (entry->use_count == entry->use_capacity) {
+        int capacity = entry->use_capacity ? entry->use_capacity * 2 : 4;
+        AssetUse* uses = (AssetUse*)realloc(entry->uses, capacity * sizeof(AssetUse));
+        if (!uses) return -1;
+        entry->uses = uses;
+        entry->use_capacity = capacity;
+    }
+
+    entry->uses[entry->use_count].start = start;
+    entry->uses[entry->use_count].end = end;
+    entry->use_count++;
+    if (entry->first_use < 0 || start < entry->first_use) entry->first_use = start;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_asset_count(AssetSchedulerHandle scheduler) {
+    return scheduler ? scheduler->asset_count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_first_use(AssetSchedulerHandle scheduler, int asset) {
+    if (!valid_asset(scheduler, asset)) return -1;
+    return scheduler->assets[asset].first_use;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_deadline(AssetSchedulerHandle scheduler, int asset, int playhead) {
+    const Asset* entry;
+    int best = -1;
+    int i;
+    if (!valid_asset(scheduler, asset)) return -1;
+
+    entry = &scheduler->assets[asset];
+    for (i = 0; i < entry->use_count; i++) {
+        int deadline = use_deadline(scheduler, &entry->uses[i], playhead);
+        if (deadline >= 0 && (best < 0 || deadline < best)) best = deadline;
+    }
+    return best;
+}
+
+EMSCRIPTEN_KEEPALIVE void asset_scheduler_set_state(AssetSchedulerHandle scheduler, int asset, int state) {
+    if (!valid_asset(scheduler, asset)) return;
+    if (state < ASSET_PENDING || state > ASSET_FAILED) return;
+
+    scheduler->assets[asset].state = state;
+    if (state == ASSET_READY) scheduler->assets[asset].late = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_state(AssetSchedulerHandle scheduler, int asset) {
+    if (!valid_asset(scheduler, asset)) return -1;
+    return scheduler->assets[asset].state;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_next(AssetSchedulerHandle scheduler, int playhead, int horizon, int* out, int max) {
+    int count = 0;
+    int i;
+    if (!scheduler || !out || max <= 0) return 0;
+
+    for (i = 0; i < scheduler->asset_count; i++) {
+        int deadline;
+        if (scheduler->assets[i].state != ASSET_PENDING) continue;
+
+        deadline = asset_scheduler_deadline(scheduler, i, playhead);
+        if (deadline < 0 || deadline > horizon) continue;
+
+        scheduler->candidates[count].deadline = deadline;
+        scheduler->candidates[count].asset = i;
+        count++;
+    }
+
+    // Soonest first; ties go to the earlier asset so the order is stable
+    qsort(scheduler->candidates, count, sizeof(AssetCandidate), compare_candidates);
+    if (count > max) count = max;
+    for (i = 0; i < count; i++) out[i] = scheduler->candidates[i].asset;
+    return count;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_advance(AssetSchedulerHandle scheduler, int playhead) {
+    int elapsed, misses = 0;
+    int i;
+    if (!scheduler) return 0;
+
+    // Frames since the last advance, across the loop point if there is one
+    elapsed = playhead - scheduler->playhead;
+    if (elapsed < 0) elapsed = scheduler->loop ? elapsed + scheduler->duration : 0;
+    scheduler->playhead = playhead;
+
+    for (i = 0; i < scheduler->asset_count; i++) {
+        Asset* asset = &scheduler->assets[i];
+        int missing = asset->state != ASSET_READY && asset_scheduler_deadline(scheduler, i, playhead) == 0;
+
+        if (!missing) {
+            asset->late = 0;
+        } else if (!asset->late) {
+            asset->late = 1;
+            misses++;
+            scheduler->late_frames++;
+        } else {
+            scheduler->late_frames += elapsed;
+        }
+    }
+
+    scheduler->misses += misses;
+    return misses;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_miss_count(AssetSchedulerHandle scheduler) {
+    return scheduler ? scheduler->misses : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_late_frames(AssetSchedulerHandle scheduler) {
+    return scheduler ? scheduler->late_frames : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int asset_scheduler_count_state(AssetSchedulerHandle scheduler, int state) {
+    int count = 0;
+    int i;
+    if (!scheduler) return 0;
+
+    for (i = 0; i < scheduler->asset_count; i++) {
+        if (scheduler->assets[i].state == state) count++;
+    }
+    return count;
+}
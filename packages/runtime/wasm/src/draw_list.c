@@ -0,0 +1,788 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <emscripten.h>
+#include "draw_list.h"
+
+#define DRAW_LIST_INITIAL_CAPACITY 64
+
+// A group being recorded
+typedef struct {
+    int begin;                  // Index of its DRAW_GROUP_BEGIN, or -1 if it isn't recorded
+    int start;                  // Command count when it was opened
+} OpenGroup;
+
+// Draw list structure
+struct DrawList {
+    DrawCommand* commands;
+    int count;
+    int capacity;
+    unsigned int tag;
+    unsigned int geometry;      // For the next command only
+    unsigned int version;
+
+    OpenGroup* groups;
+    int group_count;
+    int group_capacity;
+
+    float* matrices;            // DRAW_COLOR_MATRIX_SIZE floats each
+    int matrix_count;
+    int matrix_capacity;
+};
+
+// Longest color string draw_color_parse reads; CSS colors are far shorter
+#define DRAW_COLOR_MAX_LENGTH 64
+
+typedef struct {
+    const char* name;
+    unsigned int color;
+} NamedColor;
+
+// The CSS named colors, sorted for binary search
+static const NamedColor named_colors[] = {
+    { "aliceblue", 0xfffff8f0u },
+    { "antiquewhite", 0xffd7ebfau },
+    { "aqua", 0xffffff00u },
+    { "aquamarine", 0xffd4ff7fu },
+    { "azure", 0xfffffff0u },
+    { "beige", 0xffdcf5f5u },
+    { "bisque", 0xffc4e4ffu },
+    { "black", 0xff000000u },
+    { "blanchedalmond", 0xffcdebffu },
+    { "blue", 0xffff0000u },
+    { "blueviolet", 0xffe22b8au },
+    { "brown", 0xff2a2aa5u },
+    { "burlywood", 0xff87b8deu },
+    { "cadetblue", 0xffa09e5fu },
+    { "chartreuse", 0xff00ff7fu },
+    { "chocolate", 0xff1e69d2u },
+    { "coral", 0xff507fffu },
+    { "cornflowerblue", 0xffed9564u },
+    { "cornsilk", 0xffdcf8ffu },
+    { "crimson", 0xff3c14dcu },
+    { "cyan", 0xffffff00u },
+    { "darkblue", 0xff8b0000u },
+    { "darkcyan", 0xff8b8b00u },
+    { "darkgoldenrod", 0xff0b86b8u },
+    { "darkgray", 0xffa9a9a9u },
+    { "darkgreen", 0xff006400u },
+    { "darkgrey", 0xffa9a9a9u },
+    { "darkkhaki", 0xff6bb7bdu },
+    { "darkmagenta", 0xff8b008bu },
+    { "darkolivegreen", 0xff2f6b55u },
+    { "darkorange", 0xff008cffu },
+    { "darkorchid", 0xffcc3299u },
+    { "darkred", 0xff00008bu },
+    { "darksalmon", 0xff7a96e9u },
+    { "darkseagreen", 0xff8fbc8fu },
+    { "darkslateblue", 0xff8b3d48u },
+    { "darkslategray", 0xff4f4f2fu },
+    { "darkslategrey", 0xff4f4f2fu },
+    { "darkturquoise", 0xffd1ce00u },
+    { "darkviolet", 0xffd30094u },
+    { "deeppink", 0xff9314ffu },
+    { "deepskyblue", 0xffffbf00u },
+    { "dimgray", 0xff696969u },
+    { "dimgrey", 0xff696969u },
+    { "dodgerblue", 0xffff901eu },
+    { "firebrick", 0xff2222b2u },
+    { "floralwhite", 0xfff0faffu },
+    { "forestgreen", 0xff228b22u },
+    { "fuchsia", 0xffff00ffu },
+    { "gainsboro", 0xffdcdcdcu },
+    { "ghostwhite", 0xfffff8f8u },
+    { "gold", 0xff00d7ffu },
+    { "goldenrod", 0xff20a5dau },
+    { "gray", 0xff808080u },
+    { "green", 0xff008000u },
+    { "greenyellow", 0xff2fffadu },
+    { "grey", 0xff808080u },
+    { "honeydew", 0xfff0fff0u },
+    { "hotpink", 0xffb469ffu },
+    { "indianred", 0xff5c5ccdu },
+    { "indigo", 0xff82004bu },
+    { "ivory", 0xfff0ffffu },
+    { "khaki", 0xff8ce6f0u },
+    { "lavender", 0xfffae6e6u },
+    { "lavenderblush", 0xfff5f0ffu },
+    { "lawngreen", 0xff00fc7cu },
+    { "lemonchiffon", 0xffcdfaffu },
+    { "lightblue", 0xffe6d8adu },
+    { "lightcoral", 0xff8080f0u },
+    { "lightcyan", 0xffffffe0u },
+    { "lightgoldenrodyellow", 0xffd2fafau },
+    { "lightgray", 0xffd3d3d3u },
+    { "lightgreen", 0xff90ee90u },
+    { "lightgrey", 0xffd3d3d3u },
+    { "lightpink", 0xffc1b6ffu },
+    { "lightsalmon", 0xff7aa0ffu },
+    { "lightseagreen", 0xffaab220u },
+    { "lightskyblue", 0xffface87u },
+    { "lightslategray", 0xff998877u },
+    { "lightslategrey", 0xff998877u },
+    { "lightsteelblue", 0xffdec4b0u },
+    { "lightyellow", 0xffe0ffffu },
+    { "lime", 0xff00ff00u },
+    { "limegreen", 0xff32cd32u },
+    { "linen", 0xffe6f0fau },
+    { "magenta", 0xffff00ffu },
+    { "maroon", 0xff000080u },
+    { "mediumaquamarine", 0xffaacd66u },
+    { "mediumblue", 0xffcd0000u },
+    { "mediumorchid", 0xffd355bau },
+    { "mediumpurple", 0xffdb7093u },
+    { "mediumseagreen", 0xff71b33cu },
+    { "mediumslateblue", 0xffee687bu },
+    { "mediumspringgreen", 0xff9afa00u },
+    { "mediumturquoise", 0xffccd148u },
+    { "mediumvioletred", 0xff8515c7u },
+    { "midnightblue", 0xff701919u },
+    { "mintcream", 0xfffafff5u },
+    { "mistyrose", 0xffe1e4ffu },
+    { "moccasin", 0xffb5e4ffu },
+    { "navajowhite", 0xffaddeffu },
+    { "navy", 0xff800000u },
+    { "oldlace", 0xffe6f5fdu },
+    { "olive", 0xff008080u },
+    { "olivedrab", 0xff238e6bu },
+    { "orange", 0xff00a5ffu },
+    { "orangered", 0xff0045ffu },
+    { "orchid", 0xffd670dau },
+    { "palegoldenrod", 0xffaae8eeu },
+    { "palegreen", 0xff98fb98u },
+    { "paleturquoise", 0xffeeeeafu },
+    { "palevioletred", 0xff9370dbu },
+    { "papayawhip", 0xffd5efffu },
+    { "peachpuff", 0xffb9daffu },
+    { "peru", 0xff3f85cdu },
+    { "pink", 0xffcbc0ffu },
+    { "plum", 0xffdda0ddu },
+    { "powderblue", 0xffe6e0b0u },
+    { "purple", 0xff800080u },
+    { "rebeccapurple", 0xff993366u },
+    { "red", 0xff0000ffu },
+    { "rosybrown", 0xff8f8fbcu },
+    { "royalblue", 0xffe16941u },
+    { "saddlebrown", 0xff13458bu },
+    { "salmon", 0xff7280fau },
+    { "sandybrown", 0xff60a4f4u },
+    { "seagreen", 0xff578b2eu },
+    { "seashell", 0xffeef5ffu },
+    { "sienna", 0xff2d52a0u },
+    { "silver", 0xffc0c0c0u },
+    { "skyblue", 0xffebce87u },
+    { "slateblue", 0xffcd5a6au },
+    { "slategray", 0xff908070u },
+    { "slategrey", 0xff908070u },
+    { "snow", 0xfffafaffu },
+    { "springgreen", 0xff7fff00u },
+    { "steelblue", 0xffb48246u },
+    { "tan", 0xff8cb4d2u },
+    { "teal", 0xff808000u },
+    { "thistle", 0xffd8bfd8u },
+    { "tomato", 0xff4763ffu },
+    { "transparent", 0x00000000u },
+    { "turquoise", 0xffd0e040u },
+    { "violet", 0xffee82eeu },
+    { "wheat", 0xffb3def5u },
+    { "white", 0xffffffffu },
+    { "whitesmoke", 0xfff5f5f5u },
+    { "yellow", 0xff00ffffu },
+    { "yellowgreen", 0xff32cd9au }
+};
+
+static int reserve(struct DrawList* list, int capacity) {
+    DrawCommand* commands;
+    if (capacity <= list->capacity) return 0;
+
+    commands = (DrawCommand*)realloc(list->commands, capacity * sizeof(DrawCommand));
+    if (!commands) return -1;
+    list->commands = commands;
+    list->capacity = capacity;
+    return 0;
+}
+
+static DrawCommand* append_command(struct DrawList* list) {
+    DrawCommand* command;
+    if (list->count == list->capacity) {
+        if (reserve(list, list->capacity ? list->capacity * 2 : DRAW_LIST_INITIAL_CAPACITY) != 0) return NULL;
+    }
+
+    command = &list->commands[list->count++];
+    command->tag = list->tag;
+    command->geometry = list->geometry;
+    command->version = list->version;
+    list->geometry = 0;
+    list->version = 0;
+    return command;
+}
+
+// Mask markers belong to no element and carry no geometry
+static int append_marker(struct DrawList* list, unsigned int type, unsigned int value) {
+    DrawCommand* command = append_command(list);
+    if (!command) return -1;
+
+    command->type = type;
+    command->color = value;
+    command->x = 0;
+    command->y = 0;
+    command->width = 0;
+    command->height = 0;
+    command->tag = 0;
+    command->geometry = 0;
+    command->version = 0;
+    return 0;
+}
+
+// Whether a shape covers (x, y)
+static int covers(const DrawCommand* command, float x, float y) {
+    if (command->type == DRAW_CIRCLE) {
+        float dx = x - command->x, dy = y - command->y;
+        return dx * dx + dy * dy <= command->width * command->width;
+    }
+    if (command->type == DRAW_RECTANGLE) {
+        float x0 = command->width < 0 ? command->x + command->width : command->x;
+        float y0 = command->height < 0 ? command->y + command->height : command->y;
+        float w = command->width < 0 ? -command->width : command->width;
+        float h = command->height < 0 ? -command->height : command->height;
+        return x >= x0 && x < x0 + w && y >= y0 && y < y0 + h;
+    }
+    return 0;
+}
+
+// Bounds of a shape, for telling whether shapes overlap
+static void shape_bounds(const DrawCommand* command, float* x0, float* y0, float* x1, float* y1) {
+    if (command->type == DRAW_CIRCLE) {
+        *x0 = command->x - command->width;
+        *y0 = command->y - command->width;
+        *x1 = command->x + command->width;
+        *y1 = command->y + command->width;
+    } else {
+        *x0 = command->width < 0 ? command->x + command->width : command->x;
+        *y0 = command->height < 0 ? command->y + command->height : command->y;
+        *x1 = command->width < 0 ? command->x : command->x + command->width;
+        *y1 = command->height < 0 ? command->y : command->y + command->height;
+    }
+}
+
+// A few shapes that don't overlap look the same drawn one by one with
+// the group's opacity as composited together. Edge pixels can be shared,
+// so the bounds must be a pixel apart.
+static int can_fold(const DrawCommand* commands, int count) {
+    int i, j;
+    if (count > DRAW_GROUP_FOLD_LIMIT) return 0;
+
+    for (i = 0; i < count; i++) {
+        float ax0, ay0, ax1, ay1;
+        if (commands[i].type != DRAW_RECTANGLE && commands[i].type != DRAW_CIRCLE) return 0;
+
+        shape_bounds(&commands[i], &ax0, &ay0, &ax1, &ay1);
+        for (j = 0; j < i; j++) {
+            float bx0, by0, bx1, by1;
+            shape_bounds(&commands[j], &bx0, &by0, &bx1, &by1);
+            if (ax0 < bx1 + 1.0f && bx0 < ax1 + 1.0f && ay0 < by1 + 1.0f && by0 < ay1 + 1.0f) return 0;
+        }
+    }
+    return 1;
+}
+
+static int is_filter(unsigned int type) {
+    return type == DRAW_BLUR || type == DRAW_SHADOW || type == DRAW_COLOR_MATRIX;
+}
+
+static int reserve_matrices(struct DrawList* list, int capacity) {
+    float* matrices;
+    if (capacity <= list->matrix_capacity) return 0;
+
+    matrices = (float*)realloc(list->matrices, (size_t)capacity * DRAW_COLOR_MATRIX_SIZE * sizeof(float));
+    if (!matrices) return -1;
+    list->matrices = matrices;
+    list->matrix_capacity = capacity;
+    return 0;
+}
+
+// `first` then `then`, as one matrix. Each is 4x5, row-major, with the
+// offsets in the last column.
+static void concat_matrices(float* out, const float* first, const float* then) {
+    float result[DRAW_COLOR_MATRIX_SIZE];
+    int row, column, k;
+
+    for (row = 0; row < 4; row++) {
+        for (column = 0; column < 5; column++) {
+            float sum = column == 4 ? then[row * 5 + 4] : 0;
+            for (k = 0; k < 4; k++) sum += then[row * 5 + k] * first[k * 5 + column];
+            result[row * 5 + column] = sum;
+        }
+    }
+    memcpy(out, result, sizeof(result));
+}
+
+// Close the group whose DRAW_GROUP_BEGIN is at `begin`
+static int close_group(struct DrawList* list, int begin) {
+    DrawCommand* commands = list->commands + begin + 1;
+    int count = list->count - begin - 1;
+    float opacity = list->commands[begin].x;
+    int filters = 0;
+    int i;
+
+    while (filters < count && is_filter(commands[filters].type)) filters++;
+
+    // Nothing to see
+    if (count == filters || opacity <= 0) {
+        list->count = begin;
+        return 0;
+    }
+
+    if (list->commands[begin].color == DRAW_BLEND_NORMAL && can_fold(commands, count)) {
+        for (i = 0; i < count; i++) {
+            unsigned int alpha = (unsigned int)((commands[i].color >> 24) * opacity + 0.5f);
+            commands[i].color = (commands[i].color & 0x00ffffffu) | (alpha << 24);
+        }
+        memmove(commands - 1, commands, count * sizeof(DrawCommand));
+        list->count--;
+        return 0;
+    }
+    return append_marker(list, DRAW_GROUP_END, 0);
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static unsigned int pack_color(int r, int g, int b, int a) {
+    return (unsigned int)r | ((unsigned int)g << 8) | ((unsigned int)b << 16) | ((unsigned int)a << 24);
+}
+
+static unsigned int parse_hex(const char* hex) {
+    int digits[8];
+    int length = 0;
+
+    while (length < 8 && hex[length]) {
+        digits[length] = hex_digit(hex[length]);
+        if (digits[length] < 0) return 0xff000000u;
+        length++;
+    }
+    if (hex[length]) return 0xff000000u;
+
+    switch (length) {
+        case 3:
+        case 4:
+            return pack_color(digits[0] * 17, digits[1] * 17, digits[2] * 17,
+                              length == 4 ? digits[3] * 17 : 255);
+        case 6:
+        case 8:
+            return pack_color(digits[0] * 16 + digits[1], digits[2] * 16 + digits[3], digits[4] * 16 + digits[5],
+                              length == 8 ? digits[6] * 16 + digits[7] : 255);
+        default:
+            return 0xff000000u;
+    }
+}
+
+// Arguments of a CSS color function, up to its closing parenthesis, which
+// must end the string. Commas, spaces and a slash before the alpha all
+// separate them. Percentages are flagged and angles converted to degrees.
+// Returns how many there were, or -1 if they don't parse.
+static int parse_arguments(const char* args, double* values, int* percent) {
+    int count = 0;
+
+    while (*args == ' ') args++;
+    while (*args != ')') {
+        char* end;
+        if (count == 4) return -1;
+
+        values[count] = strtod(args, &end);
+        if (end == args || values[count] != values[count]) return -1;
+        percent[count] = 0;
+        args = end;
+
+        if (*args == '%') {
+            percent[count] = 1;
+            args++;
+        } else if (strncmp(args, "deg", 3) == 0) {
+            args += 3;
+        } else if (strncmp(args, "grad", 4) == 0) {
+            values[count] *= 0.9;
+            args += 4;
+        } else if (strncmp(args, "rad", 3) == 0) {
+            values[count] *= 180.0 / 3.14159265358979323846;
+            args += 3;
+        } else if (strncmp(args, "turn", 4) == 0) {
+            values[count] *= 360.0;
+            args += 4;
+        }
+        count++;
+
+        while (*args == ' ' || *args == ',' || *args == '/') args++;
+        if (!*args) return -1;
+    }
+    return args[1] ? -1 : count;
+}
+
+static double clamp_unit(double value) {
+    return value < 0 ? 0 : value > 1 ? 1 : value;
+}
+
+// Alpha as a number in 0-1 or a percentage, opaque when left out
+static int alpha_byte(const double* values, const int* percent, int count) {
+    if (count < 4) return 255;
+    return (int)(clamp_unit(percent[3] ? values[3] / 100 : values[3]) * 255 + 0.5);
+}
+
+// rgb() and rgba(): channels as 0-255 or percentages
+static unsigned int parse_rgb(const char* args) {
+    double values[4];
+    int percent[4], channels[3];
+    int count = parse_arguments(args, values, percent);
+    int i;
+    if (count < 3) return 0xff000000u;
+
+    for (i = 0; i < 3; i++) {
+        channels[i] = (int)(clamp_unit(percent[i] ? values[i] / 100 : values[i] / 255) * 255 + 0.5);
+    }
+    return pack_color(channels[0], channels[1], channels[2], alpha_byte(values, percent, count));
+}
+
+// hsl() and hsla(): hue in degrees, saturation and lightness in percent
+static unsigned int parse_hsl(const char* args) {
+    static const int offsets[3] = { 0, 8, 4 };
+    double values[4], saturation, lightness, chroma;
+    int percent[4], channels[3];
+    int count = parse_arguments(args, values, percent);
+    int i;
+    if (count < 3) return 0xff000000u;
+
+    saturation = clamp_unit(values[1] / 100);
+    lightness = clamp_unit(values[2] / 100);
+    chroma = saturation * (lightness < 1 - lightness ? lightness : 1 - lightness);
+
+    // As CSS Color 4 converts them
+    for (i = 0; i < 3; i++) {
+        double k = fmod(offsets[i] + values[0] / 30, 12);
+        double step;
+        if (k < 0) k += 12;
+        step = k - 3 < 9 - k ? k - 3 : 9 - k;
+        if (step > 1) step = 1;
+        if (step < -1) step = -1;
+        channels[i] = (int)(clamp_unit(lightness - chroma * step) * 255 + 0.5);
+    }
+    return pack_color(channels[0], channels[1], channels[2], alpha_byte(values, percent, count));
+}
+
+static int compare_named_color(const void* name, const void* entry) {
+    return strcmp((const char*)name, ((const NamedColor*)entry)->name);
+}
+
+EMSCRIPTEN_KEEPALIVE DrawListHandle draw_list_create(void) {
+    return (struct DrawList*)calloc(1, sizeof(struct DrawList));
+}
+
+EMSCRIPTEN_KEEPALIVE void draw_list_destroy(DrawListHandle list) {
+    if (!list) return;
+
+    free(list->commands);
+    free(list->groups);
+    free(list->matrices);
+    free(list);
+}
+
+EMSCRIPTEN_KEEPALIVE void draw_list_reset(DrawListHandle list) {
+    if (!list) return;
+
+    list->count = 0;
+    list->tag = 0;
+    list->geometry = 0;
+    list->version = 0;
+    list->group_count = 0;
+    list->matrix_count = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void draw_list_set_tag(DrawListHandle list, unsigned int tag) {
+    if (list) list->tag = tag;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int draw_list_tag(DrawListHandle list) {
+    return list ? list->tag : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void draw_list_set_geometry(DrawListHandle list, unsigned int geometry, unsigned int version) {
+    if (!list) return;
+
+    list->geometry = geometry;
+    list->version = version;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_add_rectangle(DrawListHandle list, float x, float y, float width, float height, unsigned int color) {
+    DrawCommand* command;
+    if (!list) return -1;
+
+    command = append_command(list);
+    if (!command) return -1;
+
+    command->type = DRAW_RECTANGLE;
+    command->color = color;
+    command->x = x;
+    command->y = y;
+    command->width = width;
+    command->height = height;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_add_circle(DrawListHandle list, float x, float y, float radius, unsigned int color) {
+    DrawCommand* command;
+    if (!list) return -1;
+
+    command = append_command(list);
+    if (!command) return -1;
+
+    command->type = DRAW_CIRCLE;
+    command->color = color;
+    command->x = x;
+    command->y = y;
+    command->width = radius;
+    command->height = radius;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_begin_mask(DrawListHandle list, int mode) {
+    if (!list || (mode != DRAW_MASK_ALPHA && mode != DRAW_MASK_CLIP)) return -1;
+    return append_marker(list, DRAW_MASK_BEGIN, (unsigned int)mode);
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_begin_masked(DrawListHandle list) {
+    if (!list) return -1;
+    return append_marker(list, DRAW_MASK_CONTENT, 0);
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_end_mask(DrawListHandle list) {
+    if (!list) return -1;
+    return append_marker(list, DRAW_MASK_END, 0);
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_begin_group(DrawListHandle list, float opacity, int mode) {
+    int begin = -1;
+    if (!list || mode < DRAW_BLEND_NORMAL || mode > DRAW_BLEND_ADD) return -1;
+
+    if (list->group_count == list->group_capacity) {
+        int capacity = list->group_capacity ? list->group_capacity * 2 : 8;
+        OpenGroup* groups = (OpenGroup*)realloc(list->groups, capacity * sizeof(OpenGroup));
+        if (!groups) return -1;
+        list->groups = groups;
+        list->group_capacity = capacity;
+    }
+
+    // NaN counts as opaque
+    if (opacity < 0) opacity = 0;
+    if (!(opacity < 1)) opacity = 1;
+
+    if (opacity < 1 || mode != DRAW_BLEND_NORMAL) {
+        begin = list->count;
+        if (append_marker(list, DRAW_GROUP_BEGIN, (unsigned int)mode) != 0) return -1;
+        list->commands[begin].x = opacity;
+    }
+    list->groups[list->group_count].begin = begin;
+    list->groups[list->group_count].start = list->count;
+    list->group_count++;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_end_group(DrawListHandle list) {
+    int begin;
+    if (!list || list->group_count == 0) return -1;
+
+    begin = list->groups[--list->group_count].begin;
+    return begin < 0 ? 0 : close_group(list, begin);
+}
+
+// Make room for a filter of the innermost open group. Returns the filter's
+// command, or NULL if there's no group or it already has commands.
+static DrawCommand* append_filter(struct DrawList* list, unsigned int type) {
+    OpenGroup* group;
+    int i;
+    if (list->group_count == 0) return NULL;
+
+    group = &list->groups[list->group_count - 1];
+    if (group->begin < 0) {
+        // An opaque normal group has to be recorded after all
+        if (list->count != group->start) return NULL;
+        if (append_marker(list, DRAW_GROUP_BEGIN, DRAW_BLEND_NORMAL) != 0) return NULL;
+        list->commands[group->start].x = 1.0f;
+        group->begin = group->start;
+    }
+    for (i = group->begin + 1; i < list->count; i++) {
+        if (!is_filter(list->commands[i].type)) return NULL;
+    }
+
+    if (append_marker(list, type, 0) != 0) return NULL;
+    return &list->commands[list->count - 1];
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_add_blur(DrawListHandle list, float radius) {
+    DrawCommand* filter;
+    if (!list) return -1;
+
+    filter = append_filter(list, DRAW_BLUR);
+    if (!filter) return -1;
+    filter->width = radius > 0 ? radius : 0;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_add_shadow(DrawListHandle list, float dx, float dy, float radius, unsigned int color) {
+    DrawCommand* filter;
+    if (!list) return -1;
+
+    filter = append_filter(list, DRAW_SHADOW);
+    if (!filter) return -1;
+    filter->color = color;
+    filter->x = dx;
+    filter->y = dy;
+    filter->width = radius > 0 ? radius : 0;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_add_color_matrix(DrawListHandle list, const float* matrix) {
+    float clean[DRAW_COLOR_MATRIX_SIZE];
+    DrawCommand* filter;
+    float* stored;
+    int i;
+    if (!list || !matrix) return -1;
+
+    // NaNs would reach every pixel, so they count as nothing
+    for (i = 0; i < DRAW_COLOR_MATRIX_SIZE; i++) clean[i] = matrix[i] == matrix[i] ? matrix[i] : 0;
+
+    // Back to back, two matrices are one pass
+    if (list->group_count > 0 && list->count > 0 && list->groups[list->group_count - 1].begin >= 0 &&
+        list->commands[list->count - 1].type == DRAW_COLOR_MATRIX) {
+        stored = list->matrices + (size_t)list->commands[list->count - 1].color * DRAW_COLOR_MATRIX_SIZE;
+        concat_matrices(stored, stored, clean);
+        return 0;
+    }
+
+    if (reserve_matrices(list, list->matrix_count + 1) != 0) return -1;
+    filter = append_filter(list, DRAW_COLOR_MATRIX);
+    if (!filter) return -1;
+
+    filter->color = (unsigned int)list->matrix_count;
+    stored = list->matrices + (size_t)list->matrix_count++ * DRAW_COLOR_MATRIX_SIZE;
+    memcpy(stored, clean, sizeof(clean));
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_matrix_count(DrawListHandle list) {
+    return list ? list->matrix_count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const float* draw_list_matrices(DrawListHandle list) {
+    return list ? list->matrices : NULL;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_append(DrawListHandle list, const DrawCommand* commands, int count) {
+    int capacity;
+    if (!list || count < 0 || (count > 0 && !commands)) return -1;
+
+    capacity = list->capacity ? list->capacity : DRAW_LIST_INITIAL_CAPACITY;
+    while (capacity < list->count + count) capacity *= 2;
+    if (reserve(list, capacity) != 0) return -1;
+
+    if (count > 0) memcpy(list->commands + list->count, commands, count * sizeof(DrawCommand));
+    list->count += count;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_count(DrawListHandle list) {
+    return list ? list->count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const DrawCommand* draw_list_commands(DrawListHandle list) {
+    return list ? list->commands : NULL;
+}
+
+EMSCRIPTEN_KEEPALIVE int draw_list_copy(DrawListHandle list, DrawListHandle source) {
+    if (!list || !source) return -1;
+    if (reserve(list, source->count) != 0) return -1;
+    if (reserve_matrices(list, source->matrix_count) != 0) return -1;
+
+    if (source->count > 0) memcpy(list->commands, source->commands, source->count * sizeof(DrawCommand));
+    if (source->matrix_count > 0) {
+        memcpy(list->matrices, source->matrices, (size_t)source->matrix_count * DRAW_COLOR_MATRIX_SIZE * sizeof(float));
+    }
+    list->count = source->count;
+    list->matrix_count = source->matrix_count;
+    list->tag = 0;
+    list->geometry = 0;
+    list->version = 0;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int draw_list_hit_test(DrawListHandle list, float x, float y) {
+    unsigned int hit = 0;
+    unsigned int mode = DRAW_MASK_ALPHA;
+    int in_mask = 0, masked = 0, mask_hit = 0;
+    int i;
+    if (!list) return 0;
+
+    // Later commands are drawn on top, so the last hit wins
+    for (i = 0; i < list->count; i++) {
+        const DrawCommand* command = &list->commands[i];
+
+        switch (command->type) {
+            case DRAW_MASK_BEGIN:
+                in_mask = 1;
+                masked = 0;
+                mask_hit = 0;
+                mode = command->color;
+                continue;
+            case DRAW_MASK_CONTENT:
+                masked = in_mask;
+                in_mask = 0;
+                continue;
+            case DRAW_MASK_END:
+                in_mask = 0;
+                masked = 0;
+                continue;
+            default:
+                break;
+        }
+
+        if (in_mask) {
+            // Transparent shapes don't add to an alpha mask
+            if (!mask_hit && (mode == DRAW_MASK_CLIP || (command->color >> 24) != 0) && covers(command, x, y)) {
+                mask_hit = 1;
+            }
+            continue;
+        }
+        if (command->tag == 0 || (masked && !mask_hit)) continue;
+        if (covers(command, x, y)) hit = command->tag;
+    }
+    return hit;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int draw_color_parse(const char* color) {
+    char lower[DRAW_COLOR_MAX_LENGTH + 1];
+    const NamedColor* named;
+    size_t length = 0;
+    if (!color) return 0xff000000u;
+
+    // Colors are matched trimmed and case-insensitively
+    while (isspace((unsigned char)*color)) color++;
+    while (color[length] && length < DRAW_COLOR_MAX_LENGTH) {
+        lower[length] = (char)tolower((unsigned char)color[length]);
+        length++;
+    }
+    if (color[length]) return 0xff000000u;
+    while (length > 0 && isspace((unsigned char)lower[length - 1])) length--;
+    lower[length] = '\0';
+
+    if (lower[0] == '#') return parse_hex(lower + 1);
+    if (strncmp(lower, "rgba(", 5) == 0) return parse_rgb(lower + 5);
+    if (strncmp(lower, "rgb(", 4) == 0) return parse_rgb(lower + 4);
+    if (strncmp(lower, "hsla(", 5) == 0) return parse_hsl(lower + 5);
+    if (strncmp(lower, "hsl(", 4) == 0) return parse_hsl(lower + 4);
+
+    named = (const NamedColor*)bsearch(lower, named_colors, sizeof(named_colors) / sizeof(named_colors[0]),
+                                       sizeof(NamedColor), compare_named_color);
+    return named ? named->color : 0xff000000u;
+}
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <string.h>
+#include <emscripten.h>
+#include "geometry.h"
+
+#define GEOMETRY_INITIAL_CAPACITY 64
+#define GEOMETRY_MAX_IDS (1u << 24)
+
+// Last shape seen for an id
+typedef struct {
+    unsigned int type;
+    float width;
+    float height;
+    unsigned int version;       // 0 until the id is first seen
+} GeometryEntry;
+
+// Table structure, indexed by id; ids are element tags, so they're dense
+struct GeometryTable {
+    GeometryEntry* entries;
+    unsigned int capacity;
+};
+
+EMSCRIPTEN_KEEPALIVE GeometryTableHandle geometry_table_create(void) {
+    return (struct GeometryTable*)calloc(1, sizeof(struct GeometryTable));
+}
+
+EMSCRIPTEN_KEEPALIVE void geometry_table_destroy(GeometryTableHandle table) {
+    if (!table) return;
+
+    free(table->entries);
+    free(table);
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int geometry_table_version(GeometryTableHandle table, unsigned int id,
+                                                         unsigned int type, float width, float height) {
+    GeometryEntry* entry;
+    if (!table || id == 0 || id >= GEOMETRY_MAX_IDS) return 0;
+
+    if (id >= table->capacity) {
+        unsigned int capacity = table->capacity ? table->capacity : GEOMETRY_INITIAL_CAPACITY;
+        GeometryEntry* entries;
+        while (capacity <= id) capacity *= 2;
+
+        entries = (GeometryEntry*)realloc(table->entries, capacity * sizeof(GeometryEntry));
+        if (!entries) return 0;
+        memset(entries + table->capacity, 0, (capacity - table->capacity) * sizeof(GeometryEntry));
+        table->entries = entries;
+        table->capacity = capacity;
+    }
+
+    entry = &table->entries[id];
+    if (entry->version == 0 || entry->type != type || entry->width != width || entry->height != height) {
+        entry->type = type;
+        entry->width = width;
+        entry->height = height;
+        // Skip 0 on wraparound; it means "no geometry"
+        entry->version = entry->version + 1 ? entry->version + 1 : 1;
+    }
+    return entry->version;
+}
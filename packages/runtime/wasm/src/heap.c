@@ -0,0 +1,100 @@
+#include <stdlib.h>
+#include <string.h>
+#include <emscripten.h>
+#include "heap.h"
+
+#define HEAP_MIN_CAPACITY 4096u
+
+// Bytes at the start of every arena that are never handed out, so offset 0
+// can mean null
+#define HEAP_RESERVED 8u
+
+// Heap structure
+struct Heap {
+    unsigned char* base;
+    unsigned int capacity;
+    unsigned int used;
+};
+
+static int heap_reserve(struct Heap* heap, unsigned int needed) {
+    unsigned int capacity = heap->capacity;
+    unsigned char* base;
+
+    if (needed <= capacity) return 1;
+
+    while (capacity < needed) {
+        if (capacity > 0x7fffffffu) return 0;
+        capacity *= 2;
+    }
+
+    base = (unsigned char*)realloc(heap->base, capacity);
+    if (!base) return 0;
+
+    memset(base + heap->capacity, 0, capacity - heap->capacity);
+    heap->base = base;
+    heap->capacity = capacity;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE HeapHandle heap_create(unsigned int capacity) {
+    struct Heap* heap = (struct Heap*)malloc(sizeof(struct Heap));
+    if (!heap) return NULL;
+
+    if (capacity < HEAP_MIN_CAPACITY) capacity = HEAP_MIN_CAPACITY;
+
+    heap->base = (unsigned char*)calloc(1, capacity);
+    if (!heap->base) {
+        free(heap);
+        return NULL;
+    }
+    heap->capacity = capacity;
+    heap->used = HEAP_RESERVED;
+    return heap;
+}
+
+EMSCRIPTEN_KEEPALIVE void heap_destroy(HeapHandle heap) {
+    if (heap) {
+        free(heap->base);
+        free(heap);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE HeapOffset heap_alloc(HeapHandle heap, unsigned int size, unsigned int align) {
+    unsigned int offset;
+    if (!heap) return 0;
+    if (align == 0 || (align & (align - 1)) != 0) align = 8;
+
+    offset = (heap->used + align - 1) & ~(align - 1);
+    if (size > 0xffffffffu - offset) return 0;
+    if (!heap_reserve(heap, offset + size)) return 0;
+
+    heap->used = offset + size;
+    return offset;
+}
+
+EMSCRIPTEN_KEEPALIVE HeapOffset heap_strdup(HeapHandle heap, const char* str) {
+    unsigned int length;
+    HeapOffset offset;
+    if (!heap || !str) return 0;
+
+    length = (unsigned int)strlen(str) + 1;
+    offset = heap_alloc(heap, length, 1);
+    if (offset) {
+        memcpy(heap->base + offset, str, length);
+    }
+    return offset;
+}
+
+EMSCRIPTEN_KEEPALIVE void* heap_ptr(HeapHandle heap, HeapOffset offset, unsigned int size) {
+    if (!heap || offset == 0) return NULL;
+    if (offset > heap->used || size > heap->used - offset) return NULL;
+    return heap->base + offset;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int heap_used(HeapHandle heap) {
+    return heap ? heap->used : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const unsigned char* heap_base(HeapHandle heap) {
+    return heap ? heap->base : NULL;
+}
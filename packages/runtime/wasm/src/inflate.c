@@ -0,0 +1,569 @@
+#include <stdlib.h>
+#include <string.h>
+#include <emscripten.h>
+#include "inflate.h"
+
+// Codes up to FAST_BITS long decode with one table lookup; longer ones fall
+// back to walking the canonical code one bit at a time
+#define FAST_BITS 9
+#define FAST_SIZE (1 << FAST_BITS)
+#define MAX_BITS 15
+
+// The longest unit that must be decoded in one go is a dynamic block header
+// (under 600 bytes), so input held between chunks never exceeds this
+#define CARRY_SIZE INFLATE_MAX_LEFTOVER
+
+typedef enum {
+    STATE_BLOCK,    // Expecting a block header
+    STATE_STORED,   // Copying an uncompressed block
+    STATE_CODES,    // Decoding Huffman-coded symbols
+    STATE_DONE,
+    STATE_ERROR
+} InflateState;
+
+// Result of decoding one unit (a block header or a symbol)
+typedef enum {
+    UNIT_OK,
+    UNIT_NEED_INPUT,
+    UNIT_NEED_OUTPUT,
+    UNIT_ERROR
+} UnitResult;
+
+// Canonical Huffman code
+typedef struct {
+    short count[MAX_BITS + 1];      // Codes of each length
+    short symbol[288];              // Symbols ordered by code
+    unsigned short fast[FAST_SIZE]; // (length << 9) | symbol, 0 if longer than FAST_BITS
+} Huffman;
+
+// Decoder structure
+struct Inflater {
+    int state;
+    int final;
+    unsigned int stored_remaining;
+    const char* error;
+
+    // Bit buffer, filled a byte at a time, least significant bit first
+    unsigned int bitbuf;
+    unsigned int bitcnt;
+
+    // Input: unfinished unit bytes from earlier chunks, then the current chunk
+    unsigned char carry[CARRY_SIZE];
+    unsigned int carry_pos;
+    unsigned int carry_len;
+    const unsigned char* chunk;
+    unsigned int chunk_pos;
+    unsigned int chunk_len;
+
+    // Output, which doubles as the window
+    unsigned char* out;
+    unsigned int out_pos;
+    unsigned int out_capacity;
+
+    Huffman lencode;
+    Huffman distcode;
+    Huffman fixed_lencode;
+    Huffman fixed_distcode;
+};
+
+static const unsigned short LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const unsigned short LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const unsigned short DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const unsigned short DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const unsigned char CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// Build a decoding table from code lengths. Incomplete codes are allowed
+// (a single distance code is legal); over-subscribed ones are not.
+static int huffman_build(Huffman* h, const unsigned char* lengths, int n) {
+    short offsets[MAX_BITS + 1];
+    unsigned int next_code[MAX_BITS + 1];
+    unsigned int code;
+    int left, len, symbol;
+
+    memset(h->count, 0, sizeof(h->count));
+    memset(h->fast, 0, sizeof(h->fast));
+
+    for (symbol = 0; symbol < n; symbol++) h->count[lengths[symbol]]++;
+    if (h->count[0] == n) return 1;
+
+    left = 1;
+    for (len = 1; len <= MAX_BITS; len++) {
+        left <<= 1;
+        left -= h->count[len];
+        if (left < 0) return 0;
+    }
+
+    offsets[1] = 0;
+    for (len = 1; len < MAX_BITS; len++) offsets[len + 1] = offsets[len] + h->count[len];
+    for (symbol = 0; symbol < n; symbol++) {
+        if (lengths[symbol] != 0) h->symbol[offsets[lengths[symbol]]++] = (short)symbol;
+    }
+
+    code = 0;
+    for (len = 1; len <= MAX_BITS; len++) {
+        next_code[len] = code;
+        code = (code + h->count[len]) << 1;
+    }
+
+    // Codes are sent most significant bit first, so the table is indexed by
+    // the bit-reversed code, replicated across every value of the unused bits
+    for (symbol = 0; symbol < n; symbol++) {
+        unsigned int reversed = 0;
+        int bit;
+        len = lengths[symbol];
+        if (len == 0 || len > FAST_BITS) {
+            if (len) next_code[len]++;
+            continue;
+        }
+
+        code = next_code[len]++;
+        for (bit = 0; bit < len; bit++) reversed |= ((code >> bit) & 1u) << (len - 1 - bit);
+        for (; reversed < FAST_SIZE; reversed += 1u << len) {
+            h->fast[reversed] = (unsigned short)((len << 9) | symbol);
+        }
+    }
+
+    return 1;
+}
+
+// Take the next input byte into the bit buffer
+static int pull_byte(struct Inflater* s) {
+    unsigned int byte;
+    if (s->carry_pos < s->carry_len) {
+        byte = s->carry[s->carry_pos++];
+    } else if (s->chunk_pos < s->chunk_len) {
+        byte = s->chunk[s->chunk_pos++];
+    } else {
+        return 0;
+    }
+    s->bitbuf |= byte << s->bitcnt;
+    s->bitcnt += 8;
+    return 1;
+}
+
+static int need_bits(struct Inflater* s, unsigned int n) {
+    while (s->bitcnt < n) {
+        if (!pull_byte(s)) return 0;
+    }
+    return 1;
+}
+
+// Read bits already made available by need_bits
+static unsigned int take_bits(struct Inflater* s, unsigned int n) {
+    unsigned int value = s->bitbuf & ((1u << n) - 1u);
+    s->bitbuf >>= n;
+    s->bitcnt -= n;
+    return value;
+}
+
+// Decode one symbol; -1 means more input is needed, -2 an invalid code
+static int decode_symbol(struct Inflater* s, const Huffman* h) {
+    unsigned int entry;
+    int code, first, index, len, count;
+
+    while (s->bitcnt < FAST_BITS && pull_byte(s)) {}
+
+    entry = h->fast[s->bitbuf & (FAST_SIZE - 1)];
+    if (entry != 0 && (entry >> 9) <= s->bitcnt) {
+        take_bits(s, entry >> 9);
+        return (int)(entry & 0x1ff);
+    }
+
+    code = first = index = 0;
+    for (len = 1; len <= MAX_BITS; len++) {
+        if (!need_bits(s, 1)) return -1;
+        code |= (int)take_bits(s, 1);
+        count = h->count[len];
+        if (code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -2;
+}
+
+static void build_fixed_tables(struct Inflater* s) {
+    unsigned char lengths[288];
+    int symbol;
+
+    for (symbol = 0; symbol < 144; symbol++) lengths[symbol] = 8;
+    for (; symbol < 256; symbol++) lengths[symbol] = 9;
+    for (; symbol < 280; symbol++) lengths[symbol] = 7;
+    for (; symbol < 288; symbol++) lengths[symbol] = 8;
+    huffman_build(&s->fixed_lencode, lengths, 288);
+
+    for (symbol = 0; symbol < 30; symbol++) lengths[symbol] = 5;
+    huffman_build(&s->fixed_distcode, lengths, 30);
+}
+
+static UnitResult fail(struct Inflater* s, const char* message) {
+    s->error = message;
+    return UNIT_ERROR;
+}
+
+// Read the code length tables of a dynamic block
+static UnitResult read_dynamic_header(struct Inflater* s) {
+    unsigned char lengths[320];
+    unsigned int nlen, ndist, ncode, index;
+    int symbol;
+
+    if (!need_bits(s, 14)) return UNIT_NEED_INPUT;
+    nlen = take_bits(s, 5) + 257;
+    ndist = take_bits(s, 5) + 1;
+    ncode = take_bits(s, 4) + 4;
+    if (nlen > 286 || ndist > 30) return fail(s, "invalid dynamic block counts");
+
+    memset(lengths, 0, 19);
+    for (index = 0; index < ncode; index++) {
+        if (!need_bits(s, 3)) return UNIT_NEED_INPUT;
+        lengths[CODE_LENGTH_ORDER[index]] = (unsigned char)take_bits(s, 3);
+    }
+    if (!huffman_build(&s->lencode, lengths, 19)) return fail(s, "invalid code length code");
+
+    index = 0;
+    while (index < nlen + ndist) {
+        unsigned int repeat;
+        unsigned char value = 0;
+
+        symbol = decode_symbol(s, &s->lencode);
+        if (symbol == -1) return UNIT_NEED_INPUT;
+        if (symbol < 0) return fail(s, "invalid code length");
+
+        if (symbol < 16) {
+            lengths[index++] = (unsigned char)symbol;
+            continue;
+        }
+
+        if (symbol == 16) {
+            if (index == 0) return fail(s, "length repeat with no previous length");
+            value = lengths[index - 1];
+            if (!need_bits(s, 2)) return UNIT_NEED_INPUT;
+            repeat = 3 + take_bits(s, 2);
+        } else if (symbol == 17) {
+            if (!need_bits(s, 3)) return UNIT_NEED_INPUT;
+            repeat = 3 + take_bits(s, 3);
+        } else {
+            if (!need_bits(s, 7)) return UNIT_NEED_INPUT;
+            repeat = 11 + take_bits(s, 7);
+        }
+
+        if (index + repeat > nlen + ndist) return fail(s, "too many code lengths");
+        while (repeat--) lengths[index++] = value;
+    }
+
+    if (lengths[256] == 0) return fail(s, "missing end-of-block code");
+    if (!huffman_build(&s->lencode, lengths, (int)nlen)) return fail(s, "invalid literal/length code");
+    if (!huffman_build(&s->distcode, lengths + nlen, (int)ndist)) return fail(s, "invalid distance code");
+
+    return UNIT_OK;
+}
+
+// Read a block header and everything up to the block's first data
+static UnitResult read_block_header(struct Inflater* s) {
+    unsigned int type;
+    UnitResult result;
+
+    if (!need_bits(s, 3)) return UNIT_NEED_INPUT;
+    s->final = (int)take_bits(s, 1);
+    type = take_bits(s, 2);
+
+    if (type == 0) {
+        unsigned int length, check;
+
+        // Skip to a byte boundary; LEN and NLEN follow
+        take_bits(s, s->bitcnt & 7);
+        if (!need_bits(s, 32)) return UNIT_NEED_INPUT;
+        length = take_bits(s, 16);
+        check = take_bits(s, 16);
+        if (length != (~check & 0xffffu)) return fail(s, "stored block length mismatch");
+
+        s->stored_remaining = length;
+        s->state = STATE_STORED;
+        return UNIT_OK;
+    }
+
+    if (type == 1) {
+        memcpy(&s->lencode, &s->fixed_lencode, sizeof(Huffman));
+        memcpy(&s->distcode, &s->fixed_distcode, sizeof(Huffman));
+        s->state = STATE_CODES;
+        return UNIT_OK;
+    }
+
+    if (type == 2) {
+        result = read_dynamic_header(s);
+        if (result == UNIT_OK) s->state = STATE_CODES;
+        return result;
+    }
+
+    return fail(s, "invalid block type");
+}
+
+// Decode one literal, end-of-block or length/distance pair
+static UnitResult read_symbol(struct Inflater* s) {
+    unsigned int length, distance, extra;
+    int symbol = decode_symbol(s, &s->lencode);
+
+    if (symbol == -1) return UNIT_NEED_INPUT;
+    if (symbol < 0) return fail(s, "invalid literal/length code");
+
+    if (symbol < 256) {
+        if (s->out_pos >= s->out_capacity) return UNIT_NEED_OUTPUT;
+        s->out[s->out_pos++] = (unsigned char)symbol;
+        return UNIT_OK;
+    }
+
+    if (symbol == 256) {
+        s->state = s->final ? STATE_DONE : STATE_BLOCK;
+        return UNIT_OK;
+    }
+
+    symbol -= 257;
+    if (symbol >= 29) return fail(s, "invalid length symbol");
+    extra = LENGTH_EXTRA[symbol];
+    if (!need_bits(s, extra)) return UNIT_NEED_INPUT;
+    length = LENGTH_BASE[symbol] + take_bits(s, extra);
+
+    symbol = decode_symbol(s, &s->distcode);
+    if (symbol == -1) return UNIT_NEED_INPUT;
+    if (symbol < 0 || symbol >= 30) return fail(s, "invalid distance code");
+    extra = DIST_EXTRA[symbol];
+    if (!need_bits(s, extra)) return UNIT_NEED_INPUT;
+    distance = DIST_BASE[symbol] + take_bits(s, extra);
+
+    if (distance > s->out_pos) return fail(s, "distance too far back");
+    if (s->out_capacity - s->out_pos < length) return UNIT_NEED_OUTPUT;
+
+    if (distance >= length) {
+        memcpy(s->out + s->out_pos, s->out + s->out_pos - distance, length);
+        s->out_pos += length;
+    } else {
+        // Overlapping copy repeats the last `distance` bytes
+        unsigned char* dst = s->out + s->out_pos;
+        const unsigned char* src = dst - distance;
+        unsigned int i;
+        for (i = 0; i < length; i++) dst[i] = src[i];
+        s->out_pos += length;
+    }
+    return UNIT_OK;
+}
+
+// Copy as much of a stored block as input and output allow
+static UnitResult copy_stored(struct Inflater* s) {
+    while (s->stored_remaining > 0) {
+        unsigned int n;
+
+        if (s->out_pos >= s->out_capacity) return UNIT_NEED_OUTPUT;
+
+        // Whole bytes left in the bit buffer come first
+        if (s->bitcnt >= 8) {
+            s->out[s->out_pos++] = (unsigned char)take_bits(s, 8);
+            s->stored_remaining--;
+            continue;
+        }
+
+        n = s->stored_remaining;
+        if (n > s->out_capacity - s->out_pos) n = s->out_capacity - s->out_pos;
+
+        if (s->carry_pos < s->carry_len) {
+            if (n > s->carry_len - s->carry_pos) n = s->carry_len - s->carry_pos;
+            memcpy(s->out + s->out_pos, s->carry + s->carry_pos, n);
+            s->carry_pos += n;
+        } else if (s->chunk_pos < s->chunk_len) {
+            if (n > s->chunk_len - s->chunk_pos) n = s->chunk_len - s->chunk_pos;
+            memcpy(s->out + s->out_pos, s->chunk + s->chunk_pos, n);
+            s->chunk_pos += n;
+        } else {
+            return UNIT_NEED_INPUT;
+        }
+
+        s->out_pos += n;
+        s->stored_remaining -= n;
+    }
+
+    s->state = s->final ? STATE_DONE : STATE_BLOCK;
+    return UNIT_OK;
+}
+
+// Keep the unread input of an unfinished unit for the next chunk
+static int save_carry(struct Inflater* s) {
+    unsigned int carried = s->carry_len - s->carry_pos;
+    unsigned int pending = s->chunk_len - s->chunk_pos;
+
+    if (carried + pending > CARRY_SIZE) return 0;
+
+    memmove(s->carry, s->carry + s->carry_pos, carried);
+    memcpy(s->carry + carried, s->chunk + s->chunk_pos, pending);
+    s->carry_pos = 0;
+    s->carry_len = carried + pending;
+    s->chunk_pos = s->chunk_len;
+    return 1;
+}
+
+// Hand back bytes read past the end of the stream: whole bytes still in the
+// bit buffer go back to the chunk when they came from it, otherwise they join
+// the carry as leftover
+static void return_unused_input(struct Inflater* s) {
+    unsigned char unused[4];
+    unsigned int count, from_chunk, carried, i;
+
+    take_bits(s, s->bitcnt & 7);
+    count = s->bitcnt / 8;
+
+    carried = s->carry_len - s->carry_pos;
+    from_chunk = carried == 0 ? (count < s->chunk_pos ? count : s->chunk_pos) : 0;
+    s->chunk_pos -= from_chunk;
+    count -= from_chunk;
+    if (count + carried > CARRY_SIZE) count = CARRY_SIZE - carried;
+
+    for (i = 0; i < count; i++) unused[i] = (unsigned char)(s->bitbuf >> (8 * i));
+    memmove(s->carry + count, s->carry + s->carry_pos, carried);
+    memcpy(s->carry, unused, count);
+    s->carry_pos = 0;
+    s->carry_len = count + carried;
+
+    s->bitbuf = 0;
+    s->bitcnt = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE InflateHandle inflate_create(void) {
+    struct Inflater* inflater = (struct Inflater*)calloc(1, sizeof(struct Inflater));
+    if (!inflater) return NULL;
+
+    build_fixed_tables(inflater);
+    inflater->state = STATE_BLOCK;
+    return inflater;
+}
+
+EMSCRIPTEN_KEEPALIVE void inflate_destroy(InflateHandle inflater) {
+    free(inflater);
+}
+
+EMSCRIPTEN_KEEPALIVE void inflate_reset(InflateHandle inflater, unsigned char* out, unsigned int capacity) {
+    if (!inflater) return;
+
+    inflater->state = STATE_BLOCK;
+    inflater->final = 0;
+    inflater->stored_remaining = 0;
+    inflater->error = NULL;
+    inflater->bitbuf = 0;
+    inflater->bitcnt = 0;
+    inflater->carry_pos = 0;
+    inflater->carry_len = 0;
+    inflater->chunk = NULL;
+    inflater->chunk_pos = 0;
+    inflater->chunk_len = 0;
+    inflater->out = out;
+    inflater->out_pos = 0;
+    inflater->out_capacity = capacity;
+}
+
+EMSCRIPTEN_KEEPALIVE void inflate_set_output(InflateHandle inflater, unsigned char* out, unsigned int capacity) {
+    if (!inflater) return;
+
+    inflater->out = out;
+    inflater->out_capacity = capacity;
+}
+
+EMSCRIPTEN_KEEPALIVE InflateStatus inflate_push(InflateHandle inflater, const unsigned char* in, unsigned int size) {
+    struct Inflater* s = inflater;
+    if (!s) return INFLATE_ERROR;
+
+    s->chunk = in;
+    s->chunk_pos = 0;
+    s->chunk_len = in ? size : 0;
+
+    if (s->state == STATE_ERROR) return INFLATE_ERROR;
+    if (s->state == STATE_DONE) return INFLATE_DONE;
+
+    for (;;) {
+        // Units either complete or rewind to here, so a unit split across
+        // chunks is simply decoded again once the rest arrives
+        unsigned int bitbuf = s->bitbuf;
+        unsigned int bitcnt = s->bitcnt;
+        unsigned int carry_pos = s->carry_pos;
+        unsigned int chunk_pos = s->chunk_pos;
+        UnitResult result;
+
+        switch (s->state) {
+            case STATE_BLOCK:
+                result = read_block_header(s);
+                break;
+            case STATE_STORED:
+                // Copies make partial progress, so they never rewind
+                result = copy_stored(s);
+                if (result != UNIT_ERROR) {
+                    bitbuf = s->bitbuf;
+                    bitcnt = s->bitcnt;
+                    carry_pos = s->carry_pos;
+                    chunk_pos = s->chunk_pos;
+                }
+                break;
+            case STATE_CODES:
+                result = read_symbol(s);
+                break;
+            default:
+                return_unused_input(s);
+                return INFLATE_DONE;
+        }
+
+        if (result == UNIT_OK) continue;
+
+        if (result == UNIT_ERROR) {
+            s->state = STATE_ERROR;
+            return INFLATE_ERROR;
+        }
+
+        s->bitbuf = bitbuf;
+        s->bitcnt = bitcnt;
+        s->carry_pos = carry_pos;
+        s->chunk_pos = chunk_pos;
+
+        if (result == UNIT_NEED_OUTPUT) {
+            // Leave the rest of the chunk with the caller; anything carried stays
+            if (s->carry_pos == s->carry_len) s->carry_pos = s->carry_len = 0;
+            return INFLATE_NEED_OUTPUT;
+        }
+
+        if (!save_carry(s)) {
+            s->error = "unit too long";
+            s->state = STATE_ERROR;
+            return INFLATE_ERROR;
+        }
+        return INFLATE_OK;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int inflate_consumed(InflateHandle inflater) {
+    return inflater ? inflater->chunk_pos : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int inflate_leftover(InflateHandle inflater, const unsigned char** data) {
+    if (!inflater || inflater->state != STATE_DONE) return 0;
+
+    if (data) *data = inflater->carry + inflater->carry_pos;
+    return inflater->carry_len - inflater->carry_pos;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int inflate_output_size(InflateHandle inflater) {
+    return inflater ? inflater->out_pos : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* inflate_error(InflateHandle inflater) {
+    if (!inflater) return "no inflater";
+    return inflater->error ? inflater->error : "";
+}
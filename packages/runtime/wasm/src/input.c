@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <emscripten.h>
+#include "input.h"
+
+// Dispatcher structure
+struct InputDispatcher {
+    unsigned int hover;         // Element under the pointer, or 0
+    unsigned int pressed;       // Element the pointer went down on, or 0
+    int pointer_down;
+    int dragging;
+    float press_x;
+    float press_y;
+
+    Interaction batch[INPUT_BATCH_CAPACITY];
+    int count;
+};
+
+static void emit(struct InputDispatcher* dispatcher, int type, unsigned int tag, const InputEvent* event) {
+    Interaction* interaction = &dispatcher->batch[dispatcher->count++];
+    interaction->type = type;
+    interaction->tag = tag;
+    interaction->x = event->x;
+    interaction->y = event->y;
+    interaction->detail = event->detail;
+}
+
+// Hover fires when the pointer enters an element
+static unsigned int update_hover(struct InputDispatcher* dispatcher, DrawListHandle hits, const InputEvent* event) {
+    unsigned int tag = draw_list_hit_test(hits, event->x, event->y);
+    if (tag != dispatcher->hover) {
+        dispatcher->hover = tag;
+        if (tag) emit(dispatcher, INTERACTION_HOVER, tag, event);
+    }
+    return tag;
+}
+
+static void end_press(struct InputDispatcher* dispatcher) {
+    dispatcher->pointer_down = 0;
+    dispatcher->dragging = 0;
+    dispatcher->pressed = 0;
+}
+
+static void handle_event(struct InputDispatcher* dispatcher, DrawListHandle hits, const InputEvent* event) {
+    unsigned int tag;
+    float dx, dy;
+
+    switch (event->type) {
+        case INPUT_POINTER_DOWN:
+            dispatcher->pressed = update_hover(dispatcher, hits, event);
+            dispatcher->pointer_down = 1;
+            dispatcher->dragging = 0;
+            dispatcher->press_x = event->x;
+            dispatcher->press_y = event->y;
+            break;
+
+        case INPUT_POINTER_MOVE:
+            update_hover(dispatcher, hits, event);
+            if (!dispatcher->pointer_down || dispatcher->dragging) break;
+
+            dx = event->x - dispatcher->press_x;
+            dy = event->y - dispatcher->press_y;
+            if (dx * dx + dy * dy > INPUT_DRAG_THRESHOLD * INPUT_DRAG_THRESHOLD) {
+                dispatcher->dragging = 1;
+                if (dispatcher->pressed) emit(dispatcher, INTERACTION_DRAG_START, dispatcher->pressed, event);
+            }
+            break;
+
+        case INPUT_POINTER_UP:
+            tag = update_hover(dispatcher, hits, event);
+            if (!dispatcher->pointer_down) break;
+
+            // A press that turned into a drag isn't a click
+            if (dispatcher->dragging) {
+                if (dispatcher->pressed) emit(dispatcher, INTERACTION_DRAG_END, dispatcher->pressed, event);
+            } else if (dispatcher->pressed && tag == dispatcher->pressed) {
+                emit(dispatcher, INTERACTION_CLICK, tag, event);
+            }
+            end_press(dispatcher);
+            break;
+
+        case INPUT_POINTER_CANCEL:
+            if (dispatcher->dragging && dispatcher->pressed) {
+                emit(dispatcher, INTERACTION_DRAG_END, dispatcher->pressed, event);
+            }
+            end_press(dispatcher);
+            dispatcher->hover = 0;
+            break;
+
+        case INPUT_POINTER_LEAVE:
+            dispatcher->hover = 0;
+            break;
+
+        case INPUT_KEY_DOWN:
+            emit(dispatcher, INTERACTION_KEY_DOWN, 0, event);
+            break;
+
+        case INPUT_KEY_UP:
+            emit(dispatcher, INTERACTION_KEY_UP, 0, event);
+            break;
+
+        default:
+            break;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE InputRing* input_ring_create(void) {
+    return (InputRing*)calloc(1, sizeof(InputRing));
+}
+
+EMSCRIPTEN_KEEPALIVE void input_ring_destroy(InputRing* ring) {
+    free(ring);
+}
+
+EMSCRIPTEN_KEEPALIVE int input_ring_push(InputRing* ring, int type, float x, float y, unsigned int detail) {
+    unsigned int tail, head;
+    InputEvent* event;
+    if (!ring) return 0;
+
+    tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head == INPUT_RING_CAPACITY) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    event = &ring->events[tail & (INPUT_RING_CAPACITY - 1)];
+    event->type = (unsigned int)type;
+    event->x = x;
+    event->y = y;
+    event->detail = detail;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int input_ring_dropped(InputRing* ring) {
+    return ring ? (int)__atomic_load_n(&ring->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE InputDispatcherHandle input_dispatcher_create(void) {
+    return (struct InputDispatcher*)calloc(1, sizeof(struct InputDispatcher));
+}
+
+EMSCRIPTEN_KEEPALIVE void input_dispatcher_destroy(InputDispatcherHandle dispatcher) {
+    free(dispatcher);
+}
+
+EMSCRIPTEN_KEEPALIVE int input_dispatch(InputDispatcherHandle dispatcher, InputRing* ring, DrawListHandle hits) {
+    unsigned int head, tail;
+    if (!dispatcher || !ring) return -1;
+
+    dispatcher->count = 0;
+    head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    // Events pushed while draining wait for the next tick
+    tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+        const InputEvent* event = &ring->events[head & (INPUT_RING_CAPACITY - 1)];
+
+        // Only the last of a run of moves matters, unless a press could
+        // still turn into a drag somewhere along it
+        if (event->type == INPUT_POINTER_MOVE && head + 1 != tail &&
+            ring->events[(head + 1) & (INPUT_RING_CAPACITY - 1)].type == INPUT_POINTER_MOVE &&
+            (!dispatcher->pointer_down || dispatcher->dragging)) {
+            continue;
+        }
+        handle_event(dispatcher, hits, event);
+    }
+
+    // Hand the slots back only once the events have been read
+    __atomic_store_n(&ring->head, tail, __ATOMIC_RELEASE);
+    return dispatcher->count;
+}
+
+EMSCRIPTEN_KEEPALIVE const Interaction* input_dispatcher_batch(InputDispatcherHandle dispatcher) {
+    return dispatcher ? dispatcher->batch : NULL;
+}
@@ -0,0 +1,322 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <emscripten.h>
+#include "instancing.h"
+#include "simd.h"
+
+#define SYMBOL_MIN_CAPACITY 16
+#define SYMBOL_DEG_TO_RAD 0.017453292519943295f
+
+// Per-instance channels, each `capacity` floats inside one block
+enum {
+    CH_OFFSET = 0,
+    CH_RATE,
+    CH_ROOT,                                    // 6 channels: a b c d e f
+    CH_TIME = CH_ROOT + 6,                      // Local time of the last evaluation
+    CH_VALUE,                                   // SYMBOL_TRACK_COUNT sampled track values
+    CH_OUT = CH_VALUE + SYMBOL_TRACK_COUNT,     // SYMBOL_OUT_A..SYMBOL_OUT_F
+    CH_COUNT = CH_OUT + 6
+};
+
+// Keyframes of one track, shared by every instance
+typedef struct {
+    float* frames;
+    float* values;
+    unsigned char* easings;
+    int count;
+} Track;
+
+// Symbol structure
+struct Symbol {
+    float duration;
+    int loop;
+    Track tracks[SYMBOL_TRACK_COUNT];
+
+    int count;
+    int capacity;                   // Always a multiple of 4
+    float* block;
+    float* channels[CH_COUNT];
+};
+
+// Value a track holds when the symbol doesn't animate it
+static const float track_defaults[SYMBOL_TRACK_COUNT] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+
+static const float identity_transform[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+
+static int symbol_reserve(struct Symbol* symbol, int needed) {
+    int capacity = symbol->capacity;
+    float* block;
+    int ch;
+
+    if (needed <= capacity) return 1;
+
+    if (capacity < SYMBOL_MIN_CAPACITY) capacity = SYMBOL_MIN_CAPACITY;
+    while (capacity < needed) {
+        if (capacity > 0x3fffffff / CH_COUNT) return 0;
+        capacity *= 2;
+    }
+
+    block = (float*)calloc((size_t)capacity * CH_COUNT, sizeof(float));
+    if (!block) return 0;
+
+    for (ch = 0; ch < CH_COUNT; ch++) {
+        if (symbol->block) {
+            memcpy(block + (size_t)ch * capacity, symbol->channels[ch], (size_t)symbol->count * sizeof(float));
+        }
+        symbol->channels[ch] = block + (size_t)ch * capacity;
+    }
+
+    free(symbol->block);
+    symbol->block = block;
+    symbol->capacity = capacity;
+    return 1;
+}
+
+static void track_free(Track* track) {
+    free(track->frames);
+    free(track->values);
+    free(track->easings);
+    memset(track, 0, sizeof(Track));
+}
+
+static float ease(int easing, float u) {
+    switch (easing) {
+        case SYMBOL_EASE_IN:
+            return u * u;
+        case SYMBOL_EASE_OUT:
+            return u * (2.0f - u);
+        case SYMBOL_EASE_IN_OUT:
+            return u < 0.5f ? 2.0f * u * u : -1.0f + (4.0f - 2.0f * u) * u;
+        case SYMBOL_EASE_STEP:
+            return 0.0f;
+        default:
+            return u;
+    }
+}
+
+// Sample a track; times outside the keyframes hold the nearest end
+static float track_sample(const Track* track, float t) {
+    int low, high, last = track->count - 1;
+    float u;
+
+    if (t <= track->frames[0]) return track->values[0];
+    if (t >= track->frames[last]) return track->values[last];
+
+    // Find the segment [low, low + 1] containing t
+    low = 0;
+    high = last;
+    while (high - low > 1) {
+        int mid = (low + high) >> 1;
+        if (track->frames[mid] <= t) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    u = (t - track->frames[low]) / (track->frames[low + 1] - track->frames[low]);
+    if (track->easings) u = ease(track->easings[low], u);
+    return track->values[low] + (track->values[low + 1] - track->values[low]) * u;
+}
+
+static void symbol_write_instance(struct Symbol* symbol, int index, float time_offset, float rate,
+                                  const float* root_transform) {
+    int i;
+    if (!root_transform) root_transform = identity_transform;
+
+    symbol->channels[CH_OFFSET][index] = time_offset;
+    symbol->channels[CH_RATE][index] = rate;
+    for (i = 0; i < 6; i++) {
+        symbol->channels[CH_ROOT + i][index] = root_transform[i];
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE SymbolHandle symbol_create(float duration, int loop) {
+    struct Symbol* symbol = (struct Symbol*)calloc(1, sizeof(struct Symbol));
+    if (!symbol) return NULL;
+
+    symbol->duration = duration > 0.0f ? duration : 0.0f;
+    symbol->loop = loop;
+
+    if (!symbol_reserve(symbol, SYMBOL_MIN_CAPACITY)) {
+        free(symbol);
+        return NULL;
+    }
+
+    return symbol;
+}
+
+EMSCRIPTEN_KEEPALIVE void symbol_destroy(SymbolHandle symbol) {
+    int track;
+    if (!symbol) return;
+
+    for (track = 0; track < SYMBOL_TRACK_COUNT; track++) {
+        track_free(&symbol->tracks[track]);
+    }
+    free(symbol->block);
+    free(symbol);
+}
+
+EMSCRIPTEN_KEEPALIVE int symbol_set_track(SymbolHandle symbol, int track,
+                                          const float* frames, const float* values,
+                                          const unsigned char* easings, int count) {
+    Track copy;
+    int i;
+
+    if (!symbol || track < 0 || track >= SYMBOL_TRACK_COUNT) return -1;
+    if (count < 0 || (count > 0 && (!frames || !values))) return -1;
+
+    for (i = 1; i < count; i++) {
+        if (frames[i] < frames[i - 1]) return -1;
+    }
+
+    memset(&copy, 0, sizeof(Track));
+    if (count > 0) {
+        copy.frames = (float*)malloc((size_t)count * sizeof(float));
+        copy.values = (float*)malloc((size_t)count * sizeof(float));
+        copy.easings = easings ? (unsigned char*)malloc((size_t)count) : NULL;
+
+        if (!copy.frames || !copy.values || (easings && !copy.easings)) {
+            track_free(&copy);
+            return -1;
+        }
+
+        memcpy(copy.frames, frames, (size_t)count * sizeof(float));
+        memcpy(copy.values, values, (size_t)count * sizeof(float));
+        if (easings) memcpy(copy.easings, easings, (size_t)count);
+        copy.count = count;
+    }
+
+    track_free(&symbol->tracks[track]);
+    symbol->tracks[track] = copy;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int symbol_add_instance(SymbolHandle symbol, float time_offset, float rate,
+                                             const float* root_transform) {
+    int index;
+    if (!symbol) return -1;
+    if (!symbol_reserve(symbol, symbol->count + 1)) return -1;
+
+    index = symbol->count++;
+    symbol_write_instance(symbol, index, time_offset, rate, root_transform);
+    return index;
+}
+
+EMSCRIPTEN_KEEPALIVE int symbol_set_instance(SymbolHandle symbol, int index, float time_offset, float rate,
+                                             const float* root_transform) {
+    if (!symbol || index < 0 || index >= symbol->count) return -1;
+
+    symbol_write_instance(symbol, index, time_offset, rate, root_transform);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void symbol_remove_instance(SymbolHandle symbol, int index) {
+    int last, ch;
+    if (!symbol || index < 0 || index >= symbol->count) return;
+
+    last = --symbol->count;
+    if (index == last) return;
+
+    for (ch = 0; ch < CH_COUNT; ch++) {
+        symbol->channels[ch][index] = symbol->channels[ch][last];
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE int symbol_instance_count(SymbolHandle symbol) {
+    return symbol ? symbol->count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void symbol_evaluate(SymbolHandle symbol, float time) {
+    if (symbol) symbol_evaluate_range(symbol, time, 0, symbol->count);
+}
+
+EMSCRIPTEN_KEEPALIVE void symbol_evaluate_range(SymbolHandle symbol, float time, int first, int count) {
+    float** ch;
+    int end, lanes, i, track;
+
+    if (!symbol || first < 0 || (first & 3) != 0 || count <= 0) return;
+    end = first + count < symbol->count ? first + count : symbol->count;
+    if (first >= end) return;
+
+    ch = symbol->channels;
+    lanes = (end + 3) & ~3;             // Padding lanes are computed and ignored
+
+    // Local time of every instance
+    for (i = first; i < lanes; i += 4) {
+        f32x4 t = f32x4_sub(f32x4_splat(time), f32x4_load(ch[CH_OFFSET] + i));
+        f32x4_store(ch[CH_TIME] + i, f32x4_mul(t, f32x4_load(ch[CH_RATE] + i)));
+    }
+
+    for (i = first; i < end; i++) {
+        float t = ch[CH_TIME][i];
+        if (symbol->duration <= 0.0f) {
+            t = 0.0f;
+        } else if (symbol->loop) {
+            t = fmodf(t, symbol->duration);
+            if (t < 0.0f) t += symbol->duration;
+        } else {
+            t = t < 0.0f ? 0.0f : (t > symbol->duration ? symbol->duration : t);
+        }
+        ch[CH_TIME][i] = t;
+    }
+
+    // Sample the shared tracks; keyframe lookup differs per instance, so this is scalar
+    for (track = 0; track < SYMBOL_TRACK_COUNT; track++) {
+        const Track* keys = &symbol->tracks[track];
+        float* out = ch[CH_VALUE + track];
+
+        if (keys->count == 0) {
+            for (i = first; i < lanes; i++) out[i] = track_defaults[track];
+        } else {
+            for (i = first; i < end; i++) out[i] = track_sample(keys, ch[CH_TIME][i]);
+        }
+    }
+
+    // Rotation to cos/sin, parked in the A and B outputs until composition
+    for (i = first; i < end; i++) {
+        float angle = ch[CH_VALUE + SYMBOL_TRACK_ROTATION][i] * SYMBOL_DEG_TO_RAD;
+        ch[CH_OUT + SYMBOL_OUT_A][i] = cosf(angle);
+        ch[CH_OUT + SYMBOL_OUT_B][i] = sinf(angle);
+    }
+
+    // world = root * translate(x, y) * rotate * scale(sx, sy)
+    for (i = first; i < lanes; i += 4) {
+        f32x4 cs = f32x4_load(ch[CH_OUT + SYMBOL_OUT_A] + i);
+        f32x4 sn = f32x4_load(ch[CH_OUT + SYMBOL_OUT_B] + i);
+        f32x4 sx = f32x4_load(ch[CH_VALUE + SYMBOL_TRACK_SCALE_X] + i);
+        f32x4 sy = f32x4_load(ch[CH_VALUE + SYMBOL_TRACK_SCALE_Y] + i);
+        f32x4 x = f32x4_load(ch[CH_VALUE + SYMBOL_TRACK_X] + i);
+        f32x4 y = f32x4_load(ch[CH_VALUE + SYMBOL_TRACK_Y] + i);
+
+        f32x4 ra = f32x4_load(ch[CH_ROOT + 0] + i);
+        f32x4 rb = f32x4_load(ch[CH_ROOT + 1] + i);
+        f32x4 rc = f32x4_load(ch[CH_ROOT + 2] + i);
+        f32x4 rd = f32x4_load(ch[CH_ROOT + 3] + i);
+        f32x4 re = f32x4_load(ch[CH_ROOT + 4] + i);
+        f32x4 rf = f32x4_load(ch[CH_ROOT + 5] + i);
+
+        f32x4 la = f32x4_mul(cs, sx);
+        f32x4 lb = f32x4_mul(sn, sx);
+        f32x4 lc = f32x4_sub(f32x4_splat(0.0f), f32x4_mul(sn, sy));
+        f32x4 ld = f32x4_mul(cs, sy);
+
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_A] + i, f32x4_add(f32x4_mul(ra, la), f32x4_mul(rc, lb)));
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_B] + i, f32x4_add(f32x4_mul(rb, la), f32x4_mul(rd, lb)));
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_C] + i, f32x4_add(f32x4_mul(ra, lc), f32x4_mul(rc, ld)));
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_D] + i, f32x4_add(f32x4_mul(rb, lc), f32x4_mul(rd, ld)));
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_E] + i,
+                    f32x4_add(f32x4_add(f32x4_mul(ra, x), f32x4_mul(rc, y)), re));
+        f32x4_store(ch[CH_OUT + SYMBOL_OUT_F] + i,
+                    f32x4_add(f32x4_add(f32x4_mul(rb, x), f32x4_mul(rd, y)), rf));
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE const float* symbol_output(SymbolHandle symbol, int channel) {
+    if (!symbol || channel < 0 || channel >= SYMBOL_OUT_COUNT) return NULL;
+
+    // Opacity needs no composition, so it is read straight from its track values
+    if (channel == SYMBOL_OUT_OPACITY) return symbol->channels[CH_VALUE + SYMBOL_TRACK_OPACITY];
+    return symbol->channels[CH_OUT + channel];
+}
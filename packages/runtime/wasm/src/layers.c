@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <math.h>
+#include <emscripten.h>
+#include "layers.h"
+#include "thread_pool.h"
+
+// One layer and the commands its instances evaluated to
+typedef struct {
+    SymbolHandle symbol;
+    int shape;
+    float width;
+    float height;
+    unsigned int color;
+    unsigned int tag;
+
+    DrawCommand* commands;      // One slot per instance
+    int capacity;
+} Layer;
+
+// A chunk of one layer's instances
+typedef struct {
+    int layer;
+    int first;
+    int count;
+} LayerTask;
+
+// Layer stack structure
+struct LayerStack {
+    Layer* layers;
+    int count;
+    int capacity;
+
+    LayerTask* tasks;
+    int task_capacity;
+    float time;                 // Of the evaluation in progress
+};
+
+// Workers are preallocated by the module, so every stack shares one pool
+static ThreadPoolHandle shared_pool = NULL;
+static int shared_pool_users = 0;
+
+// Evaluate a chunk of instances into their command slots
+static void evaluate_task(void* context, int index) {
+    struct LayerStack* stack = (struct LayerStack*)context;
+    const LayerTask* task = &stack->tasks[index];
+    const Layer* layer = &stack->layers[task->layer];
+    const float *a, *b, *c, *d, *e, *f, *opacity;
+    unsigned int alpha = layer->color >> 24;
+    int i;
+
+    symbol_evaluate_range(layer->symbol, stack->time, task->first, task->count);
+    a = symbol_output(layer->symbol, SYMBOL_OUT_A);
+    b = symbol_output(layer->symbol, SYMBOL_OUT_B);
+    c = symbol_output(layer->symbol, SYMBOL_OUT_C);
+    d = symbol_output(layer->symbol, SYMBOL_OUT_D);
+    e = symbol_output(layer->symbol, SYMBOL_OUT_E);
+    f = symbol_output(layer->symbol, SYMBOL_OUT_F);
+    opacity = symbol_output(layer->symbol, SYMBOL_OUT_OPACITY);
+
+    for (i = task->first; i < task->first + task->count; i++) {
+        DrawCommand* command = &layer->commands[i];
+        float scale_x = sqrtf(a[i] * a[i] + b[i] * b[i]);
+        float scale_y = sqrtf(c[i] * c[i] + d[i] * d[i]);
+        float fade = opacity[i] < 0.0f ? 0.0f : (opacity[i] > 1.0f ? 1.0f : opacity[i]);
+
+        command->type = (unsigned int)layer->shape;
+        command->color = (layer->color & 0x00ffffffu) | ((unsigned int)(alpha * fade + 0.5f) << 24);
+        command->x = e[i];
+        command->y = f[i];
+        command->width = layer->width * scale_x;
+        command->height = layer->shape == DRAW_CIRCLE ? command->width : layer->height * scale_y;
+        command->tag = layer->tag;
+        command->geometry = 0;
+        command->version = 0;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE LayerStackHandle layer_stack_create(void) {
+    struct LayerStack* stack = (struct LayerStack*)calloc(1, sizeof(struct LayerStack));
+    if (!stack) return NULL;
+
+    // Without a pool, or without workers, layers are evaluated inline
+    if (shared_pool_users++ == 0) shared_pool = thread_pool_create(THREAD_POOL_MAX_WORKERS);
+    return stack;
+}
+
+EMSCRIPTEN_KEEPALIVE void layer_stack_destroy(LayerStackHandle stack) {
+    int i;
+    if (!stack) return;
+
+    if (--shared_pool_users == 0) {
+        thread_pool_destroy(shared_pool);
+        shared_pool = NULL;
+    }
+    for (i = 0; i < stack->count; i++) free(stack->layers[i].commands);
+    free(stack->layers);
+    free(stack->tasks);
+    free(stack);
+}
+
+EMSCRIPTEN_KEEPALIVE int layer_stack_add(LayerStackHandle stack, SymbolHandle symbol, int shape,
+                                         float width, float height, unsigned int color, unsigned int tag) {
+    Layer* layer;
+    int i;
+    if (!stack || !symbol) return -1;
+    if (shape != DRAW_RECTANGLE && shape != DRAW_CIRCLE) return -1;
+
+    for (i = 0; i < stack->count; i++) {
+        if (stack->layers[i].symbol == symbol) return -1;
+    }
+
+    if (stack->count == stack->capacity) {
+        int capacity = stack->capacity ? stack->capacity * 2 : 8;
+        Layer* layers = (Layer*)realloc(stack->layers, capacity * sizeof(Layer));
+        if (!layers) return -1;
+        stack->layers = layers;
+        stack->capacity = capacity;
+    }
+
+    layer = &stack->layers[stack->count];
+    layer->symbol = symbol;
+    layer->shape = shape;
+    layer->width = width;
+    layer->height = height;
+    layer->color = color;
+    layer->tag = tag;
+    layer->commands = NULL;
+    layer->capacity = 0;
+    return stack->count++;
+}
+
+EMSCRIPTEN_KEEPALIVE int layer_stack_count(LayerStackHandle stack) {
+    return stack ? stack->count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int layer_stack_workers(LayerStackHandle stack) {
+    return stack ? thread_pool_workers(shared_pool) : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int layer_stack_evaluate(LayerStackHandle stack, float time, DrawListHandle list) {
+    int tasks = 0;
+    int i, first;
+
+    if (!stack || !list) return -1;
+
+    // Size the command slots and cut the layers into tasks
+    for (i = 0; i < stack->count; i++) {
+        Layer* layer = &stack->layers[i];
+        int instances = symbol_instance_count(layer->symbol);
+
+        if (instances > layer->capacity) {
+            DrawCommand* commands = (DrawCommand*)realloc(layer->commands, instances * sizeof(DrawCommand));
+            if (!commands) return -1;
+            layer->commands = commands;
+            layer->capacity = instances;
+        }
+
+        for (first = 0; first < instances; first += LAYER_CHUNK_INSTANCES) {
+            if (tasks == stack->task_capacity) {
+                int capacity = stack->task_capacity ? stack->task_capacity * 2 : 64;
+                LayerTask* grown = (LayerTask*)realloc(stack->tasks, capacity * sizeof(LayerTask));
+                if (!grown) return -1;
+                stack->tasks = grown;
+                stack->task_capacity = capacity;
+            }
+            stack->tasks[tasks].layer = i;
+            stack->tasks[tasks].first = first;
+            stack->tasks[tasks].count = instances - first < LAYER_CHUNK_INSTANCES ? instances - first : LAYER_CHUNK_INSTANCES;
+            tasks++;
+        }
+    }
+
+    stack->time = time;
+    thread_pool_run(shared_pool, evaluate_task, stack, tasks);
+
+    // Merge in layer order
+    for (i = 0; i < stack->count; i++) {
+        const Layer* layer = &stack->layers[i];
+        if (draw_list_append(list, layer->commands, symbol_instance_count(layer->symbol)) != 0) return -1;
+    }
+    return 0;
+}
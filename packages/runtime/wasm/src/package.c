@@ -0,0 +1,798 @@
+#include <stdlib.h>
+#include <string.h>
+#include <emscripten.h>
+#include "package.h"
+#include "inflate.h"
+#include "sha256.h"
+
+#define SIG_LOCAL_HEADER 0x04034b50u
+#define SIG_CENTRAL_HEADER 0x02014b50u
+#define SIG_END_OF_CENTRAL 0x06054b50u
+#define SIG_DATA_DESCRIPTOR 0x08074b50u
+
+#define LOCAL_HEADER_SIZE 30
+#define FLAG_ENCRYPTED 0x0001u
+#define FLAG_DATA_DESCRIPTOR 0x0008u
+#define METHOD_STORED 0
+#define METHOD_DEFLATE 8
+
+// Entries written with a trailing data descriptor don't declare their size
+// up front; they inflate into a growing buffer starting at this size
+#define UNSIZED_INITIAL_CAPACITY 65536u
+
+typedef enum {
+    READ_HEADER,        // Fixed part of a local header
+    READ_NAME,
+    READ_EXTRA,
+    READ_DATA,
+    READ_DESCRIPTOR,
+    READ_DONE,
+    READ_ERROR
+} ReadState;
+
+// Completed entry
+typedef struct {
+    char* name;
+    HeapOffset offset;
+    unsigned int size;
+    unsigned char digest[SHA256_DIGEST_SIZE];
+} PackageEntry;
+
+// Digest an entry must match, registered before it arrives
+typedef struct {
+    char* name;
+    unsigned char digest[SHA256_DIGEST_SIZE];
+} ExpectedDigest;
+
+// Sizes of an entry from the central directory, registered before it arrives
+typedef struct {
+    char* name;
+    unsigned int compressed_size;
+    unsigned int size;
+} ExpectedSizes;
+
+// Reader structure
+struct PackageReader {
+    HeapHandle heap;
+    InflateHandle inflater;
+    int state;
+    const char* error;
+
+    // Fixed-size records (local header, data descriptor) gathered across chunks
+    unsigned char record[LOCAL_HEADER_SIZE];
+    unsigned int record_len;
+
+    // Current entry, from its local header
+    unsigned int flags;
+    unsigned int method;
+    unsigned int crc;
+    unsigned int compressed_size;
+    unsigned int size;
+    char* name;
+    unsigned int name_len;
+    unsigned int name_pos;
+    unsigned int extra_remaining;
+
+    // Current entry's data
+    unsigned int remaining;         // Compressed bytes still to come, if known
+    int inflate_done;
+    HeapOffset dest;
+    unsigned int written;
+    unsigned char* unsized;         // Growing buffer for entries without a size
+    unsigned int unsized_capacity;
+
+    // Checksums of the current entry, updated as its output is written so
+    // nothing has to read the bytes again once the entry is complete
+    unsigned int hashed;            // Output bytes checksummed so far
+    unsigned int running_crc;
+    Sha256 sha;
+
+    ExpectedDigest* expected;
+    int expected_count;
+    ExpectedSizes* expected_sizes;
+    int expected_sizes_count;
+
+    PackageEntry* entries;
+    int entry_count;
+    int entry_capacity;
+};
+
+static unsigned int crc_table[256];
+static int crc_table_ready = 0;
+
+// Continue a CRC-32; start from 0xffffffff and invert the final value
+static unsigned int crc32_update(unsigned int crc, const unsigned char* data, unsigned int size) {
+    unsigned int i;
+
+    if (!crc_table_ready) {
+        unsigned int n, k, c;
+        for (n = 0; n < 256; n++) {
+            c = n;
+            for (k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            crc_table[n] = c;
+        }
+        crc_table_ready = 1;
+    }
+
+    for (i = 0; i < size; i++) crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+static unsigned int read_u16(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned int read_u32(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static PackageStatus reader_fail(struct PackageReader* reader, const char* message) {
+    reader->error = message;
+    reader->state = READ_ERROR;
+    return PACKAGE_ERROR;
+}
+
+// Gather `size` bytes of a fixed-size record; returns bytes used from data
+static unsigned int gather_record(struct PackageReader* reader, const unsigned char* data, unsigned int available, unsigned int size) {
+    unsigned int n = size - reader->record_len;
+    if (n > available) n = available;
+    memcpy(reader->record + reader->record_len, data, n);
+    reader->record_len += n;
+    return n;
+}
+
+// Destination of the current entry's output
+static unsigned char* entry_output(struct PackageReader* reader) {
+    if (reader->unsized) return reader->unsized;
+    return (unsigned char*)heap_ptr(reader->heap, reader->dest, reader->size);
+}
+
+static unsigned int entry_capacity(struct PackageReader* reader) {
+    return reader->unsized ? reader->unsized_capacity : reader->size;
+}
+
+// Checksum output written since the last call, while it's still in cache
+static void checksum_output(struct PackageReader* reader, unsigned int written) {
+    const unsigned char* data;
+    if (written <= reader->hashed) return;
+
+    data = entry_output(reader) + reader->hashed;
+    reader->running_crc = crc32_update(reader->running_crc, data, written - reader->hashed);
+    sha256_update(&reader->sha, data, written - reader->hashed);
+    reader->hashed = written;
+}
+
+static PackageStatus parse_local_header(struct PackageReader* reader) {
+    const unsigned char* header = reader->record;
+
+    reader->flags = read_u16(header + 6);
+    reader->method = read_u16(header + 8);
+    reader->crc = read_u32(header + 14);
+    reader->compressed_size = read_u32(header + 18);
+    reader->size = read_u32(header + 22);
+    reader->name_len = read_u16(header + 26);
+    reader->extra_remaining = read_u16(header + 28);
+    reader->name_pos = 0;
+
+    if (reader->flags & FLAG_ENCRYPTED) return reader_fail(reader, "encrypted entries are not supported");
+    if (reader->method != METHOD_STORED && reader->method != METHOD_DEFLATE) {
+        return reader_fail(reader, "unsupported compression method");
+    }
+    // Entries with a data descriptor have their sizes resolved once the name is known
+    if (!(reader->flags & FLAG_DATA_DESCRIPTOR) &&
+        (reader->compressed_size == 0xffffffffu || reader->size == 0xffffffffu)) {
+        return reader_fail(reader, "ZIP64 entries are not supported");
+    }
+
+    free(reader->name);
+    reader->name = (char*)malloc(reader->name_len + 1);
+    if (!reader->name) return reader_fail(reader, "out of memory");
+    reader->name[reader->name_len] = '\0';
+
+    reader->state = READ_NAME;
+    return PACKAGE_OK;
+}
+
+static int entry_is_directory(const struct PackageReader* reader) {
+    return reader->name_len > 0 && reader->name[reader->name_len - 1] == '/';
+}
+
+static const ExpectedSizes* find_expected_sizes(const struct PackageReader* reader) {
+    int i;
+    for (i = 0; i < reader->expected_sizes_count; i++) {
+        if (strcmp(reader->expected_sizes[i].name, reader->name) == 0) return &reader->expected_sizes[i];
+    }
+    return NULL;
+}
+
+// Verify the entry and add it to the table
+static PackageStatus finish_entry(struct PackageReader* reader) {
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    int i;
+
+    if (reader->written != reader->size) return reader_fail(reader, "entry size mismatch");
+
+    checksum_output(reader, reader->written);
+    if ((reader->running_crc ^ 0xffffffffu) != reader->crc) return reader_fail(reader, "entry checksum mismatch");
+    sha256_final(&reader->sha, digest);
+
+    for (i = 0; i < reader->expected_count; i++) {
+        if (strcmp(reader->expected[i].name, reader->name) != 0) continue;
+        if (memcmp(reader->expected[i].digest, digest, SHA256_DIGEST_SIZE) != 0) {
+            return reader_fail(reader, "entry digest mismatch");
+        }
+        break;
+    }
+
+    // Entries without a size move into the heap now that it's known
+    if (reader->unsized) {
+        if (reader->size > 0) {
+            reader->dest = heap_alloc(reader->heap, reader->size, 8);
+            if (!reader->dest) return reader_fail(reader, "out of memory");
+            memcpy(heap_ptr(reader->heap, reader->dest, reader->size), reader->unsized, reader->size);
+        }
+        free(reader->unsized);
+        reader->unsized = NULL;
+        reader->unsized_capacity = 0;
+    }
+
+    // Directories have no data worth listing
+    if (!entry_is_directory(reader)) {
+        PackageEntry* entry;
+
+        if (reader->entry_count == reader->entry_capacity) {
+            int capacity = reader->entry_capacity ? reader->entry_capacity * 2 : 16;
+            PackageEntry* entries = (PackageEntry*)realloc(reader->entries, capacity * sizeof(PackageEntry));
+            if (!entries) return reader_fail(reader, "out of memory");
+            reader->entries = entries;
+            reader->entry_capacity = capacity;
+        }
+
+        entry = &reader->entries[reader->entry_count++];
+        entry->name = reader->name;
+        entry->offset = reader->dest;
+        entry->size = reader->size;
+        memcpy(entry->digest, digest, SHA256_DIGEST_SIZE);
+        reader->name = NULL;
+    }
+
+    reader->record_len = 0;
+    reader->state = READ_HEADER;
+    return PACKAGE_OK;
+}
+
+// All of a sized entry's data has arrived
+static PackageStatus end_sized_data(struct PackageReader* reader) {
+    if (reader->method == METHOD_DEFLATE && !reader->inflate_done) {
+        return reader_fail(reader, "truncated deflate stream");
+    }
+    if (reader->flags & FLAG_DATA_DESCRIPTOR) {
+        reader->record_len = 0;
+        reader->state = READ_DESCRIPTOR;
+        return PACKAGE_OK;
+    }
+    return finish_entry(reader);
+}
+
+// Allocate the entry's destination once its header has been read
+static PackageStatus begin_entry_data(struct PackageReader* reader) {
+    int sized = 1;
+
+    reader->written = 0;
+    reader->inflate_done = 0;
+    reader->dest = 0;
+    reader->hashed = 0;
+    reader->running_crc = 0xffffffffu;
+    sha256_init(&reader->sha);
+
+    // Streamed entries leave their sizes zero until the data descriptor.
+    // The central directory has them, when it's been registered; otherwise
+    // a deflate stream marks its own end, and stored data can only be found
+    // to end for a directory, which has none.
+    if (reader->flags & FLAG_DATA_DESCRIPTOR) {
+        const ExpectedSizes* sizes = find_expected_sizes(reader);
+        if (sizes) {
+            reader->compressed_size = sizes->compressed_size;
+            reader->size = sizes->size;
+            if (reader->compressed_size == 0xffffffffu || reader->size == 0xffffffffu) {
+                return reader_fail(reader, "ZIP64 entries are not supported");
+            }
+        } else if (reader->method == METHOD_DEFLATE) {
+            sized = 0;
+        } else if (entry_is_directory(reader)) {
+            reader->compressed_size = 0;
+            reader->size = 0;
+        } else {
+            return reader_fail(reader, "stored entry without sizes");
+        }
+    }
+
+    if (!sized) {
+        reader->unsized = (unsigned char*)malloc(UNSIZED_INITIAL_CAPACITY);
+        if (!reader->unsized) return reader_fail(reader, "out of memory");
+        reader->unsized_capacity = UNSIZED_INITIAL_CAPACITY;
+        reader->remaining = 0;
+    } else {
+        if (reader->size > 0) {
+            reader->dest = heap_alloc(reader->heap, reader->size, 8);
+            if (!reader->dest) return reader_fail(reader, "out of memory");
+        }
+        reader->remaining = reader->compressed_size;
+        if (reader->method == METHOD_STORED && reader->compressed_size != reader->size) {
+            return reader_fail(reader, "stored entry size mismatch");
+        }
+    }
+
+    if (reader->method == METHOD_DEFLATE) {
+        inflate_reset(reader->inflater, entry_output(reader), entry_capacity(reader));
+    }
+
+    reader->state = READ_DATA;
+
+    // Nothing to wait for; an empty entry may end its byte range here
+    if (sized && reader->remaining == 0) return end_sized_data(reader);
+    return PACKAGE_OK;
+}
+
+// Move past a name and extra field that are complete, without waiting for
+// more input. A byte range can end right after an empty entry's name.
+static void skip_empty_fields(struct PackageReader* reader) {
+    if (reader->state == READ_NAME && reader->name_pos == reader->name_len) reader->state = READ_EXTRA;
+    if (reader->state == READ_EXTRA && reader->extra_remaining == 0) begin_entry_data(reader);
+}
+
+// Consume entry data from `data`; returns bytes used
+static unsigned int read_entry_data(struct PackageReader* reader, const unsigned char* data, unsigned int available) {
+    unsigned int n;
+    InflateStatus status;
+
+    if (reader->unsized) {
+        unsigned int used = 0;
+
+        // The deflate stream itself marks the end of the entry
+        for (;;) {
+            inflate_set_output(reader->inflater, reader->unsized, reader->unsized_capacity);
+            status = inflate_push(reader->inflater, data, available);
+            n = inflate_consumed(reader->inflater);
+            used += n;
+
+            // Before the buffer can move
+            checksum_output(reader, inflate_output_size(reader->inflater));
+
+            if (status == INFLATE_NEED_OUTPUT) {
+                unsigned char* grown = (unsigned char*)realloc(reader->unsized, reader->unsized_capacity * 2);
+                if (!grown) {
+                    reader_fail(reader, "out of memory");
+                    return used;
+                }
+                reader->unsized = grown;
+                reader->unsized_capacity *= 2;
+                data += n;
+                available -= n;
+                continue;
+            }
+
+            if (status == INFLATE_ERROR) {
+                reader_fail(reader, inflate_error(reader->inflater));
+            } else if (status == INFLATE_DONE) {
+                reader->written = inflate_output_size(reader->inflater);
+                reader->record_len = 0;
+                reader->state = READ_DESCRIPTOR;
+            }
+            return used;
+        }
+    }
+
+    n = available < reader->remaining ? available : reader->remaining;
+    reader->remaining -= n;
+
+    if (reader->method == METHOD_STORED) {
+        if (n > 0) memcpy(entry_output(reader) + reader->written, data, n);
+        reader->written += n;
+        checksum_output(reader, reader->written);
+    } else if (!reader->inflate_done) {
+        // Re-resolve the destination; other heap allocations may have moved it
+        inflate_set_output(reader->inflater, entry_output(reader), reader->size);
+        status = inflate_push(reader->inflater, data, n);
+
+        if (status == INFLATE_ERROR) {
+            reader_fail(reader, inflate_error(reader->inflater));
+            return n;
+        }
+        if (status == INFLATE_NEED_OUTPUT) {
+            reader_fail(reader, "entry larger than declared");
+            return n;
+        }
+        reader->inflate_done = status == INFLATE_DONE;
+        reader->written = inflate_output_size(reader->inflater);
+        checksum_output(reader, reader->written);
+    }
+
+    if (reader->remaining == 0) end_sized_data(reader);
+    return n;
+}
+
+EMSCRIPTEN_KEEPALIVE PackageReaderHandle package_reader_create(HeapHandle heap) {
+    struct PackageReader* reader;
+    if (!heap) return NULL;
+
+    reader = (struct PackageReader*)calloc(1, sizeof(struct PackageReader));
+    if (!reader) return NULL;
+
+    reader->inflater = inflate_create();
+    if (!reader->inflater) {
+        free(reader);
+        return NULL;
+    }
+
+    reader->heap = heap;
+    reader->state = READ_HEADER;
+    return reader;
+}
+
+EMSCRIPTEN_KEEPALIVE void package_reader_destroy(PackageReaderHandle reader) {
+    int i;
+    if (!reader) return;
+
+    for (i = 0; i < reader->entry_count; i++) free(reader->entries[i].name);
+    free(reader->entries);
+    for (i = 0; i < reader->expected_count; i++) free(reader->expected[i].name);
+    free(reader->expected);
+    for (i = 0; i < reader->expected_sizes_count; i++) free(reader->expected_sizes[i].name);
+    free(reader->expected_sizes);
+    free(reader->name);
+    free(reader->unsized);
+    inflate_destroy(reader->inflater);
+    free(reader);
+}
+
+EMSCRIPTEN_KEEPALIVE int package_reader_expect(PackageReaderHandle reader, const char* name, const unsigned char* digest) {
+    ExpectedDigest* expected;
+    size_t length;
+    if (!reader || !name || !digest) return 0;
+
+    expected = (ExpectedDigest*)realloc(reader->expected, (reader->expected_count + 1) * sizeof(ExpectedDigest));
+    if (!expected) return 0;
+    reader->expected = expected;
+
+    length = strlen(name);
+    expected = &reader->expected[reader->expected_count];
+    expected->name = (char*)malloc(length + 1);
+    if (!expected->name) return 0;
+    memcpy(expected->name, name, length + 1);
+    memcpy(expected->digest, digest, SHA256_DIGEST_SIZE);
+    reader->expected_count++;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int package_reader_expect_sizes(PackageReaderHandle reader, const char* name,
+                                                     unsigned int compressed_size, unsigned int size) {
+    ExpectedSizes* expected;
+    size_t length;
+    if (!reader || !name) return 0;
+
+    expected = (ExpectedSizes*)realloc(reader->expected_sizes, (reader->expected_sizes_count + 1) * sizeof(ExpectedSizes));
+    if (!expected) return 0;
+    reader->expected_sizes = expected;
+
+    length = strlen(name);
+    expected = &reader->expected_sizes[reader->expected_sizes_count];
+    expected->name = (char*)malloc(length + 1);
+    if (!expected->name) return 0;
+    memcpy(expected->name, name, length + 1);
+    expected->compressed_size = compressed_size;
+    expected->size = size;
+    reader->expected_sizes_count++;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE PackageStatus package_reader_push(PackageReaderHandle reader, const unsigned char* data, unsigned int size) {
+    unsigned int pos = 0;
+    if (!reader) return PACKAGE_ERROR;
+
+    while (reader->state != READ_DONE && reader->state != READ_ERROR && pos < size) {
+        const unsigned char* p = data + pos;
+        unsigned int available = size - pos;
+        unsigned int n;
+
+        switch (reader->state) {
+            case READ_HEADER:
+                pos += gather_record(reader, p, available, LOCAL_HEADER_SIZE);
+                if (reader->record_len >= 4 && read_u32(reader->record) != SIG_LOCAL_HEADER) {
+                    unsigned int signature = read_u32(reader->record);
+                    if (signature == SIG_CENTRAL_HEADER || signature == SIG_END_OF_CENTRAL) {
+                        reader->state = READ_DONE;
+                    } else {
+                        reader_fail(reader, "invalid local header signature");
+                    }
+                } else if (reader->record_len == LOCAL_HEADER_SIZE) {
+                    if (parse_local_header(reader) == PACKAGE_OK) skip_empty_fields(reader);
+                }
+                break;
+
+            case READ_NAME:
+                n = reader->name_len - reader->name_pos;
+                if (n > available) n = available;
+                memcpy(reader->name + reader->name_pos, p, n);
+                reader->name_pos += n;
+                pos += n;
+                skip_empty_fields(reader);
+                break;
+
+            case READ_EXTRA:
+                n = reader->extra_remaining < available ? reader->extra_remaining : available;
+                reader->extra_remaining -= n;
+                pos += n;
+                if (reader->extra_remaining == 0) begin_entry_data(reader);
+                break;
+
+            case READ_DATA: {
+                int unsized = reader->unsized != NULL;
+                pos += read_entry_data(reader, p, available);
+
+                // Bytes the inflater read past the end of the stream belong to
+                // the descriptor and whatever follows it
+                if (unsized && reader->state == READ_DESCRIPTOR) {
+                    unsigned char leftover[INFLATE_MAX_LEFTOVER];
+                    const unsigned char* bytes;
+                    unsigned int count = inflate_leftover(reader->inflater, &bytes);
+                    if (count > 0) {
+                        memcpy(leftover, bytes, count);
+                        if (package_reader_push(reader, leftover, count) == PACKAGE_ERROR) return PACKAGE_ERROR;
+                    }
+                }
+                break;
+            }
+
+            case READ_DESCRIPTOR: {
+                // The signature is optional, so its presence decides the length
+                unsigned int length = 12;
+                if (reader->record_len < 4) {
+                    pos += gather_record(reader, p, available, 4);
+                    break;
+                }
+                if (read_u32(reader->record) == SIG_DATA_DESCRIPTOR) length = 16;
+                pos += gather_record(reader, p, available, length);
+
+                if (reader->record_len == length) {
+                    const unsigned char* fields = reader->record + (length - 12);
+                    reader->crc = read_u32(fields);
+                    reader->compressed_size = read_u32(fields + 4);
+                    reader->size = read_u32(fields + 8);
+                    finish_entry(reader);
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    if (reader->state == READ_ERROR) return PACKAGE_ERROR;
+    return reader->state == READ_DONE ? PACKAGE_DONE : PACKAGE_OK;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* package_reader_error(PackageReaderHandle reader) {
+    if (!reader) return "no reader";
+    return reader->error ? reader->error : "";
+}
+
+EMSCRIPTEN_KEEPALIVE int package_entry_count(PackageReaderHandle reader) {
+    return reader ? reader->entry_count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* package_entry_name(PackageReaderHandle reader, int index) {
+    if (!reader || index < 0 || index >= reader->entry_count) return NULL;
+    return reader->entries[index].name;
+}
+
+EMSCRIPTEN_KEEPALIVE HeapOffset package_entry_offset(PackageReaderHandle reader, int index) {
+    if (!reader || index < 0 || index >= reader->entry_count) return 0;
+    return reader->entries[index].offset;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int package_entry_size(PackageReaderHandle reader, int index) {
+    if (!reader || index < 0 || index >= reader->entry_count) return 0;
+    return reader->entries[index].size;
+}
+
+EMSCRIPTEN_KEEPALIVE const unsigned char* package_entry_digest(PackageReaderHandle reader, int index) {
+    if (!reader || index < 0 || index >= reader->entry_count) return NULL;
+    return reader->entries[index].digest;
+}
+
+EMSCRIPTEN_KEEPALIVE int package_find_entry(PackageReaderHandle reader, const char* name) {
+    int i;
+    if (!reader || !name) return -1;
+
+    for (i = 0; i < reader->entry_count; i++) {
+        if (strcmp(reader->entries[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// Central directory index
+
+#define END_OF_CENTRAL_SIZE 22
+#define CENTRAL_HEADER_SIZE 46
+
+// Indexed entry
+typedef struct {
+    char* name;
+    unsigned int compressed_size;
+    unsigned int size;
+    unsigned int start;     // Local header offset
+    unsigned int end;       // Next record's offset
+} IndexEntry;
+
+// Index structure
+struct PackageIndex {
+    IndexEntry* entries;
+    int count;
+};
+
+static int compare_offsets(const void* a, const void* b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return x < y ? -1 : x > y;
+}
+
+EMSCRIPTEN_KEEPALIVE int package_locate_directory(const unsigned char* tail, unsigned int tail_size, unsigned int archive_size, unsigned int* range) {
+    unsigned int pos, tail_start, offset, size;
+
+    if (!tail || !range || tail_size < END_OF_CENTRAL_SIZE || tail_size > archive_size) return 0;
+    tail_start = archive_size - tail_size;
+
+    // The record is followed by a comment of up to 64K, so scan backwards
+    // for a signature whose comment length reaches exactly to the end
+    for (pos = tail_size - END_OF_CENTRAL_SIZE + 1; pos-- > 0;) {
+        const unsigned char* record = tail + pos;
+        if (read_u32(record) != SIG_END_OF_CENTRAL) continue;
+        if (pos + END_OF_CENTRAL_SIZE + read_u16(record + 20) != tail_size) continue;
+
+        size = read_u32(record + 12);
+        offset = read_u32(record + 16);
+        if (offset == 0xffffffffu || size == 0xffffffffu) return 0;
+        if (offset > tail_start + pos || size > tail_start + pos - offset) return 0;
+
+        range[0] = offset;
+        range[1] = size;
+        return 1;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE PackageIndexHandle package_index_create(const unsigned char* directory, unsigned int size, unsigned int directory_offset) {
+    struct PackageIndex* index;
+    unsigned int* starts;
+    unsigned int pos = 0;
+    int capacity = 16;
+    int i;
+
+    if (!directory) return NULL;
+
+    index = (struct PackageIndex*)calloc(1, sizeof(struct PackageIndex));
+    if (!index) return NULL;
+    index->entries = (IndexEntry*)malloc(capacity * sizeof(IndexEntry));
+    if (!index->entries) {
+        free(index);
+        return NULL;
+    }
+
+    while (pos + CENTRAL_HEADER_SIZE <= size && read_u32(directory + pos) == SIG_CENTRAL_HEADER) {
+        const unsigned char* header = directory + pos;
+        unsigned int name_len = read_u16(header + 28);
+        unsigned int record_len = CENTRAL_HEADER_SIZE + name_len + read_u16(header + 30) + read_u16(header + 32);
+        IndexEntry* entry;
+
+        if (record_len > size - pos) break;
+        pos += record_len;
+
+        // Directories have no data worth listing
+        if (name_len > 0 && header[CENTRAL_HEADER_SIZE + name_len - 1] == '/') continue;
+
+        if (index->count == capacity) {
+            IndexEntry* entries = (IndexEntry*)realloc(index->entries, capacity * 2 * sizeof(IndexEntry));
+            if (!entries) break;
+            index->entries = entries;
+            capacity *= 2;
+        }
+
+        entry = &index->entries[index->count];
+        entry->name = (char*)malloc(name_len + 1);
+        if (!entry->name) break;
+        memcpy(entry->name, header + CENTRAL_HEADER_SIZE, name_len);
+        entry->name[name_len] = '\0';
+        entry->compressed_size = read_u32(header + 20);
+        entry->size = read_u32(header + 24);
+        entry->start = read_u32(header + 42);
+        entry->end = directory_offset;
+        index->count++;
+    }
+
+    if (pos != size) {
+        package_index_destroy(index);
+        return NULL;
+    }
+
+    // A record runs up to the next record in the archive, which takes in the
+    // data descriptor without having to parse the local header first
+    starts = (unsigned int*)malloc((index->count > 0 ? index->count : 1) * sizeof(unsigned int));
+    if (!starts) {
+        package_index_destroy(index);
+        return NULL;
+    }
+    for (i = 0; i < index->count; i++) starts[i] = index->entries[i].start;
+    qsort(starts, index->count, sizeof(unsigned int), compare_offsets);
+    for (i = 0; i < index->count; i++) {
+        IndexEntry* entry = &index->entries[i];
+        int low = 0, high = index->count;
+
+        // First start past this one
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (starts[mid] <= entry->start) low = mid + 1;
+            else high = mid;
+        }
+        if (low < index->count) entry->end = starts[low];
+    }
+    free(starts);
+
+    for (i = 0; i < index->count; i++) {
+        if (index->entries[i].start >= index->entries[i].end) {
+            package_index_destroy(index);
+            return NULL;
+        }
+    }
+
+    return index;
+}
+
+EMSCRIPTEN_KEEPALIVE void package_index_destroy(PackageIndexHandle index) {
+    int i;
+    if (!index) return;
+
+    for (i = 0; i < index->count; i++) free(index->entries[i].name);
+    free(index->entries);
+    free(index);
+}
+
+EMSCRIPTEN_KEEPALIVE int package_index_count(PackageIndexHandle index) {
+    return index ? index->count : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* package_index_name(PackageIndexHandle index, int entry) {
+    if (!index || entry < 0 || entry >= index->count) return NULL;
+    return index->entries[entry].name;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int package_index_size(PackageIndexHandle index, int entry) {
+    if (!index || entry < 0 || entry >= index->count) return 0;
+    return index->entries[entry].size;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int package_index_compressed_size(PackageIndexHandle index, int entry) {
+    if (!index || entry < 0 || entry >= index->count) return 0;
+    return index->entries[entry].compressed_size;
+}
+
+EMSCRIPTEN_KEEPALIVE int package_index_find(PackageIndexHandle index, const char* name) {
+    int i;
+    if (!index || !name) return -1;
+
+    for (i = 0; i < index->count; i++) {
+        if (strcmp(index->entries[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int package_index_range_start(PackageIndexHandle index, int entry) {
+    if (!index || entry < 0 || entry >= index->count) return 0;
+    return index->entries[entry].start;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int package_index_range_end(PackageIndexHandle index, int entry) {
+    if (!index || entry < 0 || entry >= index->count) return 0;
+    return index->entries[entry].end;
+}
@@ -0,0 +1,310 @@
+#include <stdlib.h>
+#include <emscripten.h>
+#include "pipeline.h"
+#include "spsc.h"
+
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#define PIPELINE_THREADS 1
+#else
+#define PIPELINE_THREADS 0
+#endif
+
+// Pipeline structure
+struct FramePipeline {
+    FramePacket packets[PIPELINE_PACKETS];
+    int width;
+    int height;
+    int rasterize;
+    int latency;
+
+    // Packets not in flight, owned by the submitting thread
+    int free_packets[PIPELINE_PACKETS];
+    int free_count;
+    int recording;              // Packet being recorded, or -1
+    int in_flight;              // Submitted but not yet presented or dropped
+    int next_frame;
+
+    SpscQueue raster_queue;     // Submitting thread -> worker
+    SpscQueue done_queue;       // Worker -> submitting thread
+
+    int presented;
+    int dropped;
+
+    FramePresentCallback present;
+    void* context;
+
+    RasterCacheHandle raster_cache; // Used by whichever thread rasterizes
+
+#if PIPELINE_THREADS
+    pthread_t worker;
+    sem_t work;                 // Posted once per packet queued, and to stop
+    int stopping;
+    int has_worker;
+#endif
+};
+
+// The rasterize stage
+static void rasterize_packet(struct FramePipeline* pipeline, FramePacket* packet) {
+    raster_clear(&packet->framebuffer, 0);
+    raster_draw_list(&packet->framebuffer, packet->list, pipeline->raster_cache);
+    raster_unpremultiply(&packet->framebuffer);
+}
+
+#if PIPELINE_THREADS
+static void* raster_worker(void* arg) {
+    struct FramePipeline* pipeline = (struct FramePipeline*)arg;
+    int index;
+
+    for (;;) {
+        sem_wait(&pipeline->work);
+        if (__atomic_load_n(&pipeline->stopping, __ATOMIC_ACQUIRE)) break;
+        if (!spsc_pop(&pipeline->raster_queue, &index)) continue;
+
+        rasterize_packet(pipeline, &pipeline->packets[index]);
+        // Can't be full: there are fewer packets than slots
+        spsc_push(&pipeline->done_queue, index);
+    }
+    return NULL;
+}
+#endif
+
+static int use_worker(struct FramePipeline* pipeline) {
+#if PIPELINE_THREADS
+    return pipeline->has_worker && pipeline->rasterize;
+#else
+    (void)pipeline;
+    return 0;
+#endif
+}
+
+// Take finished frames off the done queue until at least `required` have
+// been retired, then present the newest and drop the rest
+static void collect_frames(struct FramePipeline* pipeline, int required) {
+    int newest = -1;
+    int retired = 0;
+    int index;
+
+    for (;;) {
+        while (spsc_pop(&pipeline->done_queue, &index)) {
+            if (newest >= 0) {
+                pipeline->free_packets[pipeline->free_count++] = newest;
+                pipeline->dropped++;
+            }
+            newest = index;
+            retired++;
+        }
+        if (retired >= required) break;
+
+#if PIPELINE_THREADS
+        // Only reachable with a worker: wait for it to finish the oldest frame
+        sched_yield();
+#else
+        break;
+#endif
+    }
+
+    pipeline->in_flight -= retired;
+    if (newest >= 0) {
+        if (pipeline->present) pipeline->present(pipeline->context, &pipeline->packets[newest]);
+        pipeline->presented++;
+        pipeline->free_packets[pipeline->free_count++] = newest;
+    }
+}
+
+// Present everything in flight so packets can be changed safely
+static void drain(struct FramePipeline* pipeline) {
+    if (pipeline->in_flight > 0) collect_frames(pipeline, pipeline->in_flight);
+}
+
+static void release_framebuffers(struct FramePipeline* pipeline) {
+    int i;
+    for (i = 0; i < PIPELINE_PACKETS; i++) framebuffer_release(&pipeline->packets[i].framebuffer);
+}
+
+static int allocate_framebuffers(struct FramePipeline* pipeline) {
+    int i;
+    for (i = 0; i < PIPELINE_PACKETS; i++) {
+        if (framebuffer_init_format(&pipeline->packets[i].framebuffer, pipeline->width, pipeline->height,
+                                    FLARE_PIXEL_FORMAT) != 0) {
+            release_framebuffers(pipeline);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE FramePipelineHandle pipeline_create(int width, int height, int rasterize,
+                                                         FramePresentCallback present, void* context) {
+    struct FramePipeline* pipeline;
+    int i;
+
+    if (width <= 0 || height <= 0) return NULL;
+
+    pipeline = (struct FramePipeline*)calloc(1, sizeof(struct FramePipeline));
+    if (!pipeline) return NULL;
+
+    pipeline->width = width;
+    pipeline->height = height;
+    pipeline->present = present;
+    pipeline->context = context;
+    pipeline->recording = -1;
+    spsc_init(&pipeline->raster_queue);
+    spsc_init(&pipeline->done_queue);
+
+    for (i = 0; i < PIPELINE_PACKETS; i++) {
+        pipeline->packets[i].list = draw_list_create();
+        if (!pipeline->packets[i].list) {
+            pipeline_destroy(pipeline);
+            return NULL;
+        }
+        pipeline->free_packets[pipeline->free_count++] = i;
+    }
+    pipeline->raster_cache = raster_cache_create();
+    if (!pipeline->raster_cache) {
+        pipeline_destroy(pipeline);
+        return NULL;
+    }
+
+#if PIPELINE_THREADS
+    // A frame of latency lets evaluation and rasterization overlap
+    if (sem_init(&pipeline->work, 0, 0) == 0) {
+        if (pthread_create(&pipeline->worker, NULL, raster_worker, pipeline) == 0) {
+            pipeline->has_worker = 1;
+            pipeline->latency = 1;
+        } else {
+            sem_destroy(&pipeline->work);
+        }
+    }
+#endif
+
+    if (pipeline_set_rasterize(pipeline, rasterize) != 0) {
+        pipeline_destroy(pipeline);
+        return NULL;
+    }
+    return pipeline;
+}
+
+EMSCRIPTEN_KEEPALIVE void pipeline_destroy(FramePipelineHandle pipeline) {
+    int i;
+    if (!pipeline) return;
+
+#if PIPELINE_THREADS
+    if (pipeline->has_worker) {
+        drain(pipeline);
+        __atomic_store_n(&pipeline->stopping, 1, __ATOMIC_RELEASE);
+        sem_post(&pipeline->work);
+        pthread_join(pipeline->worker, NULL);
+        sem_destroy(&pipeline->work);
+    }
+#endif
+
+    for (i = 0; i < PIPELINE_PACKETS; i++) draw_list_destroy(pipeline->packets[i].list);
+    release_framebuffers(pipeline);
+    raster_cache_destroy(pipeline->raster_cache);
+    free(pipeline);
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_threaded(FramePipelineHandle pipeline) {
+#if PIPELINE_THREADS
+    return pipeline ? pipeline->has_worker : 0;
+#else
+    (void)pipeline;
+    return 0;
+#endif
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_set_latency(FramePipelineHandle pipeline, int frames) {
+    if (!pipeline || frames < 0 || frames > PIPELINE_PACKETS - 1) return -1;
+
+    pipeline->latency = frames;
+    // Catch up right away if the new latency is shorter
+    if (pipeline->in_flight > frames) collect_frames(pipeline, pipeline->in_flight - frames);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_latency(FramePipelineHandle pipeline) {
+    return pipeline ? pipeline->latency : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_set_rasterize(FramePipelineHandle pipeline, int rasterize) {
+    if (!pipeline) return -1;
+    rasterize = rasterize != 0;
+    if (rasterize == pipeline->rasterize) return 0;
+
+    drain(pipeline);
+    release_framebuffers(pipeline);
+    pipeline->rasterize = 0;
+
+    if (rasterize) {
+        if (allocate_framebuffers(pipeline) != 0) return -1;
+        pipeline->rasterize = 1;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_resize(FramePipelineHandle pipeline, int width, int height) {
+    if (!pipeline || width <= 0 || height <= 0) return -1;
+
+    drain(pipeline);
+    pipeline->width = width;
+    pipeline->height = height;
+    if (!pipeline->rasterize) return 0;
+
+    release_framebuffers(pipeline);
+    if (allocate_framebuffers(pipeline) != 0) {
+        pipeline->rasterize = 0;
+        return -1;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE DrawListHandle pipeline_begin_frame(FramePipelineHandle pipeline) {
+    if (!pipeline) return NULL;
+
+    if (pipeline->recording < 0) {
+        // Latency is capped below the packet count, so one is always free
+        if (pipeline->free_count == 0) return NULL;
+        pipeline->recording = pipeline->free_packets[--pipeline->free_count];
+    }
+
+    draw_list_reset(pipeline->packets[pipeline->recording].list);
+    return pipeline->packets[pipeline->recording].list;
+}
+
+EMSCRIPTEN_KEEPALIVE void pipeline_submit_frame(FramePipelineHandle pipeline) {
+    FramePacket* packet;
+    int index, latency;
+
+    if (!pipeline || pipeline->recording < 0) return;
+
+    index = pipeline->recording;
+    pipeline->recording = -1;
+    packet = &pipeline->packets[index];
+    packet->frame = pipeline->next_frame++;
+    pipeline->in_flight++;
+
+    if (use_worker(pipeline)) {
+#if PIPELINE_THREADS
+        spsc_push(&pipeline->raster_queue, index);
+        sem_post(&pipeline->work);
+#endif
+        latency = pipeline->latency;
+    } else {
+        if (pipeline->rasterize) rasterize_packet(pipeline, packet);
+        spsc_push(&pipeline->done_queue, index);
+        latency = 0;
+    }
+
+    collect_frames(pipeline, pipeline->in_flight - latency);
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_presented_frames(FramePipelineHandle pipeline) {
+    return pipeline ? pipeline->presented : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int pipeline_dropped_frames(FramePipelineHandle pipeline) {
+    return pipeline ? pipeline->dropped : 0;
+}
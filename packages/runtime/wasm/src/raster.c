@@ -0,0 +1,1379 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <emscripten.h>
+#include "raster.h"
+#include "simd.h"
+
+// Offscreen tiles for isolated groups, one per nesting level. Groups nested
+// deeper are drawn straight into their parent's tile.
+#define RASTER_GROUP_TILES 4
+
+// Limits on filters, which keep group tiles from growing without bound:
+// blur standard deviation, and shadow offset, in pixels
+#define RASTER_BLUR_MAX 64.0f
+#define RASTER_SHADOW_MAX 1024.0f
+
+// Coverage of one mask, with the shapes it was rasterized from
+typedef struct {
+    int valid;
+    unsigned int mode;              // DrawMaskMode
+    int left, top, right, bottom;   // Bounds in target pixels
+    float dx, dy;                   // Offset the shapes were drawn at
+    DrawCommand* shapes;
+    int shape_count;
+    int shape_capacity;
+    unsigned char* coverage;        // One byte per pixel of the bounds
+    size_t coverage_capacity;
+} MaskEntry;
+
+// A group's blurred drop shadow, with the commands it was drawn from
+typedef struct {
+    int valid;
+    int left, top, right, bottom;   // The group's tile, in target pixels
+    float dx, dy;
+    DrawCommand* commands;          // The group's filters and children
+    int command_count;
+    int command_capacity;
+    float* matrices;                // Their color matrices, in order
+    int matrix_capacity;
+    unsigned int* pixels;           // Premultiplied shadow over the tile
+    size_t pixel_capacity;
+} ShadowEntry;
+
+// Raster cache structure
+struct RasterCache {
+    MaskEntry* masks;               // By the order masks come in the frame
+    int mask_count;
+    unsigned int* scratch;          // Offscreen pixels for masked commands
+    size_t scratch_capacity;
+    unsigned int* tiles[RASTER_GROUP_TILES];
+    size_t tile_capacity[RASTER_GROUP_TILES];
+    ShadowEntry* shadows;           // By the order shadows come in the frame
+    int shadow_count;
+    unsigned int* blur_scratch;     // One blur pass's output
+    size_t blur_scratch_capacity;
+    unsigned int* blur_sums;        // Column sums, four per pixel of a row
+    size_t blur_sums_capacity;
+};
+
+// A mask and the commands drawn through it, as indices into a draw list
+typedef struct {
+    unsigned int mode;
+    int shapes;
+    int shape_count;
+    int content;
+    int content_count;
+    int next;                       // First command after the group
+} MaskGroup;
+
+// What the commands of a range are drawn with
+typedef struct {
+    float dx, dy;                   // Offset from draw list to target coordinates
+    unsigned int alpha;             // Opacity folded into every color, 0-255
+    int depth;                      // Group tiles in use
+    int* masks;                     // Masks drawn so far this frame
+    int* shadows;                   // Shadows drawn so far this frame
+    const float* matrices;          // The draw list's color matrices
+    int matrix_count;
+} DrawState;
+
+// Multiply each channel of a pixel by a / 255, rounded, two channels at a time
+static inline unsigned int scale_pixel(unsigned int pixel, unsigned int a) {
+    unsigned int rb = (pixel & 0x00ff00ffu) * a + 0x00800080u;
+    unsigned int ag = ((pixel >> 8) & 0x00ff00ffu) * a + 0x00800080u;
+    rb = ((rb + ((rb >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+    ag = (ag + ((ag >> 8) & 0x00ff00ffu)) & 0xff00ff00u;
+    return rb | ag;
+}
+
+// Source-over a premultiplied color at `coverage` (0-255) across [x0, x1) of a row
+static void fill_span_rgba8(unsigned int* row, int x0, int x1, unsigned int color, unsigned int coverage) {
+    unsigned int source, inverse;
+    int x;
+    if (x0 >= x1 || coverage == 0) return;
+
+    source = coverage < 255 ? scale_pixel(color, coverage) : color;
+    inverse = 255 - (source >> 24);
+
+    if (inverse == 0) {
+        for (x = x0; x < x1; x++) row[x] = source;
+    } else if (source != 0) {
+        for (x = x0; x < x1; x++) row[x] = source + scale_pixel(row[x], inverse);
+    }
+}
+
+// Coverage fraction as 0-255
+static inline unsigned int coverage_byte(float coverage) {
+    if (coverage <= 0.0f) return 0;
+    if (coverage >= 1.0f) return 255;
+    return (unsigned int)(coverage * 255.0f + 0.5f);
+}
+
+static int is_mask_marker(unsigned int type) {
+    return type == DRAW_MASK_BEGIN || type == DRAW_MASK_CONTENT || type == DRAW_MASK_END;
+}
+
+// Find the extent of the mask group starting at `begin`. A group ends at
+// its DRAW_MASK_END, or where the next mask begins.
+static void parse_mask_group(const DrawCommand* commands, int count, int begin, MaskGroup* group) {
+    int i = begin + 1;
+
+    group->mode = commands[begin].color;
+    group->shapes = i;
+    while (i < count && !is_mask_marker(commands[i].type)) i++;
+    group->shape_count = i - group->shapes;
+    group->content = i;
+    group->content_count = 0;
+
+    if (i < count && commands[i].type == DRAW_MASK_CONTENT) {
+        group->content = ++i;
+        while (i < count && commands[i].type != DRAW_MASK_BEGIN && commands[i].type != DRAW_MASK_END) i++;
+        group->content_count = i - group->content;
+    }
+    group->next = i < count && commands[i].type == DRAW_MASK_END ? i + 1 : i;
+}
+
+// Clip masks cut rectangles on the nearest pixel edges
+static float snap(float value) {
+    return floorf(value + 0.5f);
+}
+
+// Draw one shape offset by (dx, dy). Markers and unknown commands draw nothing.
+static void draw_shape(Framebuffer* framebuffer, const DrawCommand* command, unsigned int color, float dx, float dy) {
+    switch (command->type) {
+        case DRAW_RECTANGLE:
+            raster_fill_rect(framebuffer, command->x + dx, command->y + dy, command->width, command->height, color);
+            break;
+        case DRAW_CIRCLE:
+            raster_fill_circle(framebuffer, command->x + dx, command->y + dy, command->width, color);
+            break;
+        default:
+            break;
+    }
+}
+
+// A straight-alpha color with its alpha multiplied by `alpha` (0-255)
+static unsigned int fade(unsigned int color, unsigned int alpha) {
+    if (alpha == 255) return color;
+    return (color & 0x00ffffffu) | (scale_pixel(color >> 24, alpha) << 24);
+}
+
+// Draw a mask shape as coverage in the alpha channel
+static void draw_mask_shape(Framebuffer* framebuffer, const DrawCommand* command, unsigned int mode, float dx, float dy) {
+    float x0, y0, x1, y1;
+
+    if (mode != DRAW_MASK_CLIP) {
+        draw_shape(framebuffer, command, command->color, dx, dy);
+        return;
+    }
+    if (command->type != DRAW_RECTANGLE) {
+        draw_shape(framebuffer, command, 0xff000000u, dx, dy);
+        return;
+    }
+
+    x0 = snap(fminf(command->x, command->x + command->width));
+    y0 = snap(fminf(command->y, command->y + command->height));
+    x1 = snap(fmaxf(command->x, command->x + command->width));
+    y1 = snap(fmaxf(command->y, command->y + command->height));
+    raster_fill_rect(framebuffer, x0 + dx, y0 + dy, x1 - x0, y1 - y0, 0xff000000u);
+}
+
+// Extent of the shapes among `count` commands, widened by (dx, dy).
+// With `visible`, transparent shapes don't count.
+static void shapes_extent(const DrawCommand* shapes, int count, int visible, float dx, float dy,
+                          float* x0, float* y0, float* x1, float* y1) {
+    int i;
+
+    *x0 = *y0 = INFINITY;
+    *x1 = *y1 = -INFINITY;
+    for (i = 0; i < count; i++) {
+        const DrawCommand* shape = &shapes[i];
+        if (visible && (shape->color >> 24) == 0) continue;
+
+        if (shape->type == DRAW_CIRCLE) {
+            // Edge coverage reaches half a pixel past the radius
+            float reach = shape->width + 1.0f;
+            if (shape->width <= 0) continue;
+            *x0 = fminf(*x0, shape->x - reach);
+            *y0 = fminf(*y0, shape->y - reach);
+            *x1 = fmaxf(*x1, shape->x + reach);
+            *y1 = fmaxf(*y1, shape->y + reach);
+        } else if (shape->type == DRAW_RECTANGLE) {
+            *x0 = fminf(*x0, fminf(shape->x, shape->x + shape->width));
+            *y0 = fminf(*y0, fminf(shape->y, shape->y + shape->height));
+            *x1 = fmaxf(*x1, fmaxf(shape->x, shape->x + shape->width));
+            *y1 = fmaxf(*y1, fmaxf(shape->y, shape->y + shape->height));
+        }
+    }
+    *x0 += dx;
+    *y0 += dy;
+    *x1 += dx;
+    *y1 += dy;
+}
+
+// Whole pixels within an extent, up to `margin` pixels past the edges of
+// the framebuffer. Returns 0 when none of them are in the framebuffer.
+static int pixel_bounds(const Framebuffer* framebuffer, float x0, float y0, float x1, float y1, float margin,
+                        int* left, int* top, int* right, int* bottom) {
+    x0 = fmaxf(floorf(x0), -margin);
+    y0 = fmaxf(floorf(y0), -margin);
+    x1 = fminf(ceilf(x1), framebuffer->width + margin);
+    y1 = fminf(ceilf(y1), framebuffer->height + margin);
+    if (!(x0 < x1 && y0 < y1 && x0 < framebuffer->width && y0 < framebuffer->height && x1 > 0 && y1 > 0)) {
+        return 0;
+    }
+
+    *left = (int)x0;
+    *top = (int)y0;
+    *right = (int)x1;
+    *bottom = (int)y1;
+    return 1;
+}
+
+// Pixel bounds of a mask's coverage within the framebuffer. Returns 0 when
+// the mask covers nothing there.
+static int mask_bounds(const Framebuffer* framebuffer, const DrawCommand* shapes, int count, unsigned int mode,
+                       float dx, float dy, int* left, int* top, int* right, int* bottom) {
+    float x0, y0, x1, y1;
+
+    shapes_extent(shapes, count, mode == DRAW_MASK_ALPHA, dx, dy, &x0, &y0, &x1, &y1);
+    if (mode == DRAW_MASK_CLIP) {
+        x0 = snap(x0); y0 = snap(y0); x1 = snap(x1); y1 = snap(y1);
+    }
+    return pixel_bounds(framebuffer, x0, y0, x1, y1, 0.0f, left, top, right, bottom);
+}
+
+// A lone rectangle on whole pixels is its own bounds, so the bounds work
+// as a scissor with no coverage to apply
+static int mask_is_scissor(const DrawCommand* shapes, int count, unsigned int mode) {
+    const DrawCommand* shape = &shapes[0];
+    if (count != 1 || shape->type != DRAW_RECTANGLE) return 0;
+    if (mode == DRAW_MASK_CLIP) return 1;
+
+    return (shape->color >> 24) == 255 &&
+           floorf(shape->x) == shape->x && floorf(shape->y) == shape->y &&
+           floorf(shape->width) == shape->width && floorf(shape->height) == shape->height;
+}
+
+static int same_shapes(const DrawCommand* a, const DrawCommand* b, int count) {
+    int i;
+    for (i = 0; i < count; i++) {
+        if (a[i].type != b[i].type || a[i].color != b[i].color ||
+            a[i].x != b[i].x || a[i].y != b[i].y || a[i].width != b[i].width || a[i].height != b[i].height) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static MaskEntry* mask_entry(struct RasterCache* cache, int index) {
+    if (index >= cache->mask_count) {
+        int count = cache->mask_count ? cache->mask_count : 4;
+        MaskEntry* masks;
+        while (count <= index) count *= 2;
+
+        masks = (MaskEntry*)realloc(cache->masks, count * sizeof(MaskEntry));
+        if (!masks) return NULL;
+        memset(masks + cache->mask_count, 0, (count - cache->mask_count) * sizeof(MaskEntry));
+        cache->masks = masks;
+        cache->mask_count = count;
+    }
+    return &cache->masks[index];
+}
+
+static unsigned int* reserve_pixels(unsigned int** buffer, size_t* capacity, size_t pixels) {
+    if (pixels > *capacity) {
+        unsigned int* grown = (unsigned int*)realloc(*buffer, pixels * sizeof(unsigned int));
+        if (!grown) return NULL;
+        *buffer = grown;
+        *capacity = pixels;
+    }
+    return *buffer;
+}
+
+// Rasterize a mask's coverage into its entry, drawing the shapes straight
+// into it as an A8 framebuffer. The shapes are offset by (dx, dy) into the
+// target the bounds are in. Returns 0 on success, -1 if out of memory.
+static int update_mask(MaskEntry* entry, const DrawCommand* shapes, int count, unsigned int mode,
+                       float dx, float dy, int left, int top, int right, int bottom) {
+    size_t pixels = (size_t)(right - left) * (bottom - top);
+    Framebuffer coverage;
+    int i;
+
+    if (entry->valid && entry->mode == mode && entry->shape_count == count &&
+        entry->left == left && entry->top == top && entry->right == right && entry->bottom == bottom &&
+        entry->dx == dx && entry->dy == dy && same_shapes(entry->shapes, shapes, count)) {
+        return 0;
+    }
+    entry->valid = 0;
+
+    if (count > entry->shape_capacity) {
+        DrawCommand* copy = (DrawCommand*)realloc(entry->shapes, count * sizeof(DrawCommand));
+        if (!copy) return -1;
+        entry->shapes = copy;
+        entry->shape_capacity = count;
+    }
+    if (pixels > entry->coverage_capacity) {
+        unsigned char* coverage = (unsigned char*)realloc(entry->coverage, pixels);
+        if (!coverage) return -1;
+        entry->coverage = coverage;
+        entry->coverage_capacity = pixels;
+    }
+
+    // Source-over on alpha alone is the union of the shapes
+    coverage.pixels = entry->coverage;
+    coverage.width = right - left;
+    coverage.height = bottom - top;
+    coverage.stride = coverage.width;
+    coverage.format = PIXEL_A8;
+    raster_clear(&coverage, 0);
+    for (i = 0; i < count; i++) draw_mask_shape(&coverage, &shapes[i], mode, dx - left, dy - top);
+
+    memcpy(entry->shapes, shapes, count * sizeof(DrawCommand));
+    entry->shape_count = count;
+    entry->mode = mode;
+    entry->left = left;
+    entry->top = top;
+    entry->right = right;
+    entry->bottom = bottom;
+    entry->dx = dx;
+    entry->dy = dy;
+    entry->valid = 1;
+    return 0;
+}
+
+// Source-over a row of premultiplied pixels multiplied by 8-bit coverage
+static void composite_masked_row_rgba8(unsigned int* row, const unsigned int* source, const unsigned char* coverage, int width) {
+    u32x4 opaque = u32x4_splat(255);
+    int x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        u32x4 masked = u32x4_scale_bytes(u32x4_load(source + x), u32x4_load_u8(coverage + x));
+        u32x4 inverse = u32x4_sub(opaque, u32x4_shr(masked, 24));
+        u32x4_store(row + x, u32x4_add(masked, u32x4_scale_bytes(u32x4_load(row + x), inverse)));
+    }
+    for (; x < width; x++) {
+        unsigned int masked = scale_pixel(source[x], coverage[x]);
+        row[x] = masked + scale_pixel(row[x], 255 - (masked >> 24));
+    }
+}
+
+// Blend four premultiplied pixels onto four others. Every mode but add
+// composites alpha source-over, and the color terms for the parts of each
+// pixel only one side covers are s * (1 - da) and d * (1 - sa). Add sums
+// all four channels, alpha included, as canvas "lighter" does.
+static inline u32x4 blend_pixels(u32x4 s, u32x4 d, unsigned int mode) {
+    u32x4 ones = u32x4_splat(0xffffffffu);
+    u32x4 spread = u32x4_splat(0x01010101u);
+    u32x4 sa = u32x4_mul(u32x4_shr(s, 24), spread);
+    u32x4 da = u32x4_mul(u32x4_shr(d, 24), spread);
+    u32x4 outside = u32x4_adds_bytes(u32x4_mul_bytes(s, u32x4_sub(ones, da)),
+                                     u32x4_mul_bytes(d, u32x4_sub(ones, sa)));
+    u32x4 product, dark, light, hard;
+
+    switch (mode) {
+        case DRAW_BLEND_MULTIPLY:
+            return u32x4_adds_bytes(u32x4_mul_bytes(s, d), outside);
+        case DRAW_BLEND_SCREEN:
+            return u32x4_adds_bytes(s, u32x4_mul_bytes(d, u32x4_sub(ones, s)));
+        case DRAW_BLEND_OVERLAY:
+            // Multiply where the backdrop is dark (2d <= da), screen where it's light
+            product = u32x4_mul_bytes(s, d);
+            dark = u32x4_adds_bytes(product, product);
+            hard = u32x4_mul_bytes(u32x4_subs_bytes(da, d), u32x4_subs_bytes(sa, s));
+            light = u32x4_subs_bytes(u32x4_subs_bytes(u32x4_mul_bytes(sa, da), hard), hard);
+            return u32x4_adds_bytes(u32x4_select(u32x4_le_bytes(d, u32x4_mul(u32x4_shr(d, 25), spread)), dark, light),
+                                    outside);
+        case DRAW_BLEND_ADD:
+            return u32x4_adds_bytes(s, d);
+        default:
+            return u32x4_adds_bytes(s, u32x4_mul_bytes(d, u32x4_sub(ones, sa)));
+    }
+}
+
+// Blend a row of a group's tile onto the row below it at `opacity` (0-255)
+static void blend_row_rgba8(unsigned int* row, const unsigned int* source, int width, unsigned int opacity, unsigned int mode) {
+    u32x4 scale = u32x4_splat(opacity);
+    unsigned int s[4], d[4];
+    int x = 0, i;
+
+    for (; x + 4 <= width; x += 4) {
+        u32x4 pixels;
+        // Every mode leaves the backdrop alone where the group drew nothing
+        if ((source[x] | source[x + 1] | source[x + 2] | source[x + 3]) == 0) continue;
+
+        pixels = u32x4_load(source + x);
+        if (opacity < 255) pixels = u32x4_scale_bytes(pixels, scale);
+        u32x4_store(row + x, blend_pixels(pixels, u32x4_load(row + x), mode));
+    }
+    if (x == width) return;
+
+    // The last few pixels go through a padded block
+    for (i = 0; i < 4; i++) {
+        s[i] = x + i < width ? source[x + i] : 0;
+        d[i] = x + i < width ? row[x + i] : 0;
+    }
+    u32x4_store(d, blend_pixels(u32x4_scale_bytes(u32x4_load(s), scale), u32x4_load(d), mode));
+    for (i = 0; x + i < width; i++) row[x + i] = d[i];
+}
+
+// Pixel formats. Each converts its pixels to and from premultiplied RGBA8
+// as they're loaded and stored.
+static inline unsigned int rgba8_pixel(unsigned int pixel) {
+    return pixel;
+}
+
+// BGRA8 is RGBA8 with red and blue swapped, both ways
+static inline unsigned int swap_red_blue(unsigned int pixel) {
+    return (pixel & 0xff00ff00u) | ((pixel >> 16) & 0xffu) | ((pixel & 0xffu) << 16);
+}
+
+// RGB565 widens by repeating each channel's top bits, and narrows rounded
+static inline unsigned int load_rgb565(unsigned short pixel) {
+    unsigned int r = pixel >> 11, g = (pixel >> 5) & 0x3fu, b = pixel & 0x1fu;
+    return ((r << 3) | (r >> 2)) | (((g << 2) | (g >> 4)) << 8) | (((b << 3) | (b >> 2)) << 16) | 0xff000000u;
+}
+
+static inline unsigned short store_rgb565(unsigned int pixel) {
+    unsigned int r = pixel & 0xffu, g = (pixel >> 8) & 0xffu, b = (pixel >> 16) & 0xffu;
+    return (unsigned short)((((r * 249 + 1014) >> 11) << 11) | (((g * 253 + 505) >> 10) << 5) | ((b * 249 + 1014) >> 11));
+}
+
+static inline unsigned int load_a8(unsigned char pixel) {
+    return (unsigned int)pixel << 24;
+}
+
+static inline unsigned char store_a8(unsigned int pixel) {
+    return (unsigned char)(pixel >> 24);
+}
+
+// Pixels converted at a time by the row kernels of formats other than RGBA8
+#define RASTER_CHUNK 64
+
+// Row conversions for a format whose `type` pixels convert with `load` and
+// `store`: to and from RGBA8, and filling a row with one color
+#define RASTER_FORMAT_CONVERSIONS(name, type, load, store)                                      \
+    static void load_row_##name(const void* row, unsigned int* pixels, int width) {             \
+        const type* in = (const type*)row;                                                      \
+        int x;                                                                                  \
+        for (x = 0; x < width; x++) pixels[x] = load(in[x]);                                    \
+    }                                                                                           \
+    static void store_row_##name(void* row, const unsigned int* pixels, int width) {            \
+        type* out = (type*)row;                                                                 \
+        int x;                                                                                  \
+        for (x = 0; x < width; x++) out[x] = store(pixels[x]);                                  \
+    }                                                                                           \
+    static void clear_row_##name(void* row, int width, unsigned int color) {                    \
+        type* out = (type*)row;                                                                 \
+        type packed = store(color);                                                             \
+        int x;                                                                                  \
+        for (x = 0; x < width; x++) out[x] = packed;                                            \
+    }
+
+// RGB565 spans blend at RGBA8's precision: each pixel is widened, blended
+// as fill_span_rgba8 blends it and narrowed rounded. Runs of one color are
+// common under a span, so the last pixel's result is reused.
+static void fill_span_rgb565(unsigned short* row, int x0, int x1, unsigned int color, unsigned int coverage) {
+    unsigned int source, inverse;
+    int x;
+    if (x0 >= x1 || coverage == 0) return;
+
+    source = coverage < 255 ? scale_pixel(color, coverage) : color;
+    inverse = 255 - (source >> 24);
+
+    if (inverse == 0) {
+        unsigned short packed = store_rgb565(source);
+        for (x = x0; x < x1; x++) row[x] = packed;
+    } else if (source != 0) {
+        unsigned short below = row[x0];
+        unsigned short blended = store_rgb565(source + scale_pixel(load_rgb565(below), inverse));
+        for (x = x0; x < x1; x++) {
+            if (row[x] != below) {
+                below = row[x];
+                blended = store_rgb565(source + scale_pixel(load_rgb565(below), inverse));
+            }
+            row[x] = blended;
+        }
+    }
+}
+
+// A8 spans are the alpha lane of RGBA8's
+static void fill_span_a8(unsigned char* row, int x0, int x1, unsigned int color, unsigned int coverage) {
+    unsigned int alpha, inverse;
+    int x;
+    if (x0 >= x1 || coverage == 0) return;
+
+    alpha = (coverage < 255 ? scale_pixel(color, coverage) : color) >> 24;
+    inverse = 255 - alpha;
+
+    if (inverse == 0) {
+        memset(row + x0, 255, (size_t)(x1 - x0));
+    } else if (alpha != 0) {
+        for (x = x0; x < x1; x++) row[x] = (unsigned char)(alpha + scale_pixel(row[x], inverse));
+    }
+}
+
+// Row kernels for a format other than RGBA8. Rows go through RGBA8 a chunk
+// at a time and reuse its kernels.
+#define RASTER_FORMAT_ROWS(name, type)                                                          \
+    static void composite_masked_row_##name(void* row, const unsigned int* source,              \
+                                            const unsigned char* coverage, int width) {         \
+        type* out = (type*)row;                                                                 \
+        unsigned int chunk[RASTER_CHUNK];                                                       \
+        int x, count;                                                                           \
+        for (x = 0; x < width; x += count) {                                                    \
+            count = width - x < RASTER_CHUNK ? width - x : RASTER_CHUNK;                        \
+            load_row_##name(out + x, chunk, count);                                             \
+            composite_masked_row_rgba8(chunk, source + x, coverage + x, count);                 \
+            store_row_##name(out + x, chunk, count);                                            \
+        }                                                                                       \
+    }                                                                                           \
+    static void blend_row_##name(void* row, const unsigned int* source, int width,              \
+                                 unsigned int opacity, unsigned int mode) {                     \
+        type* out = (type*)row;                                                                 \
+        unsigned int chunk[RASTER_CHUNK];                                                       \
+        int x, count;                                                                           \
+        for (x = 0; x < width; x += count) {                                                    \
+            count = width - x < RASTER_CHUNK ? width - x : RASTER_CHUNK;                        \
+            load_row_##name(out + x, chunk, count);                                             \
+            blend_row_rgba8(chunk, source + x, count, opacity, mode);                           \
+            store_row_##name(out + x, chunk, count);                                            \
+        }                                                                                       \
+    }
+
+RASTER_FORMAT_CONVERSIONS(rgba8, unsigned int, rgba8_pixel, rgba8_pixel)
+RASTER_FORMAT_CONVERSIONS(bgra8, unsigned int, swap_red_blue, swap_red_blue)
+RASTER_FORMAT_CONVERSIONS(rgb565, unsigned short, load_rgb565, store_rgb565)
+RASTER_FORMAT_CONVERSIONS(a8, unsigned char, load_a8, store_a8)
+RASTER_FORMAT_ROWS(bgra8, unsigned int)
+RASTER_FORMAT_ROWS(rgb565, unsigned short)
+RASTER_FORMAT_ROWS(a8, unsigned char)
+
+// Address of pixel (x, y)
+static inline void* pixel_address(const Framebuffer* framebuffer, int x, int y) {
+    return (unsigned char*)framebuffer->pixels +
+           ((size_t)y * framebuffer->stride + x) * pixel_format_bytes(framebuffer->format);
+}
+
+// The kernels for a framebuffer's format. Group tiles and the other
+// offscreen buffers are always RGBA8.
+static void fill_span(int format, void* row, int x0, int x1, unsigned int color, unsigned int coverage) {
+    switch (format) {
+        // Source-over treats every channel alike, so BGRA8 only needs the color swapped
+        case PIXEL_BGRA8: fill_span_rgba8((unsigned int*)row, x0, x1, swap_red_blue(color), coverage); break;
+        case PIXEL_RGB565: fill_span_rgb565((unsigned short*)row, x0, x1, color, coverage); break;
+        case PIXEL_A8: fill_span_a8((unsigned char*)row, x0, x1, color, coverage); break;
+        default: fill_span_rgba8((unsigned int*)row, x0, x1, color, coverage); break;
+    }
+}
+
+static void composite_masked_row(int format, void* row, const unsigned int* source,
+                                 const unsigned char* coverage, int width) {
+    switch (format) {
+        case PIXEL_BGRA8: composite_masked_row_bgra8(row, source, coverage, width); break;
+        case PIXEL_RGB565: composite_masked_row_rgb565(row, source, coverage, width); break;
+        case PIXEL_A8: composite_masked_row_a8(row, source, coverage, width); break;
+        default: composite_masked_row_rgba8((unsigned int*)row, source, coverage, width); break;
+    }
+}
+
+static void blend_row(int format, void* row, const unsigned int* source, int width,
+                      unsigned int opacity, unsigned int mode) {
+    switch (format) {
+        case PIXEL_BGRA8: blend_row_bgra8(row, source, width, opacity, mode); break;
+        case PIXEL_RGB565: blend_row_rgb565(row, source, width, opacity, mode); break;
+        case PIXEL_A8: blend_row_a8(row, source, width, opacity, mode); break;
+        default: blend_row_rgba8((unsigned int*)row, source, width, opacity, mode); break;
+    }
+}
+
+static void load_row(int format, const void* row, unsigned int* pixels, int width) {
+    switch (format) {
+        case PIXEL_BGRA8: load_row_bgra8(row, pixels, width); break;
+        case PIXEL_RGB565: load_row_rgb565(row, pixels, width); break;
+        case PIXEL_A8: load_row_a8(row, pixels, width); break;
+        default: load_row_rgba8(row, pixels, width); break;
+    }
+}
+
+static void store_row(int format, void* row, const unsigned int* pixels, int width) {
+    switch (format) {
+        case PIXEL_BGRA8: store_row_bgra8(row, pixels, width); break;
+        case PIXEL_RGB565: store_row_rgb565(row, pixels, width); break;
+        case PIXEL_A8: store_row_a8(row, pixels, width); break;
+        default: store_row_rgba8(row, pixels, width); break;
+    }
+}
+
+static void clear_row(int format, void* row, int width, unsigned int color) {
+    switch (format) {
+        case PIXEL_BGRA8: clear_row_bgra8(row, width, color); break;
+        case PIXEL_RGB565: clear_row_rgb565(row, width, color); break;
+        case PIXEL_A8: clear_row_a8(row, width, color); break;
+        default: clear_row_rgba8(row, width, color); break;
+    }
+}
+
+// Radii of three box blurs that together approximate a Gaussian with
+// standard deviation `sigma`. Returns how far they spread a pixel.
+static int box_radii(float sigma, int* radii) {
+    float ideal;
+    int lower, narrow, i, reach = 0;
+
+    if (!(sigma > 0)) {
+        radii[0] = radii[1] = radii[2] = 0;
+        return 0;
+    }
+    if (sigma > RASTER_BLUR_MAX) sigma = RASTER_BLUR_MAX;
+
+    // Odd box widths two apart, with as many of the narrower as keeps the
+    // variance closest to sigma squared
+    ideal = sqrtf(4.0f * sigma * sigma + 1.0f);
+    lower = (int)floorf(ideal);
+    if (lower % 2 == 0) lower--;
+    narrow = (int)floorf((12.0f * sigma * sigma - 3 * lower * lower - 12 * lower - 9) / (-4.0f * lower - 4.0f) + 0.5f);
+
+    for (i = 0; i < 3; i++) {
+        radii[i] = ((i < narrow ? lower : lower + 2) - 1) / 2;
+        reach += radii[i];
+    }
+    return reach;
+}
+
+// The channels of one pixel, a lane each
+static inline u32x4 unpack_pixel(const unsigned int* pixel) {
+    return u32x4_load_u8((const unsigned char*)pixel);
+}
+
+// Channel sums divided by a box width: `scale` is 65536 / width
+static inline unsigned int box_average(u32x4 sums, u32x4 scale) {
+    return u32x4_pack_u8(u32x4_shr(u32x4_add(u32x4_mul(sums, scale), u32x4_splat(0x8000)), 16));
+}
+
+// One box pass along each row, from `source` into `target`. The window
+// slides, so each pixel costs the same whatever the radius; pixels past
+// the ends are transparent.
+static void box_rows(const unsigned int* source, unsigned int* target, int width, int height, int radius) {
+    unsigned int size = 2 * radius + 1;
+    u32x4 scale = u32x4_splat((65536 + size / 2) / size);
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        const unsigned int* in = source + (size_t)y * width;
+        unsigned int* out = target + (size_t)y * width;
+        u32x4 sums = u32x4_splat(0);
+
+        for (x = 0; x < radius && x < width; x++) sums = u32x4_add(sums, unpack_pixel(&in[x]));
+        for (x = 0; x < width; x++) {
+            if (x + radius < width) sums = u32x4_add(sums, unpack_pixel(&in[x + radius]));
+            out[x] = box_average(sums, scale);
+            if (x >= radius) sums = u32x4_sub(sums, unpack_pixel(&in[x - radius]));
+        }
+    }
+}
+
+// Add (sign 1) or remove (sign -1) a row's channels from the column sums
+static void accumulate_row(unsigned int* sums, const unsigned int* row, int width, int sign) {
+    int x;
+    for (x = 0; x < width; x++) {
+        u32x4 column = u32x4_load(sums + 4 * x);
+        u32x4_store(sums + 4 * x, sign > 0 ? u32x4_add(column, unpack_pixel(&row[x]))
+                                           : u32x4_sub(column, unpack_pixel(&row[x])));
+    }
+}
+
+// One box pass down each column, keeping a running sum per column
+static void box_columns(const unsigned int* source, unsigned int* target, unsigned int* sums,
+                        int width, int height, int radius) {
+    unsigned int size = 2 * radius + 1;
+    u32x4 scale = u32x4_splat((65536 + size / 2) / size);
+    int x, y;
+
+    memset(sums, 0, (size_t)width * 4 * sizeof(unsigned int));
+    for (y = 0; y < radius && y < height; y++) accumulate_row(sums, source + (size_t)y * width, width, 1);
+    for (y = 0; y < height; y++) {
+        unsigned int* out = target + (size_t)y * width;
+        if (y + radius < height) accumulate_row(sums, source + (size_t)(y + radius) * width, width, 1);
+        for (x = 0; x < width; x++) out[x] = box_average(u32x4_load(sums + 4 * x), scale);
+        if (y >= radius) accumulate_row(sums, source + (size_t)(y - radius) * width, width, -1);
+    }
+}
+
+// Blur premultiplied pixels in place. Returns 0 on success, -1 if out of memory.
+static int blur_pixels(struct RasterCache* cache, unsigned int* pixels, int width, int height, float sigma) {
+    size_t count = (size_t)width * height;
+    unsigned int *scratch, *sums;
+    int radii[3];
+    int i;
+
+    if (box_radii(sigma, radii) == 0) return 0;
+    scratch = reserve_pixels(&cache->blur_scratch, &cache->blur_scratch_capacity, count);
+    sums = reserve_pixels(&cache->blur_sums, &cache->blur_sums_capacity, (size_t)width * 4);
+    if (!scratch || !sums) return -1;
+
+    for (i = 0; i < 3; i++) {
+        if (radii[i] == 0) continue;
+        box_rows(pixels, scratch, width, height, radii[i]);
+        box_columns(scratch, pixels, sums, width, height, radii[i]);
+    }
+    return 0;
+}
+
+// Shadow offsets move by whole pixels
+static int shadow_offset(float value) {
+    if (!(value >= -RASTER_SHADOW_MAX)) value = value < 0 ? -RASTER_SHADOW_MAX : 0;
+    if (value > RASTER_SHADOW_MAX) value = RASTER_SHADOW_MAX;
+    return (int)snap(value);
+}
+
+// A color matrix command's matrix, or NULL if the list has none by its index
+static const float* filter_matrix(const DrawState* state, const DrawCommand* filter) {
+    if (filter->color >= (unsigned int)state->matrix_count) return NULL;
+    return state->matrices + (size_t)filter->color * DRAW_COLOR_MATRIX_SIZE;
+}
+
+// Premultiplied pixel from straight channels in 0-1 run through a color
+// matrix, given as its five columns
+static inline unsigned int matrix_pixel(const f32x4* columns, float r, float g, float b, float a) {
+    f32x4 out = f32x4_add(f32x4_add(f32x4_mul(columns[0], f32x4_splat(r)), f32x4_mul(columns[1], f32x4_splat(g))),
+                          f32x4_add(f32x4_mul(columns[2], f32x4_splat(b)), f32x4_mul(columns[3], f32x4_splat(a))));
+    float lanes[4];
+
+    out = f32x4_min(f32x4_max(f32x4_add(out, columns[4]), f32x4_splat(0.0f)), f32x4_splat(1.0f));
+    f32x4_store(lanes, out);
+    lanes[3] *= 255.0f;
+    out = f32x4_add(f32x4_mul(out, f32x4_make(lanes[3], lanes[3], lanes[3], 255.0f)), f32x4_splat(0.5f));
+    return u32x4_pack_u8(u32x4_from_f32x4(out));
+}
+
+// Alpha a color matrix gives transparent pixels, as a byte
+static unsigned int transparent_matrix_alpha(const float* matrix) {
+    float alpha = fminf(fmaxf(matrix[19], 0.0f), 1.0f);
+    return (unsigned int)(alpha * 255.0f + 0.5f);
+}
+
+// Run premultiplied pixels through a color matrix in one pass, all four
+// output channels of a pixel at once
+static void apply_color_matrix(unsigned int* pixels, size_t count, const float* matrix) {
+    f32x4 columns[5];
+    unsigned int empty;
+    size_t i;
+    int j;
+
+    for (j = 0; j < 5; j++) {
+        columns[j] = f32x4_make(matrix[j], matrix[5 + j], matrix[10 + j], matrix[15 + j]);
+    }
+
+    // Transparent pixels have no color, so they all come out as the offsets
+    empty = matrix_pixel(columns, 0, 0, 0, 0);
+    for (i = 0; i < count; i++) {
+        unsigned int pixel = pixels[i];
+        unsigned int a = pixel >> 24;
+        float inverse;
+
+        if (a == 0) {
+            pixels[i] = empty;
+            continue;
+        }
+        inverse = 1.0f / a;
+        pixels[i] = matrix_pixel(columns, (pixel & 0xff) * inverse, ((pixel >> 8) & 0xff) * inverse,
+                                 ((pixel >> 16) & 0xff) * inverse, a * (1.0f / 255.0f));
+    }
+}
+
+// Widen a group's extent to what its filters spread it over. Returns how
+// far outside the framebuffer content can be and still reach into it.
+static float filter_extent(const DrawState* state, const DrawCommand* filters, int count,
+                           float* x0, float* y0, float* x1, float* y1) {
+    float margin = 0;
+    int radii[3];
+    int i;
+
+    for (i = 0; i < count; i++) {
+        float reach, dx = 0, dy = 0;
+
+        // Color matrices keep every pixel where it is, but one with an alpha
+        // offset shows transparent pixels too. On the canvas feColorMatrix
+        // runs over the group's whole layer, so the group covers the frame.
+        if (filters[i].type == DRAW_COLOR_MATRIX) {
+            const float* matrix = filter_matrix(state, &filters[i]);
+            if (matrix && transparent_matrix_alpha(matrix) > 0) {
+                *x0 = *y0 = -INFINITY;
+                *x1 = *y1 = INFINITY;
+            }
+            continue;
+        }
+        reach = (float)box_radii(filters[i].width, radii);
+
+        if (filters[i].type == DRAW_SHADOW) {
+            dx = (float)shadow_offset(filters[i].x);
+            dy = (float)shadow_offset(filters[i].y);
+            margin += fmaxf(fabsf(dx), fabsf(dy));
+        }
+        margin += reach;
+
+        // A shadow is as wide as what casts it, moved and blurred
+        *x0 = fminf(*x0, *x0 + dx - reach);
+        *y0 = fminf(*y0, *y0 + dy - reach);
+        *x1 = fmaxf(*x1, *x1 + dx + reach);
+        *y1 = fmaxf(*y1, *y1 + dy + reach);
+    }
+    return margin;
+}
+
+static ShadowEntry* shadow_entry(struct RasterCache* cache, int index) {
+    if (index >= cache->shadow_count) {
+        int count = cache->shadow_count ? cache->shadow_count : 4;
+        ShadowEntry* shadows;
+        while (count <= index) count *= 2;
+
+        shadows = (ShadowEntry*)realloc(cache->shadows, count * sizeof(ShadowEntry));
+        if (!shadows) return NULL;
+        memset(shadows + cache->shadow_count, 0, (count - cache->shadow_count) * sizeof(ShadowEntry));
+        cache->shadows = shadows;
+        cache->shadow_count = count;
+    }
+    return &cache->shadows[index];
+}
+
+// Color matrices aren't in the commands, only their indices, so a shadow
+// entry keeps copies of them to tell when they change
+static const float no_matrix[DRAW_COLOR_MATRIX_SIZE];
+
+static int count_matrices(const DrawCommand* commands, int count) {
+    int matrices = 0;
+    int i;
+    for (i = 0; i < count; i++) matrices += commands[i].type == DRAW_COLOR_MATRIX;
+    return matrices;
+}
+
+// Whether the commands' color matrices are `saved`, in order. Their types
+// have to match the saved commands' already.
+static int same_matrices(const float* saved, const DrawCommand* commands, int count, const DrawState* state) {
+    int i;
+    for (i = 0; i < count; i++) {
+        const float* matrix;
+        if (commands[i].type != DRAW_COLOR_MATRIX) continue;
+
+        matrix = filter_matrix(state, &commands[i]);
+        if (memcmp(saved, matrix ? matrix : no_matrix, sizeof(no_matrix)) != 0) return 0;
+        saved += DRAW_COLOR_MATRIX_SIZE;
+    }
+    return 1;
+}
+
+static void save_matrices(float* saved, const DrawCommand* commands, int count, const DrawState* state) {
+    int i;
+    for (i = 0; i < count; i++) {
+        const float* matrix;
+        if (commands[i].type != DRAW_COLOR_MATRIX) continue;
+
+        matrix = filter_matrix(state, &commands[i]);
+        memcpy(saved, matrix ? matrix : no_matrix, sizeof(no_matrix));
+        saved += DRAW_COLOR_MATRIX_SIZE;
+    }
+}
+
+// Draw a shadow's pixels over a group's tile into its entry: the tile's
+// alpha, moved, in the shadow's color, blurred. Returns 0 on success, -1 if
+// out of memory.
+static int update_shadow(struct RasterCache* cache, ShadowEntry* entry, const Framebuffer* tile,
+                         const DrawCommand* filter) {
+    unsigned int color = raster_premultiply(filter->color);
+    int dx = shadow_offset(filter->x), dy = shadow_offset(filter->y);
+    int x, y;
+
+    for (y = 0; y < tile->height; y++) {
+        unsigned int* out = entry->pixels + (size_t)y * tile->width;
+        const unsigned int* in = (const unsigned int*)tile->pixels + (size_t)(y - dy) * tile->width;
+        int inside = y - dy >= 0 && y - dy < tile->height;
+
+        for (x = 0; x < tile->width; x++) {
+            unsigned int alpha = inside && x - dx >= 0 && x - dx < tile->width ? in[x - dx] >> 24 : 0;
+            out[x] = scale_pixel(color, alpha);
+        }
+    }
+    return blur_pixels(cache, entry->pixels, tile->width, tile->height, filter->width);
+}
+
+// Put the shadow under a row of the tile
+static void composite_under_row(unsigned int* row, const unsigned int* shadow, int width) {
+    u32x4 opaque = u32x4_splat(255);
+    int x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        u32x4 pixels = u32x4_load(row + x);
+        u32x4 inverse = u32x4_sub(opaque, u32x4_shr(pixels, 24));
+        u32x4_store(row + x, u32x4_add(pixels, u32x4_scale_bytes(u32x4_load(shadow + x), inverse)));
+    }
+    for (; x < width; x++) row[x] += scale_pixel(shadow[x], 255 - (row[x] >> 24));
+}
+
+// Add a drop shadow under a group's tile. The shadow is kept in the cache
+// with the group's commands, so a group that draws the same from frame to
+// frame only composites it.
+static void draw_shadow(struct RasterCache* cache, Framebuffer* tile, const DrawCommand* filter,
+                        const DrawCommand* commands, int count, const DrawState* state,
+                        int left, int top) {
+    ShadowEntry* entry = shadow_entry(cache, (*state->shadows)++);
+    size_t pixels = (size_t)tile->width * tile->height;
+    int matrices, y;
+    if (!entry) return;
+
+    if (!(entry->valid && entry->left == left && entry->top == top &&
+          entry->right == left + tile->width && entry->bottom == top + tile->height &&
+          entry->dx == state->dx && entry->dy == state->dy &&
+          entry->command_count == count && same_shapes(entry->commands, commands, count) &&
+          same_matrices(entry->matrices, commands, count, state))) {
+        entry->valid = 0;
+        if (count > entry->command_capacity) {
+            DrawCommand* copy = (DrawCommand*)realloc(entry->commands, count * sizeof(DrawCommand));
+            if (!copy) return;
+            entry->commands = copy;
+            entry->command_capacity = count;
+        }
+        matrices = count_matrices(commands, count);
+        if (matrices > entry->matrix_capacity) {
+            float* copy = (float*)realloc(entry->matrices, (size_t)matrices * sizeof(no_matrix));
+            if (!copy) return;
+            entry->matrices = copy;
+            entry->matrix_capacity = matrices;
+        }
+        if (!reserve_pixels(&entry->pixels, &entry->pixel_capacity, pixels)) return;
+        if (update_shadow(cache, entry, tile, filter) != 0) return;
+
+        memcpy(entry->commands, commands, count * sizeof(DrawCommand));
+        save_matrices(entry->matrices, commands, count, state);
+        entry->command_count = count;
+        entry->left = left;
+        entry->top = top;
+        entry->right = left + tile->width;
+        entry->bottom = top + tile->height;
+        entry->dx = state->dx;
+        entry->dy = state->dy;
+        entry->valid = 1;
+    }
+
+    for (y = 0; y < tile->height; y++) {
+        composite_under_row((unsigned int*)tile->pixels + (size_t)y * tile->width,
+                            entry->pixels + (size_t)y * tile->width, tile->width);
+    }
+}
+
+static void draw_range(Framebuffer* framebuffer, struct RasterCache* cache, const DrawCommand* commands,
+                       int begin, int end, const DrawState* state);
+
+// Draw a mask group
+static void draw_masked(Framebuffer* framebuffer, struct RasterCache* cache, const DrawCommand* commands,
+                        const MaskGroup* group, const DrawState* state) {
+    const DrawCommand* shapes = commands + group->shapes;
+    int index = (*state->masks)++;
+    DrawState inner = *state;
+    Framebuffer region;
+    MaskEntry* entry;
+    unsigned int* scratch;
+    int left, top, right, bottom, y;
+
+    // Nothing shows through an empty mask
+    if (group->content_count == 0) return;
+    if (!mask_bounds(framebuffer, shapes, group->shape_count, group->mode, state->dx, state->dy,
+                     &left, &top, &right, &bottom)) {
+        return;
+    }
+
+    region.width = right - left;
+    region.height = bottom - top;
+    inner.dx -= left;
+    inner.dy -= top;
+
+    if (mask_is_scissor(shapes, group->shape_count, group->mode)) {
+        region.pixels = pixel_address(framebuffer, left, top);
+        region.stride = framebuffer->stride;
+        region.format = framebuffer->format;
+        draw_range(&region, cache, commands, group->content, group->content + group->content_count, &inner);
+        return;
+    }
+
+    entry = mask_entry(cache, index);
+    scratch = reserve_pixels(&cache->scratch, &cache->scratch_capacity, (size_t)region.width * region.height);
+    region.pixels = scratch;
+    region.stride = region.width;
+    region.format = PIXEL_RGBA8;
+    if (!entry || !scratch) return;
+    if (update_mask(entry, shapes, group->shape_count, group->mode, state->dx, state->dy,
+                    left, top, right, bottom) != 0) {
+        return;
+    }
+
+    raster_clear(&region, 0);
+    draw_range(&region, cache, commands, group->content, group->content + group->content_count, &inner);
+    for (y = 0; y < region.height; y++) {
+        composite_masked_row(framebuffer->format, pixel_address(framebuffer, left, top + y),
+                             scratch + (size_t)y * region.width,
+                             entry->coverage + (size_t)y * region.width, region.width);
+    }
+}
+
+// Index of the DRAW_GROUP_END matching the DRAW_GROUP_BEGIN at `begin`, or
+// `end` if the group is left open
+static int group_end(const DrawCommand* commands, int begin, int end) {
+    int open = 0;
+    int i;
+
+    for (i = begin + 1; i < end; i++) {
+        if (commands[i].type == DRAW_GROUP_BEGIN) {
+            open++;
+        } else if (commands[i].type == DRAW_GROUP_END) {
+            if (open == 0) return i;
+            open--;
+        }
+    }
+    return end;
+}
+
+// Draw the group whose commands lie between `begin` and `end`. Its children
+// are drawn into the tile for its depth, covering their bounds and what
+// the group's filters spread them over, the filters are applied, and the
+// tile is blended onto the target. Without a tile the group's opacity is
+// folded into its children's colors, and its blend mode and filters are lost.
+static void draw_group(Framebuffer* framebuffer, struct RasterCache* cache, const DrawCommand* commands,
+                       int begin, int end, const DrawState* state) {
+    const DrawCommand* filters = commands + begin + 1;
+    unsigned int mode = commands[begin].color;
+    unsigned int opacity = scale_pixel(coverage_byte(commands[begin].x), state->alpha);
+    DrawState inner = *state;
+    Framebuffer tile;
+    unsigned int* pixels = NULL;
+    float x0, y0, x1, y1, margin;
+    int filter_count = 0;
+    int left, top, right, bottom, first, last, i, y;
+
+    if (opacity == 0) return;
+    while (begin + 1 + filter_count < end && (filters[filter_count].type == DRAW_BLUR ||
+           filters[filter_count].type == DRAW_SHADOW || filters[filter_count].type == DRAW_COLOR_MATRIX)) {
+        filter_count++;
+    }
+
+    if (state->depth < RASTER_GROUP_TILES) {
+        shapes_extent(commands + begin + 1, end - begin - 1, 1, state->dx, state->dy, &x0, &y0, &x1, &y1);
+        margin = filter_extent(state, filters, filter_count, &x0, &y0, &x1, &y1);
+        if (!pixel_bounds(framebuffer, x0, y0, x1, y1, margin, &left, &top, &right, &bottom)) return;
+
+        tile.width = right - left;
+        tile.height = bottom - top;
+        tile.stride = tile.width;
+        tile.format = PIXEL_RGBA8;
+        pixels = reserve_pixels(&cache->tiles[state->depth], &cache->tile_capacity[state->depth],
+                                (size_t)tile.width * tile.height);
+        tile.pixels = pixels;
+    }
+
+    if (!pixels) {
+        inner.alpha = opacity;
+        draw_range(framebuffer, cache, commands, begin + 1, end, &inner);
+        return;
+    }
+
+    inner.dx -= left;
+    inner.dy -= top;
+    inner.alpha = 255;
+    inner.depth++;
+    raster_clear(&tile, 0);
+    draw_range(&tile, cache, commands, begin + 1, end, &inner);
+
+    for (i = 0; i < filter_count; i++) {
+        if (filters[i].type == DRAW_BLUR) {
+            blur_pixels(cache, pixels, tile.width, tile.height, filters[i].width);
+        } else if (filters[i].type == DRAW_COLOR_MATRIX) {
+            const float* matrix = filter_matrix(state, &filters[i]);
+            if (matrix) apply_color_matrix(pixels, (size_t)tile.width * tile.height, matrix);
+        } else {
+            draw_shadow(cache, &tile, &filters[i], filters, end - begin - 1, state, left, top);
+        }
+    }
+
+    // The tile can reach past the framebuffer, for filters to spread in from there
+    first = left < 0 ? -left : 0;
+    last = right > framebuffer->width ? framebuffer->width - left : tile.width;
+    for (y = top < 0 ? -top : 0; y < tile.height && top + y < framebuffer->height; y++) {
+        blend_row(framebuffer->format, pixel_address(framebuffer, left + first, top + y),
+                  pixels + (size_t)y * tile.width + first, last - first, opacity, mode);
+    }
+}
+
+// Draw commands [begin, end), handling the masks and groups among them
+static void draw_range(Framebuffer* framebuffer, struct RasterCache* cache, const DrawCommand* commands,
+                       int begin, int end, const DrawState* state) {
+    int i = begin;
+
+    while (i < end) {
+        const DrawCommand* command = &commands[i];
+        MaskGroup group;
+        int close;
+
+        if (command->type == DRAW_MASK_BEGIN) {
+            parse_mask_group(commands, end, i, &group);
+            draw_masked(framebuffer, cache, commands, &group, state);
+            i = group.next;
+            continue;
+        }
+        if (command->type == DRAW_GROUP_BEGIN) {
+            close = group_end(commands, i, end);
+            draw_group(framebuffer, cache, commands, i, close, state);
+            i = close < end ? close + 1 : end;
+            continue;
+        }
+
+        // Markers without a mask or group to go with them, and filters, draw nothing
+        draw_shape(framebuffer, command, fade(command->color, state->alpha), state->dx, state->dy);
+        i++;
+    }
+}
+
+static void release_cache(struct RasterCache* cache) {
+    int i;
+    for (i = 0; i < cache->mask_count; i++) {
+        free(cache->masks[i].shapes);
+        free(cache->masks[i].coverage);
+    }
+    free(cache->masks);
+    free(cache->scratch);
+    for (i = 0; i < RASTER_GROUP_TILES; i++) free(cache->tiles[i]);
+    for (i = 0; i < cache->shadow_count; i++) {
+        free(cache->shadows[i].commands);
+        free(cache->shadows[i].matrices);
+        free(cache->shadows[i].pixels);
+    }
+    free(cache->shadows);
+    free(cache->blur_scratch);
+    free(cache->blur_sums);
+}
+
+EMSCRIPTEN_KEEPALIVE int pixel_format_bytes(int format) {
+    switch (format) {
+        case PIXEL_RGBA8:
+        case PIXEL_BGRA8:
+            return 4;
+        case PIXEL_RGB565:
+            return 2;
+        case PIXEL_A8:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE int framebuffer_init(Framebuffer* framebuffer, int width, int height) {
+    return framebuffer_init_format(framebuffer, width, height, PIXEL_RGBA8);
+}
+
+EMSCRIPTEN_KEEPALIVE int framebuffer_init_format(Framebuffer* framebuffer, int width, int height, int format) {
+    int bytes = pixel_format_bytes(format);
+    if (!framebuffer || width <= 0 || height <= 0 || bytes == 0) return -1;
+
+    framebuffer->pixels = calloc((size_t)width * height, bytes);
+    if (!framebuffer->pixels) return -1;
+    framebuffer->width = width;
+    framebuffer->height = height;
+    framebuffer->stride = width;
+    framebuffer->format = format;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void framebuffer_release(Framebuffer* framebuffer) {
+    if (!framebuffer) return;
+
+    free(framebuffer->pixels);
+    framebuffer->pixels = NULL;
+    framebuffer->width = 0;
+    framebuffer->height = 0;
+    framebuffer->stride = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE unsigned int raster_premultiply(unsigned int color) {
+    unsigned int alpha = color >> 24;
+    return (scale_pixel(color, alpha) & 0x00ffffffu) | (alpha << 24);
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_clear(Framebuffer* framebuffer, unsigned int color) {
+    int y;
+    if (!framebuffer || !framebuffer->pixels) return;
+
+    for (y = 0; y < framebuffer->height; y++) {
+        clear_row(framebuffer->format, pixel_address(framebuffer, 0, y), framebuffer->width, color);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_fill_rect(Framebuffer* framebuffer, float x, float y, float width, float height, unsigned int color) {
+    float x0 = x, x1 = x + width, y0 = y, y1 = y + height;
+    unsigned int premultiplied;
+    int left, right, top, bottom, row_index;
+
+    if (!framebuffer || !framebuffer->pixels) return;
+    if (width < 0) { x0 = x + width; x1 = x; }
+    if (height < 0) { y0 = y + height; y1 = y; }
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > framebuffer->width) x1 = (float)framebuffer->width;
+    if (y1 > framebuffer->height) y1 = (float)framebuffer->height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    premultiplied = raster_premultiply(color);
+    left = (int)floorf(x0);
+    right = (int)ceilf(x1);
+    top = (int)floorf(y0);
+    bottom = (int)ceilf(y1);
+
+    for (row_index = top; row_index < bottom; row_index++) {
+        void* row = pixel_address(framebuffer, 0, row_index);
+        float cy = fminf(y1, row_index + 1.0f) - fmaxf(y0, (float)row_index);
+
+        // Partial pixels at either end, full coverage in between
+        if (right - left == 1) {
+            fill_span(framebuffer->format, row, left, right, premultiplied, coverage_byte((x1 - x0) * cy));
+            continue;
+        }
+        fill_span(framebuffer->format, row, left, left + 1, premultiplied, coverage_byte((left + 1.0f - x0) * cy));
+        fill_span(framebuffer->format, row, left + 1, right - 1, premultiplied, coverage_byte(cy));
+        fill_span(framebuffer->format, row, right - 1, right, premultiplied, coverage_byte((x1 - (right - 1.0f)) * cy));
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_fill_circle(Framebuffer* framebuffer, float cx, float cy, float radius, unsigned int color) {
+    unsigned int premultiplied;
+    float outer_r, inner_r;
+    int top, bottom, row_index;
+
+    if (!framebuffer || !framebuffer->pixels || radius <= 0) return;
+
+    premultiplied = raster_premultiply(color);
+    outer_r = radius + 0.5f;
+    inner_r = radius - 0.5f;
+
+    top = (int)floorf(cy - outer_r);
+    bottom = (int)ceilf(cy + outer_r);
+    if (top < 0) top = 0;
+    if (bottom > framebuffer->height) bottom = framebuffer->height;
+
+    for (row_index = top; row_index < bottom; row_index++) {
+        void* row = pixel_address(framebuffer, 0, row_index);
+        float dy = row_index + 0.5f - cy;
+        float outer_sq = outer_r * outer_r - dy * dy;
+        float inner_sq = inner_r > 0 ? inner_r * inner_r - dy * dy : -1.0f;
+        float outer, inner;
+        int first, last, inner_first, inner_last, px;
+
+        if (outer_sq <= 0) continue;
+        outer = sqrtf(outer_sq);
+
+        // Pixels whose centers are within half a pixel of the edge
+        first = (int)ceilf(cx - outer - 0.5f);
+        last = (int)floorf(cx + outer - 0.5f);
+        if (first < 0) first = 0;
+        if (last > framebuffer->width - 1) last = framebuffer->width - 1;
+        if (first > last) continue;
+
+        // Pixels entirely inside take the span fill
+        if (inner_sq > 0) {
+            inner = sqrtf(inner_sq);
+            inner_first = (int)ceilf(cx - inner - 0.5f);
+            inner_last = (int)floorf(cx + inner - 0.5f);
+            if (inner_first < first) inner_first = first;
+            if (inner_last > last) inner_last = last;
+        } else {
+            inner_first = last + 1;
+            inner_last = last;
+        }
+
+        for (px = first; px <= last; px++) {
+            float dx, distance;
+            if (px == inner_first && inner_first <= inner_last) {
+                fill_span(framebuffer->format, row, inner_first, inner_last + 1, premultiplied, 255);
+                px = inner_last;
+                continue;
+            }
+            dx = px + 0.5f - cx;
+            distance = sqrtf(dx * dx + dy * dy);
+            fill_span(framebuffer->format, row, px, px + 1, premultiplied, coverage_byte(radius - distance + 0.5f));
+        }
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE RasterCacheHandle raster_cache_create(void) {
+    return (struct RasterCache*)calloc(1, sizeof(struct RasterCache));
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_cache_destroy(RasterCacheHandle cache) {
+    if (!cache) return;
+
+    release_cache(cache);
+    free(cache);
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_draw_list(Framebuffer* framebuffer, DrawListHandle list, RasterCacheHandle cache) {
+    const DrawCommand* commands = draw_list_commands(list);
+    int count = draw_list_count(list);
+    struct RasterCache uncached;
+    DrawState state;
+    int masks = 0, shadows = 0;
+
+    if (!framebuffer || !framebuffer->pixels) return;
+    if (!cache) {
+        memset(&uncached, 0, sizeof(uncached));
+        cache = &uncached;
+    }
+
+    state.dx = 0;
+    state.dy = 0;
+    state.alpha = 255;
+    state.depth = 0;
+    state.masks = &masks;
+    state.shadows = &shadows;
+    state.matrices = draw_list_matrices(list);
+    state.matrix_count = draw_list_matrix_count(list);
+    draw_range(framebuffer, cache, commands, 0, count, &state);
+
+    if (cache == &uncached) release_cache(&uncached);
+}
+
+EMSCRIPTEN_KEEPALIVE void raster_unpremultiply(Framebuffer* framebuffer) {
+    int x, y;
+    if (!framebuffer || !framebuffer->pixels) return;
+
+    // Works the same whichever way round red and blue are
+    if (framebuffer->format != PIXEL_RGBA8 && framebuffer->format != PIXEL_BGRA8) return;
+
+    for (y = 0; y < framebuffer->height; y++) {
+        unsigned int* row = (unsigned int*)pixel_address(framebuffer, 0, y);
+        for (x = 0; x < framebuffer->width; x++) {
+            unsigned int pixel = row[x];
+            unsigned int alpha = pixel >> 24;
+            unsigned int r, g, b;
+            if (alpha == 0 || alpha == 255) continue;
+
+            r = ((pixel & 0xff) * 255 + alpha / 2) / alpha;
+            g = (((pixel >> 8) & 0xff) * 255 + alpha / 2) / alpha;
+            b = (((pixel >> 16) & 0xff) * 255 + alpha / 2) / alpha;
+            row[x] = (r > 255 ? 255 : r) | ((g > 255 ? 255 : g) << 8) | ((b > 255 ? 255 : b) << 16) | (alpha << 24);
+        }
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE int raster_blit(const Framebuffer* source, Framebuffer* target) {
+    unsigned int chunk[RASTER_CHUNK];
+    int x, y, count;
+    if (!source || !target || !source->pixels || !target->pixels) return -1;
+    if (source->width != target->width || source->height != target->height) return -1;
+    if (pixel_format_bytes(source->format) == 0 || pixel_format_bytes(target->format) == 0) return -1;
+
+    for (y = 0; y < source->height; y++) {
+        for (x = 0; x < source->width; x += count) {
+            count = source->width - x < RASTER_CHUNK ? source->width - x : RASTER_CHUNK;
+            load_row(source->format, pixel_address(source, x, y), chunk, count);
+            store_row(target->format, pixel_address(target, x, y), chunk, count);
+        }
+    }
+    return 0;
+}
@@ -3,6 +3,8 @@
 #include <emscripten.h>
 #include <emscripten/console.h>
 #include "renderer.h"
+#include "pipeline.h"
+#include "geometry.h"
 
 // HTML5 Canvas API functions we'll call from JavaScript
 EM_JS(void, js_get_canvas_context, (int canvas_id, int width, int height), {
@@ -26,6 +28,14 @@ EM_JS(void, js_get_canvas_context, (int canvas_id, int width, int height), {
     
     const ctx = canvas.getContext('2d');
     window.flareCanvasContexts[canvas_id] = ctx;
+
+    // Geometry versions start over with a new renderer
+    if (window.flarePathCaches) {
+        delete window.flarePathCaches[canvas_id];
+    }
+    if (window.flareMaskLayers) {
+        delete window.flareMaskLayers[canvas_id];
+    }
     
     // Draw a test pattern to verify the context is working
     ctx.fillStyle = 'purple';
@@ -35,29 +45,352 @@ EM_JS(void, js_get_canvas_context, (int canvas_id, int width, int height), {
     return 1;
 });
 
-EM_JS(void, js_clear_canvas, (int canvas_id, int width, int height), {
+// Replay a frame's draw list onto the canvas. Commands are DrawCommand
+// records of 9 32-bit words: type, color, x, y, width, height, tag,
+// geometry, version.
+//
+// Canvas state changes are the expensive part, so consecutive commands of
+// one color are filled together as subpaths of a single path, and fillStyle
+// is only assigned when the color changes. Runs never reorder commands. A
+// translucent command starts a new run when it overlaps the current one,
+// since a single fill would paint the overlap once instead of twice.
+//
+// A circle drawn on its own is filled from a Path2D cached per geometry id
+// and version, built around the origin and moved into place with
+// setTransform, so a shape that only moves keeps the path the browser has
+// already processed. Rectangles have fillRect, and longer runs are still
+// cheaper as a single fill.
+//
+// Masked commands are drawn as the rasterizer draws them: a lone rectangle
+// on whole pixels becomes a clip(), anything else draws into an offscreen
+// layer that's cut down to the mask with destination-in before it's
+// composited. Each mask's own canvas is only redrawn when its shapes change.
+//
+// Groups draw into a canvas from a small pool, one per nesting level, which
+// is composited with the group's opacity and blend mode at its end. As in
+// the rasterizer, groups nested deeper than the pool only fade their
+// children with globalAlpha. A group's blur and drop-shadow filters become
+// the canvas filter it's composited with, and its color matrices SVG
+// feColorMatrix filters it refers to by url(), one per matrix in a frame.
+EM_JS(void, js_replay_draw_list, (int canvas_id, const DrawCommand* commands, int count,
+                                  const float* matrices, int matrix_count, double width, double height), {
     const ctx = window.flareCanvasContexts[canvas_id];
-    if (ctx) {
-        ctx.clearRect(0, 0, width, height);
+    if (!ctx) return;
+
+    if (!window.flarePathCaches) {
+        window.flarePathCaches = {};
     }
-});
+    if (!window.flareMaskLayers) {
+        window.flareMaskLayers = {};
+    }
+    const cache = window.flarePathCaches[canvas_id] || (window.flarePathCaches[canvas_id] = new Map());
+    const layers = window.flareMaskLayers[canvas_id] ||
+        (window.flareMaskLayers[canvas_id] = { content: null, masks: [], groups: [], colors: [], svg: null });
 
-EM_JS(void, js_draw_rectangle, (int canvas_id, double x, double y, double width, double height, const char* fill_color), {
-    const ctx = window.flareCanvasContexts[canvas_id];
-    if (ctx) {
-        ctx.fillStyle = UTF8ToString(fill_color);
-        ctx.fillRect(x, y, width, height);
+    const run = [];                 // Word offsets of the commands in the current run
+    let runColor = 0;
+    let left = 0, top = 0, right = 0, bottom = 0;
+    let target = ctx;               // The canvas, or the layer of the current mask
+    let fillColor = -1;             // Color target's fillStyle was last set to
+    let mask = null;                // The current mask: its mode, shape offsets and state
+    let maskIndex = 0;
+    let colorIndex = 0;
+    const groups = [];              // Open groups, innermost last
+    const GROUP_LAYERS = 4;
+    const BLEND_MODES = ['source-over', 'multiply', 'screen', 'overlay', 'lighter'];
+
+    const rgba = (color) => 'rgba(' + (color & 255) + ',' + ((color >>> 8) & 255) + ',' +
+        ((color >>> 16) & 255) + ',' + ((color >>> 24) / 255) + ')';
+    const snap = (value) => Math.floor(value + 0.5);
+
+    const flush = () => {
+        if (run.length === 0) return;
+        if (runColor !== fillColor) {
+            target.fillStyle = rgba(runColor);
+            fillColor = runColor;
+        }
+
+        const first = run[0];
+        const geometry = HEAPU32[first + 7];
+        if (run.length === 1 && HEAPU32[first] === 1 && geometry !== 0) {
+            const version = HEAPU32[first + 8];
+            let entry = cache.get(geometry);
+            if (!entry || entry.version !== version) {
+                entry = { version: version, path: new Path2D() };
+                entry.path.arc(0, 0, HEAPF32[first + 4], 0, Math.PI * 2);
+                cache.set(geometry, entry);
+            }
+
+            target.setTransform(1, 0, 0, 1, HEAPF32[first + 2], HEAPF32[first + 3]);
+            target.fill(entry.path);
+            target.setTransform(1, 0, 0, 1, 0, 0);
+        } else if (run.length === 1 && HEAPU32[first] === 0) {
+            target.fillRect(HEAPF32[first + 2], HEAPF32[first + 3], HEAPF32[first + 4], HEAPF32[first + 5]);
+        } else {
+            target.beginPath();
+            for (const p of run) {
+                const x = HEAPF32[p + 2], y = HEAPF32[p + 3], w = HEAPF32[p + 4], h = HEAPF32[p + 5];
+                if (HEAPU32[p] === 1) {
+                    target.moveTo(x + w, y);
+                    target.arc(x, y, w, 0, Math.PI * 2);
+                } else {
+                    // Keep every subpath wound the same way, or overlaps cancel out
+                    target.rect(w < 0 ? x + w : x, h < 0 ? y + h : y, Math.abs(w), Math.abs(h));
+                }
+            }
+            target.fill();
+        }
+        run.length = 0;
+    };
+
+    // Canvas for the mask's coverage, redrawn only when its shapes change.
+    // Clip masks ignore fill alpha and cut rectangles on whole pixels.
+    const maskCanvas = () => {
+        const key = mask.mode + ':' + mask.shapes.map((p) => HEAPU32.subarray(p, p + 6).join(',')).join(';');
+        let entry = layers.masks[maskIndex];
+        if (!entry) {
+            entry = layers.masks[maskIndex] = { canvas: document.createElement('canvas'), key: null };
+        }
+        if (entry.key === key && entry.canvas.width === width && entry.canvas.height === height) {
+            return entry.canvas;
+        }
+
+        entry.canvas.width = width;
+        entry.canvas.height = height;
+        const m = entry.canvas.getContext('2d');
+        m.clearRect(0, 0, width, height);
+        for (const p of mask.shapes) {
+            const color = HEAPU32[p + 1];
+            const x = HEAPF32[p + 2], y = HEAPF32[p + 3], w = HEAPF32[p + 4], h = HEAPF32[p + 5];
+            if (HEAPU32[p] >= 2 || (mask.mode === 0 && (color >>> 24) === 0)) continue;
+
+            m.fillStyle = mask.mode === 1 ? '#000' : rgba(color);
+            m.beginPath();
+            if (HEAPU32[p] === 1) {
+                if (!(w > 0)) continue;
+                m.arc(x, y, w, 0, Math.PI * 2);
+            } else if (mask.mode === 1) {
+                const x0 = snap(Math.min(x, x + w)), y0 = snap(Math.min(y, y + h));
+                m.rect(x0, y0, snap(Math.max(x, x + w)) - x0, snap(Math.max(y, y + h)) - y0);
+            } else {
+                m.rect(Math.min(x, x + w), Math.min(y, y + h), Math.abs(w), Math.abs(h));
+            }
+            m.fill();
+        }
+        entry.key = key;
+        return entry.canvas;
+    };
+
+    const beginMasked = () => {
+        const shapes = mask.shapes;
+        const p = shapes[0];
+        mask.content = true;
+        mask.groups = groups.length;
+
+        if (shapes.length === 1 && HEAPU32[p] === 0) {
+            const x = HEAPF32[p + 2], y = HEAPF32[p + 3], w = HEAPF32[p + 4], h = HEAPF32[p + 5];
+            if (mask.mode === 1 || ((HEAPU32[p + 1] >>> 24) === 255 && Number.isInteger(x) &&
+                Number.isInteger(y) && Number.isInteger(w) && Number.isInteger(h))) {
+                const x0 = snap(Math.min(x, x + w)), y0 = snap(Math.min(y, y + h));
+                target.save();
+                target.beginPath();
+                target.rect(x0, y0, snap(Math.max(x, x + w)) - x0, snap(Math.max(y, y + h)) - y0);
+                target.clip();
+                mask.scissor = true;
+                return;
+            }
+        }
+
+        if (!layers.content) {
+            layers.content = document.createElement('canvas').getContext('2d');
+        }
+        const layer = layers.content;
+        if (layer.canvas.width !== width || layer.canvas.height !== height) {
+            layer.canvas.width = width;
+            layer.canvas.height = height;
+        } else {
+            layer.clearRect(0, 0, width, height);
+        }
+        target = layer;
+        fillColor = -1;
+    };
+
+    const beginGroup = (mode, opacity) => {
+        if (groups.length >= GROUP_LAYERS) {
+            groups.push({ alpha: target.globalAlpha });
+            target.globalAlpha *= opacity;
+            return;
+        }
+
+        const pool = layers.groups;
+        if (!pool[groups.length]) {
+            pool[groups.length] = document.createElement('canvas').getContext('2d');
+        }
+        const layer = pool[groups.length];
+        if (layer.canvas.width !== width || layer.canvas.height !== height) {
+            layer.canvas.width = width;
+            layer.canvas.height = height;
+        } else {
+            layer.clearRect(0, 0, width, height);
+        }
+        groups.push({ parent: target, layer: layer, mode: mode, opacity: opacity, filters: [] });
+        target = layer;
+        fillColor = -1;
+    };
+
+    const endGroup = () => {
+        const group = groups.pop();
+        if (!group.layer) {
+            target.globalAlpha = group.alpha;
+            return;
+        }
+
+        target = group.parent;
+        fillColor = -1;
+        target.globalAlpha = group.opacity;
+        target.globalCompositeOperation = BLEND_MODES[group.mode] || 'source-over';
+        if (group.filters.length > 0) target.filter = group.filters.join(' ');
+        target.drawImage(group.layer.canvas, 0, 0);
+        target.globalAlpha = 1;
+        target.globalCompositeOperation = 'source-over';
+        if (group.filters.length > 0) target.filter = 'none';
+    };
+
+    // Reference to an SVG filter running the color matrix at `matrix`. The
+    // filters stay in the document, and only get new values when they change.
+    const colorFilter = (matrix) => {
+        const values = Array.from(HEAPF32.subarray(matrix, matrix + 20)).join(' ');
+        let entry = layers.colors[colorIndex];
+        if (!entry) {
+            const SVG = 'http://www.w3.org/2000/svg';
+            if (!layers.svg) {
+                layers.svg = document.createElementNS(SVG, 'svg');
+                layers.svg.setAttribute('width', '0');
+                layers.svg.setAttribute('height', '0');
+                layers.svg.style.position = 'absolute';
+                document.body.appendChild(layers.svg);
+            }
+            const filter = document.createElementNS(SVG, 'filter');
+            const node = document.createElementNS(SVG, 'feColorMatrix');
+            filter.id = 'flare-color-' + canvas_id + '-' + colorIndex;
+            filter.setAttribute('color-interpolation-filters', 'sRGB');
+            node.setAttribute('type', 'matrix');
+            filter.appendChild(node);
+            layers.svg.appendChild(filter);
+            entry = layers.colors[colorIndex] = { id: filter.id, node: node, values: null };
+        }
+        if (entry.values !== values) {
+            entry.node.setAttribute('values', values);
+            entry.values = values;
+        }
+        colorIndex++;
+        return 'url(#' + entry.id + ')';
+    };
+
+    const endMask = () => {
+        // Groups opened in the masked commands end with them
+        if (mask.content) {
+            flush();
+            while (groups.length > mask.groups) endGroup();
+        }
+
+        if (mask.scissor) {
+            // restore() puts fillStyle back too
+            target.restore();
+            fillColor = -1;
+        } else if (mask.content) {
+            const layer = target;
+            layer.globalCompositeOperation = 'destination-in';
+            layer.drawImage(maskCanvas(), 0, 0);
+            layer.globalCompositeOperation = 'source-over';
+            target = mask.parent;
+            fillColor = -1;
+            target.drawImage(layer.canvas, 0, 0);
+        }
+        maskIndex++;
+        mask = null;
+    };
+
+    ctx.clearRect(0, 0, width, height);
+    for (let i = 0; i < count; i++) {
+        const p = (commands >> 2) + i * 9;
+        const type = HEAPU32[p];
+        const color = HEAPU32[p + 1];
+        const x = HEAPF32[p + 2], y = HEAPF32[p + 3], w = HEAPF32[p + 4], h = HEAPF32[p + 5];
+        let x0, y0, x1, y1;
+
+        // Markers; ones without a mask or group to go with them do nothing.
+        // Group markers among a mask's shapes are kept with them but draw nothing.
+        if (type >= 2) {
+            if (type >= 5 && mask && !mask.content) {
+                mask.shapes.push(p);
+                continue;
+            }
+            flush();
+            if (type === 2) {
+                if (mask) endMask();
+                mask = { mode: color, shapes: [], parent: target, groups: 0, content: false, scissor: false };
+            } else if (type === 3 && mask && !mask.content) {
+                beginMasked();
+            } else if (type === 4 && mask) {
+                endMask();
+            } else if (type === 5) {
+                beginGroup(color, x);
+            } else if (type === 6 && groups.length > (mask ? mask.groups : 0)) {
+                endGroup();
+            } else if (type === 9 && groups.length > 0 && groups[groups.length - 1].layer) {
+                if (color < matrix_count) {
+                    groups[groups.length - 1].filters.push(colorFilter((matrices >> 2) + color * 20));
+                }
+            } else if (type >= 7 && groups.length > 0 && groups[groups.length - 1].layer) {
+                // Drop-shadow's blur radius is twice the standard deviation
+                const sigma = Math.min(w, 64);
+                groups[groups.length - 1].filters.push(type === 7 ? 'blur(' + sigma + 'px)' :
+                    'drop-shadow(' + Math.round(x) + 'px ' + Math.round(y) + 'px ' + 2 * sigma + 'px ' + rgba(color) + ')');
+            }
+            continue;
+        }
+        if (mask && !mask.content) {
+            mask.shapes.push(p);
+            continue;
+        }
+
+        if (type === 1) {
+            if (!(w > 0)) continue;
+            x0 = x - w; y0 = y - w; x1 = x + w; y1 = y + w;
+        } else {
+            x0 = Math.min(x, x + w); y0 = Math.min(y, y + h);
+            x1 = Math.max(x, x + w); y1 = Math.max(y, y + h);
+        }
+        // Fully transparent commands draw nothing and don't break a run
+        if ((color >>> 24) === 0) continue;
+
+        if (run.length > 0 && (color !== runColor ||
+            ((color >>> 24) < 255 && x0 < right && x1 > left && y0 < bottom && y1 > top))) {
+            flush();
+        }
+        if (run.length === 0) {
+            runColor = color;
+            left = x0; top = y0; right = x1; bottom = y1;
+        } else {
+            left = Math.min(left, x0); top = Math.min(top, y0);
+            right = Math.max(right, x1); bottom = Math.max(bottom, y1);
+        }
+        run.push(p);
     }
+    flush();
+    if (mask) endMask();
+    while (groups.length > 0) endGroup();
 });
 
-EM_JS(void, js_draw_circle, (int canvas_id, double x, double y, double radius, const char* fill_color), {
+// Show a rasterized frame. ImageData can't wrap shared memory, so threaded
+// builds need the copy slice() makes anyway.
+EM_JS(void, js_present_pixels, (int canvas_id, const unsigned int* pixels, int width, int height), {
     const ctx = window.flareCanvasContexts[canvas_id];
-    if (ctx) {
-        ctx.fillStyle = UTF8ToString(fill_color);
-        ctx.beginPath();
-        ctx.arc(x, y, radius, 0, Math.PI * 2);
-        ctx.fill();
-    }
+    if (!ctx) return;
+
+    const bytes = HEAPU8.slice(pixels, pixels + width * height * 4);
+    ctx.putImageData(new ImageData(new Uint8ClampedArray(bytes.buffer), width, height), 0, 0);
 });
 
 // Renderer structure
@@ -65,16 +398,89 @@ struct Renderer {
     int canvas_id;
     double width;
     double height;
+    int backend;                    // RendererBackend
+    FramePipelineHandle pipeline;
+    DrawListHandle frame;           // Draw list being recorded, or NULL
+    DrawListHandle presented;       // Copy of the frame on screen, for hit testing
+    GeometryTableHandle geometry;   // Versions of the tagged shapes, for path caching
+    Framebuffer converted;          // Frames in formats other than RGBA8, converted for ImageData
 };
 
+// A rasterized frame as RGBA8, which is what ImageData takes, or NULL if
+// it can't be converted
+static const Framebuffer* rgba8_frame(struct Renderer* renderer, const Framebuffer* frame) {
+    Framebuffer* converted = &renderer->converted;
+    if (frame->format == PIXEL_RGBA8) return frame;
+
+    if (converted->width != frame->width || converted->height != frame->height) {
+        framebuffer_release(converted);
+        if (framebuffer_init(converted, frame->width, frame->height) != 0) return NULL;
+    }
+    return raster_blit(frame, converted) == 0 ? converted : NULL;
+}
+
+// Present stage of the pipeline
+static void present_frame(void* context, const FramePacket* packet) {
+    struct Renderer* renderer = (struct Renderer*)context;
+
+    // Input is hit-tested against what the user sees, not the newest frame
+    draw_list_copy(renderer->presented, packet->list);
+
+    if (packet->framebuffer.pixels) {
+        const Framebuffer* frame = rgba8_frame(renderer, &packet->framebuffer);
+        if (frame) js_present_pixels(renderer->canvas_id, frame->pixels, frame->width, frame->height);
+    } else {
+        js_replay_draw_list(renderer->canvas_id, draw_list_commands(packet->list), draw_list_count(packet->list),
+                            draw_list_matrices(packet->list), draw_list_matrix_count(packet->list),
+                            renderer->width, renderer->height);
+    }
+}
+
+// Tagged shapes get their tag as geometry id, with a version that changes
+// when their size does
+static void set_geometry(struct Renderer* renderer, DrawListHandle frame,
+                         unsigned int type, float width, float height) {
+    unsigned int tag = draw_list_tag(frame);
+    if (tag) draw_list_set_geometry(frame, tag, geometry_table_version(renderer->geometry, tag, type, width, height));
+}
+
+// Frames are recorded from the first draw after a clear
+static DrawListHandle current_frame(struct Renderer* renderer) {
+    if (!renderer->frame) renderer->frame = pipeline_begin_frame(renderer->pipeline);
+    return renderer->frame;
+}
+
 // Implementation of the renderer functions
 RendererHandle renderer_create(int canvas_id, int width, int height) {
-    struct Renderer* renderer = (struct Renderer*)malloc(sizeof(struct Renderer));
+    struct Renderer* renderer = (struct Renderer*)calloc(1, sizeof(struct Renderer));
     if (!renderer) return NULL;
     
     renderer->canvas_id = canvas_id;
     renderer->width = width;
     renderer->height = height;
+    renderer->presented = draw_list_create();
+    renderer->geometry = geometry_table_create();
+    if (!renderer->presented || !renderer->geometry) {
+        draw_list_destroy(renderer->presented);
+        geometry_table_destroy(renderer->geometry);
+        free(renderer);
+        return NULL;
+    }
+
+    // Threaded builds rasterize on the pipeline's worker; the others replay
+    // draw lists onto the canvas, which only the main thread can touch
+    renderer->pipeline = pipeline_create(width > 0 ? width : 1, height > 0 ? height : 1, 0,
+                                         present_frame, renderer);
+    if (!renderer->pipeline) {
+        draw_list_destroy(renderer->presented);
+        geometry_table_destroy(renderer->geometry);
+        free(renderer);
+        return NULL;
+    }
+    renderer->backend = RENDERER_BACKEND_CANVAS;
+    if (pipeline_threaded(renderer->pipeline)) {
+        renderer_set_backend(renderer, RENDERER_BACKEND_SOFTWARE);
+    }
     
     // Initialize the canvas
     js_get_canvas_context(canvas_id, width, height);
@@ -84,29 +490,162 @@ RendererHandle renderer_create(int canvas_id, int width, int height) {
 
 void renderer_destroy(RendererHandle renderer) {
     if (renderer) {
+        pipeline_destroy(renderer->pipeline);
+        draw_list_destroy(renderer->presented);
+        geometry_table_destroy(renderer->geometry);
+        framebuffer_release(&renderer->converted);
         free(renderer);
     }
 }
 
 void renderer_clear(RendererHandle renderer) {
     if (!renderer) return;
-    js_clear_canvas(renderer->canvas_id, renderer->width, renderer->height);
+    renderer->frame = pipeline_begin_frame(renderer->pipeline);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_end_frame(RendererHandle renderer) {
+    if (!renderer || !renderer->frame) return;
+
+    renderer->frame = NULL;
+    pipeline_submit_frame(renderer->pipeline);
+}
+
+EMSCRIPTEN_KEEPALIVE int renderer_set_backend(RendererHandle renderer, int backend) {
+    if (!renderer) return -1;
+    if (backend != RENDERER_BACKEND_CANVAS && backend != RENDERER_BACKEND_SOFTWARE) return -1;
+
+    if (pipeline_set_rasterize(renderer->pipeline, backend == RENDERER_BACKEND_SOFTWARE) != 0) return -1;
+    renderer->backend = backend;
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int renderer_backend(RendererHandle renderer) {
+    return renderer ? renderer->backend : -1;
+}
+
+EMSCRIPTEN_KEEPALIVE int renderer_set_latency(RendererHandle renderer, int frames) {
+    if (!renderer) return -1;
+    return pipeline_set_latency(renderer->pipeline, frames);
+}
+
+EMSCRIPTEN_KEEPALIVE int renderer_threaded(RendererHandle renderer) {
+    return renderer ? pipeline_threaded(renderer->pipeline) : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_set_tag(RendererHandle renderer, unsigned int tag) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_set_tag(frame, tag);
+}
+
+EMSCRIPTEN_KEEPALIVE DrawListHandle renderer_presented_list(RendererHandle renderer) {
+    return renderer ? renderer->presented : NULL;
 }
 
 void renderer_draw_rectangle(RendererHandle renderer, 
                             double x, double y, 
                             double width, double height, 
                             const char* fill_color) {
+    DrawListHandle frame;
     if (!renderer) return;
-    js_draw_rectangle(renderer->canvas_id, x, y, width, height, fill_color);
+
+    frame = current_frame(renderer);
+    if (!frame) return;
+
+    set_geometry(renderer, frame, DRAW_RECTANGLE, (float)width, (float)height);
+    draw_list_add_rectangle(frame, (float)x, (float)y, (float)width, (float)height, draw_color_parse(fill_color));
 }
 
 EMSCRIPTEN_KEEPALIVE void renderer_draw_circle(RendererHandle renderer, 
                          double x, double y, 
                          double radius, 
                          const char* fill_color) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (!frame) return;
+
+    set_geometry(renderer, frame, DRAW_CIRCLE, (float)radius, (float)radius);
+    draw_list_add_circle(frame, (float)x, (float)y, (float)radius, draw_color_parse(fill_color));
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_begin_mask(RendererHandle renderer, int mode) {
+    DrawListHandle frame;
     if (!renderer) return;
-    js_draw_circle(renderer->canvas_id, x, y, radius, fill_color);
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_begin_mask(frame, mode);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_begin_masked(RendererHandle renderer) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_begin_masked(frame);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_end_mask(RendererHandle renderer) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_end_mask(frame);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_begin_group(RendererHandle renderer, double opacity, int mode) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_begin_group(frame, (float)opacity, mode);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_end_group(RendererHandle renderer) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_end_group(frame);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_add_blur(RendererHandle renderer, double radius) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_add_blur(frame, (float)radius);
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_add_shadow(RendererHandle renderer,
+                         double x, double y,
+                         double radius,
+                         const char* color) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_add_shadow(frame, (float)x, (float)y, (float)radius, draw_color_parse(color));
+}
+
+EMSCRIPTEN_KEEPALIVE void renderer_add_color_matrix(RendererHandle renderer, const float* matrix) {
+    DrawListHandle frame;
+    if (!renderer) return;
+
+    frame = current_frame(renderer);
+    if (frame) draw_list_add_color_matrix(frame, matrix);
+}
+
+EMSCRIPTEN_KEEPALIVE int renderer_draw_layers(RendererHandle renderer, LayerStackHandle stack, float time) {
+    DrawListHandle frame;
+    if (!renderer) return -1;
+
+    frame = current_frame(renderer);
+    if (!frame) return -1;
+    return layer_stack_evaluate(stack, time, frame);
 }
 
 // JavaScript function to resize the canvas
@@ -134,6 +673,7 @@ void renderer_resize(RendererHandle renderer, double width, double height) {
     // Update the renderer's internal dimensions
     renderer->width = width;
     renderer->height = height;
+    pipeline_resize(renderer->pipeline, width > 1 ? (int)width : 1, height > 1 ? (int)height : 1);
     
     // Resize the actual canvas element
     js_resize_canvas(renderer->canvas_id, width, height);
@@ -0,0 +1,133 @@
+#include <string.h>
+#include <emscripten.h>
+#include "sha256.h"
+
+static const unsigned int K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SIGMA0(x) (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define SIGMA1(x) (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define GAMMA0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+// Compress `count` consecutive 64-byte blocks
+static void sha256_blocks(unsigned int* state, const unsigned char* data, unsigned int count) {
+    unsigned int w[64];
+    unsigned int a, b, c, d, e, f, g, h, t1, t2;
+    int i;
+
+    while (count--) {
+        for (i = 0; i < 16; i++) {
+            w[i] = ((unsigned int)data[i * 4] << 24) | ((unsigned int)data[i * 4 + 1] << 16) |
+                   ((unsigned int)data[i * 4 + 2] << 8) | (unsigned int)data[i * 4 + 3];
+        }
+        for (i = 16; i < 64; i++) {
+            w[i] = GAMMA1(w[i - 2]) + w[i - 7] + GAMMA0(w[i - 15]) + w[i - 16];
+        }
+
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+        for (i = 0; i < 64; i++) {
+            t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + w[i];
+            t2 = SIGMA0(a) + MAJ(a, b, c);
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        data += 64;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE void sha256_init(Sha256* sha) {
+    static const unsigned int initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    if (!sha) return;
+
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length_low = 0;
+    sha->length_high = 0;
+    sha->buffered = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void sha256_update(Sha256* sha, const unsigned char* data, unsigned int size) {
+    unsigned int blocks;
+    if (!sha || !data || size == 0) return;
+
+    sha->length_low += size;
+    if (sha->length_low < size) sha->length_high++;
+
+    // Top up a partial block first
+    if (sha->buffered > 0) {
+        unsigned int n = 64 - sha->buffered;
+        if (n > size) n = size;
+        memcpy(sha->buffer + sha->buffered, data, n);
+        sha->buffered += n;
+        data += n;
+        size -= n;
+        if (sha->buffered < 64) return;
+        sha256_blocks(sha->state, sha->buffer, 1);
+        sha->buffered = 0;
+    }
+
+    // Whole blocks straight from the input, no copying
+    blocks = size / 64;
+    sha256_blocks(sha->state, data, blocks);
+    data += blocks * 64;
+    size -= blocks * 64;
+
+    memcpy(sha->buffer, data, size);
+    sha->buffered = size;
+}
+
+EMSCRIPTEN_KEEPALIVE void sha256_final(Sha256* sha, unsigned char* digest) {
+    unsigned int high, low;
+    int i;
+    if (!sha || !digest) return;
+
+    // Length in bits, taken before padding changes the count
+    high = (sha->length_high << 3) | (sha->length_low >> 29);
+    low = sha->length_low << 3;
+
+    sha->buffer[sha->buffered++] = 0x80;
+    if (sha->buffered > 56) {
+        memset(sha->buffer + sha->buffered, 0, 64 - sha->buffered);
+        sha256_blocks(sha->state, sha->buffer, 1);
+        sha->buffered = 0;
+    }
+    memset(sha->buffer + sha->buffered, 0, 56 - sha->buffered);
+
+    for (i = 0; i < 4; i++) {
+        sha->buffer[56 + i] = (unsigned char)(high >> (24 - 8 * i));
+        sha->buffer[60 + i] = (unsigned char)(low >> (24 - 8 * i));
+    }
+    sha256_blocks(sha->state, sha->buffer, 1);
+
+    for (i = 0; i < 8; i++) {
+        digest[i * 4] = (unsigned char)(sha->state[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char)(sha->state[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char)(sha->state[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char)sha->state[i];
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE void sha256_digest(const unsigned char* data, unsigned int size, unsigned char* digest) {
+    Sha256 sha;
+    sha256_init(&sha);
+    sha256_update(&sha, data, size);
+    sha256_final(&sha, digest);
+}
@@ -0,0 +1,7 @@
+#include <emscripten.h>
+#include "simd.h"
+
+// Lets the loader confirm which module variant it ended up with
+EMSCRIPTEN_KEEPALIVE int flare_simd_enabled(void) {
+    return FLARE_SIMD;
+}
@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <emscripten.h>
+#include "thread_pool.h"
+
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#include <pthread.h>
+#include <semaphore.h>
+#define THREAD_POOL_THREADS 1
+#else
+#define THREAD_POOL_THREADS 0
+#endif
+
+// Pool structure
+struct ThreadPool {
+    int workers;
+
+    // The batch being run
+    ThreadPoolTask task;
+    void* context;
+    int count;
+    int next;                   // Next task index to hand out
+
+#if THREAD_POOL_THREADS
+    pthread_t threads[THREAD_POOL_MAX_WORKERS];
+    sem_t start;                // Posted once per worker for each batch, and to stop
+    sem_t finished;             // Posted by each worker when it runs out of tasks
+    int stopping;
+#endif
+};
+
+// Take tasks until none are left
+static void run_tasks(struct ThreadPool* pool) {
+    int index;
+    while ((index = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->count) {
+        pool->task(pool->context, index);
+    }
+}
+
+#if THREAD_POOL_THREADS
+static void* pool_worker(void* arg) {
+    struct ThreadPool* pool = (struct ThreadPool*)arg;
+
+    for (;;) {
+        sem_wait(&pool->start);
+        if (__atomic_load_n(&pool->stopping, __ATOMIC_ACQUIRE)) break;
+
+        run_tasks(pool);
+        sem_post(&pool->finished);
+    }
+    return NULL;
+}
+#endif
+
+EMSCRIPTEN_KEEPALIVE ThreadPoolHandle thread_pool_create(int workers) {
+    struct ThreadPool* pool = (struct ThreadPool*)calloc(1, sizeof(struct ThreadPool));
+    if (!pool) return NULL;
+
+#if THREAD_POOL_THREADS
+    if (workers > THREAD_POOL_MAX_WORKERS) workers = THREAD_POOL_MAX_WORKERS;
+    if (workers > 0 && sem_init(&pool->start, 0, 0) == 0) {
+        if (sem_init(&pool->finished, 0, 0) == 0) {
+            while (pool->workers < workers &&
+                   pthread_create(&pool->threads[pool->workers], NULL, pool_worker, pool) == 0) {
+                pool->workers++;
+            }
+        }
+        if (pool->workers == 0) {
+            sem_destroy(&pool->finished);
+            sem_destroy(&pool->start);
+        }
+    }
+#else
+    (void)workers;
+#endif
+    return pool;
+}
+
+EMSCRIPTEN_KEEPALIVE void thread_pool_destroy(ThreadPoolHandle pool) {
+    if (!pool) return;
+
+#if THREAD_POOL_THREADS
+    if (pool->workers > 0) {
+        int i;
+        __atomic_store_n(&pool->stopping, 1, __ATOMIC_RELEASE);
+        for (i = 0; i < pool->workers; i++) sem_post(&pool->start);
+        for (i = 0; i < pool->workers; i++) pthread_join(pool->threads[i], NULL);
+        sem_destroy(&pool->finished);
+        sem_destroy(&pool->start);
+    }
+#endif
+    free(pool);
+}
+
+EMSCRIPTEN_KEEPALIVE int thread_pool_workers(ThreadPoolHandle pool) {
+    return pool ? pool->workers : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void thread_pool_run(ThreadPoolHandle pool, ThreadPoolTask task, void* context, int count) {
+    int i;
+    if (!task || count <= 0) return;
+
+    if (!pool || pool->workers == 0 || count == 1) {
+        for (i = 0; i < count; i++) task(context, i);
+        return;
+    }
+
+    pool->task = task;
+    pool->context = context;
+    pool->count = count;
+    pool->next = 0;
+
+#if THREAD_POOL_THREADS
+    // The semaphores order the batch setup before the workers read it, and
+    // the workers' results before we return
+    for (i = 0; i < pool->workers; i++) sem_post(&pool->start);
+    run_tasks(pool);
+    for (i = 0; i < pool->workers; i++) sem_wait(&pool->finished);
+#else
+    run_tasks(pool);
+#endif
+}
@@ -0,0 +1,101 @@
+#include <float.h>
+#include <emscripten.h>
+#include "vertex.h"
+#include "simd.h"
+
+// Fold four lanes of running minimums and maximums into the bounds
+static void reduce_bounds(f32x4 min_x, f32x4 min_y, f32x4 max_x, f32x4 max_y, VertexBounds* bounds) {
+    float lanes[4][4];
+    int i;
+
+    f32x4_store(lanes[0], min_x);
+    f32x4_store(lanes[1], min_y);
+    f32x4_store(lanes[2], max_x);
+    f32x4_store(lanes[3], max_y);
+    for (i = 0; i < 4; i++) {
+        if (lanes[0][i] < bounds->min_x) bounds->min_x = lanes[0][i];
+        if (lanes[1][i] < bounds->min_y) bounds->min_y = lanes[1][i];
+        if (lanes[2][i] > bounds->max_x) bounds->max_x = lanes[2][i];
+        if (lanes[3][i] > bounds->max_y) bounds->max_y = lanes[3][i];
+    }
+}
+
+static void include_point(VertexBounds* bounds, float x, float y) {
+    if (x < bounds->min_x) bounds->min_x = x;
+    if (y < bounds->min_y) bounds->min_y = y;
+    if (x > bounds->max_x) bounds->max_x = x;
+    if (y > bounds->max_y) bounds->max_y = y;
+}
+
+EMSCRIPTEN_KEEPALIVE void vertex_transform(const float* transform, const float* xs, const float* ys,
+                                           float* out_xs, float* out_ys, int count, VertexBounds* bounds) {
+    VertexBounds result = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+    f32x4 a, b, c, d, e, f;
+    f32x4 min_x, min_y, max_x, max_y;
+    int i = 0;
+
+    if (!transform || count <= 0 || !xs || !ys || !out_xs || !out_ys) {
+        if (bounds) *bounds = result;
+        return;
+    }
+
+    a = f32x4_splat(transform[0]);
+    b = f32x4_splat(transform[1]);
+    c = f32x4_splat(transform[2]);
+    d = f32x4_splat(transform[3]);
+    e = f32x4_splat(transform[4]);
+    f = f32x4_splat(transform[5]);
+    min_x = min_y = f32x4_splat(FLT_MAX);
+    max_x = max_y = f32x4_splat(-FLT_MAX);
+
+    for (; i + 4 <= count; i += 4) {
+        f32x4 x = f32x4_load(xs + i);
+        f32x4 y = f32x4_load(ys + i);
+        f32x4 tx = f32x4_add(f32x4_add(f32x4_mul(a, x), f32x4_mul(c, y)), e);
+        f32x4 ty = f32x4_add(f32x4_add(f32x4_mul(b, x), f32x4_mul(d, y)), f);
+
+        f32x4_store(out_xs + i, tx);
+        f32x4_store(out_ys + i, ty);
+        min_x = f32x4_min(min_x, tx);
+        min_y = f32x4_min(min_y, ty);
+        max_x = f32x4_max(max_x, tx);
+        max_y = f32x4_max(max_y, ty);
+    }
+    reduce_bounds(min_x, min_y, max_x, max_y, &result);
+
+    for (; i < count; i++) {
+        float x = xs[i], y = ys[i];
+        out_xs[i] = transform[0] * x + transform[2] * y + transform[4];
+        out_ys[i] = transform[1] * x + transform[3] * y + transform[5];
+        include_point(&result, out_xs[i], out_ys[i]);
+    }
+
+    if (bounds) *bounds = result;
+}
+
+EMSCRIPTEN_KEEPALIVE void vertex_bounds(const float* xs, const float* ys, int count, VertexBounds* bounds) {
+    VertexBounds result = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+    f32x4 min_x, min_y, max_x, max_y;
+    int i = 0;
+
+    if (!bounds) return;
+    if (count <= 0 || !xs || !ys) {
+        *bounds = result;
+        return;
+    }
+
+    min_x = min_y = f32x4_splat(FLT_MAX);
+    max_x = max_y = f32x4_splat(-FLT_MAX);
+    for (; i + 4 <= count; i += 4) {
+        f32x4 x = f32x4_load(xs + i);
+        f32x4 y = f32x4_load(ys + i);
+        min_x = f32x4_min(min_x, x);
+        min_y = f32x4_min(min_y, y);
+        max_x = f32x4_max(max_x, x);
+        max_y = f32x4_max(max_y, y);
+    }
+    reduce_bounds(min_x, min_y, max_x, max_y, &result);
+
+    for (; i < count; i++) include_point(&result, xs[i], ys[i]);
+    *bounds = result;
+}
@@ -57,6 +57,10 @@ module.exports = {
       patterns: [
         { from: 'src/wasm/flare_runtime.js', to: 'wasm/flare_runtime.js' },
         { from: 'src/wasm/flare_runtime.wasm', to: 'wasm/flare_runtime.wasm' },
+        { from: 'src/wasm/flare_runtime_simd.js', to: 'wasm/flare_runtime_simd.js' },
+        { from: 'src/wasm/flare_runtime_simd.wasm', to: 'wasm/flare_runtime_simd.wasm' },
+        { from: 'src/wasm/flare_runtime_threads.js', to: 'wasm/flare_runtime_threads.js' },
+        { from: 'src/wasm/flare_runtime_threads.wasm', to: 'wasm/flare_runtime_threads.wasm' },
         { from: '../../examples/basic-animation/test.json', to: 'test.json' }
       ],
     }),
@@ -67,5 +71,10 @@ module.exports = {
     },
     compress: true,
     port: 9000,
+    // Cross-origin isolation, so the threaded module can use shared memory
+    headers: {
+      'Cross-Origin-Opener-Policy': 'same-origin',
+      'Cross-Origin-Embedder-Policy': 'require-corp'
+    },
   },
 };
\ No newline at end of file
@@ -37,12 +37,20 @@ export enum ElementType {
     elements: Element[];
   }
   
+  // Layer types. Types the runtime doesn't know draw as normal layers.
+  export enum LayerType {
+    NORMAL = 'normal',
+    MASK = 'mask',    // Not drawn; its shapes limit the layers it masks by coverage and fill alpha
+    CLIP = 'clip',    // Not drawn; its shapes limit the layers it masks by coverage alone
+  }
+
   export interface Layer {
     id: string;
-    type: string;
+    type: string;     // LayerType
     frames: Frame[];
     locked: boolean;
     visible: boolean;
+    masks?: number;   // Mask and clip layers: how many of the following layers they apply to, 1 if unset
   }
   
   export interface Timeline {
@@ -56,4 +64,5 @@ export enum ElementType {
     };
     layers: Layer[];
     scripts: any[];
+    loop?: boolean;   // Whether playback wraps to the first frame at the end, true if unset
   }
\ No newline at end of file
@@ -1,5 +1,5 @@
 import { AnimationEngine } from '../packages/runtime/src/animation/animation-engine';
-import { Timeline, Element, ElementType } from '@flare/shared';
+import { Timeline, Layer, Element, ElementType, LayerType } from '@flare/shared';
 import { EventTriggerType } from '../packages/runtime/src/animation/events';
 
 describe('AnimationEngine Integration Tests', () => {
@@ -196,6 +196,70 @@ describe('AnimationEngine Integration Tests', () => {
       // Should be at the final frame's value
       expect(circle2?.properties.radius).toBeCloseTo(50, 0); // Final value of radius animation
     });
+
+    test('a timeline that does not loop holds its last frame', () => {
+      const once = new AnimationEngine({ ...testTimeline, loop: false });
+      once.play();
+      (once as any).advanceFrames(250);
+      expect(once.getCurrentFrame()).toBe(250);
+
+      (once as any).advanceFrames(100);
+      expect(once.getCurrentFrame()).toBe(299);
+      expect((once as any).isPlaying).toBe(false);
+    });
+
+    test('a timeline loops unless it says otherwise', () => {
+      engine.play();
+      (engine as any).advanceFrames(310);
+      expect(engine.getCurrentFrame()).toBe(10);
+      engine.pause();
+    });
+  });
+
+  describe('Sub-frame Interpolation', () => {
+    let engine: AnimationEngine;
+
+    beforeEach(() => {
+      engine = new AnimationEngine(testTimeline);
+    });
+
+    test('should evaluate tracks at fractional seek times', () => {
+      engine.seekToFrame(30.5);
+      expect(engine.getCurrentFrame()).toBe(30);
+      expect(engine.getCurrentTime()).toBeCloseTo(30.5);
+
+      const circle = engine.getCurrentElements().find(el => el.id === 'circle');
+      expect(circle?.properties.x).toBeCloseTo(100 + 200 * 30.5 / 60);
+    });
+
+    test('should snap to whole frames when disabled', () => {
+      engine.setSubFrameInterpolation(false);
+      engine.seekToFrame(30.5);
+
+      const circle = engine.getCurrentElements().find(el => el.id === 'circle');
+      expect(circle?.properties.x).toBeCloseTo(200);
+    });
+
+    test('should interpolate at the presentation time between ticks', () => {
+      const nowSpy = jest.spyOn(performance, 'now');
+      nowSpy.mockReturnValue(1000);
+      engine.play();
+      engine.pause();
+
+      // 60fps: 2.5 frame times after play is frame 2, halfway to frame 3
+      nowSpy.mockReturnValue(1000 + 2.5 * 1000 / 60);
+      (engine as any).animationLoop();
+      nowSpy.mockRestore();
+
+      expect(engine.getCurrentFrame()).toBe(2);
+      expect(engine.getCurrentTime()).toBeCloseTo(2.5);
+    });
+
+    test('should reset the fraction on stop', () => {
+      engine.seekToFrame(10.25);
+      engine.stop();
+      expect(engine.getCurrentTime()).toBe(0);
+    });
   });
   
   describe('Color Animation', () => {
@@ -266,6 +330,90 @@ describe('AnimationEngine Integration Tests', () => {
     });
   });
   
+  describe('Mask Layers', () => {
+    const layer = (id: string, type: string, extra: Partial<Layer> = {}): Layer => ({
+      id,
+      type,
+      visible: true,
+      locked: false,
+      frames: [{
+        startFrame: 0,
+        duration: 60,
+        elements: [{
+          id: id + 'Rect',
+          type: ElementType.RECTANGLE,
+          properties: { x: 0, y: 0, width: 10, height: 10, fill: '#000000' },
+          animations: [{
+            property: 'width',
+            keyframes: [
+              { frame: 0, value: 0, easing: 'linear' },
+              { frame: 60, value: 600, easing: 'linear' }
+            ]
+          }]
+        }]
+      }],
+      ...extra
+    });
+
+    const maskTimeline = (layers: Layer[]): Timeline => ({
+      version: '1.0',
+      frameRate: 60,
+      duration: 60,
+      dimensions: { width: 600, height: 400, responsive: false },
+      layers,
+      scripts: []
+    });
+
+    test('should apply a mask to the layer after it', () => {
+      const engine = new AnimationEngine(maskTimeline([
+        layer('background', LayerType.NORMAL),
+        layer('wipe', LayerType.MASK),
+        layer('content', LayerType.NORMAL),
+        layer('overlay', LayerType.NORMAL)
+      ]));
+      engine.seekToFrame(30);
+
+      const layers = engine.getCurrentLayers();
+      expect(layers.map(l => l.id)).toEqual(['background', 'wipe', 'content', 'overlay']);
+      expect(layers.map(l => l.mask)).toEqual([-1, -1, 1, -1]);
+
+      // The mask's shapes animate like any others
+      expect(layers[1].elements[0].properties.width).toBeCloseTo(300);
+    });
+
+    test('should apply a clip to as many layers as it masks', () => {
+      const engine = new AnimationEngine(maskTimeline([
+        layer('clip', LayerType.CLIP, { masks: 2 }),
+        layer('first', LayerType.NORMAL),
+        layer('hidden', LayerType.NORMAL, { visible: false }),
+        layer('after', LayerType.NORMAL)
+      ]));
+
+      const layers = engine.getCurrentLayers();
+      expect(layers.map(l => [l.id, l.mask])).toEqual([['clip', -1], ['first', 0], ['after', -1]]);
+    });
+
+    test('should not mask with a hidden mask', () => {
+      const engine = new AnimationEngine(maskTimeline([
+        layer('wipe', LayerType.MASK, { visible: false }),
+        layer('content', LayerType.NORMAL)
+      ]));
+
+      const layers = engine.getCurrentLayers();
+      expect(layers.map(l => [l.id, l.mask])).toEqual([['content', -1]]);
+    });
+
+    test('should keep an empty mask, which hides what it masks', () => {
+      const empty = layer('wipe', LayerType.MASK);
+      empty.frames[0].startFrame = 30;
+      const engine = new AnimationEngine(maskTimeline([empty, layer('content', LayerType.NORMAL)]));
+
+      const layers = engine.getCurrentLayers();
+      expect(layers[0].elements).toHaveLength(0);
+      expect(layers[1].mask).toBe(0);
+    });
+  });
+  
   describe('Full Integration', () => {
     let engine: AnimationEngine;
     
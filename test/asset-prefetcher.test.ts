@@ -0,0 +1,50 @@
+import { AssetPrefetcher } from '../packages/runtime/src/asset-prefetcher';
+import { ElementType, Timeline } from '@flare/shared';
+
+describe('AssetPrefetcher', () => {
+  const timeline: Timeline = {
+    version: '1.0',
+    frameRate: 30,
+    duration: 90,
+    dimensions: { width: 100, height: 100, responsive: false },
+    layers: [
+      {
+        id: 'images',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [
+          {
+            startFrame: 60,
+            duration: 30,
+            elements: [
+              { id: 'logo', type: ElementType.IMAGE, properties: { src: 'logo.png' } }
+            ]
+          }
+        ]
+      }
+    ],
+    scripts: []
+  };
+
+  const archive = {
+    names: () => ['logo.png'],
+    has: (name: string) => name === 'logo.png',
+    isLoaded: () => false,
+    load: jest.fn()
+  };
+
+  const createWasm = () => ({ createAssetScheduler: jest.fn(() => 1) });
+
+  test('should schedule a looping timeline as looping', () => {
+    const wasm = createWasm();
+    new AssetPrefetcher(wasm as any, archive, timeline);
+    expect(wasm.createAssetScheduler).toHaveBeenCalledWith(90, true, [[[60, 90]]]);
+  });
+
+  test('should pass on a timeline that plays once', () => {
+    const wasm = createWasm();
+    new AssetPrefetcher(wasm as any, archive, { ...timeline, loop: false });
+    expect(wasm.createAssetScheduler).toHaveBeenCalledWith(90, false, [[[60, 90]]]);
+  });
+});
@@ -0,0 +1,158 @@
+import { CheckpointRing } from '../packages/runtime/src/animation/checkpoints';
+import { AnimationEngine } from '../packages/runtime/src/animation/animation-engine';
+import { AnimationGroupType } from '../packages/runtime/src/animation/groups';
+import { Timeline, ElementType } from '@flare/shared';
+
+describe('Playback Checkpoints', () => {
+  describe('CheckpointRing', () => {
+    test('should find the latest checkpoint at or before a frame', () => {
+      const ring = new CheckpointRing<string>(10);
+      [0, 10, 20].forEach(frame => ring.record(frame, `state${frame}`));
+
+      expect(ring.nearest(19)?.frame).toBe(10);
+      expect(ring.nearest(20)?.state).toBe('state20');
+      expect(ring.nearest(1000)?.frame).toBe(20);
+    });
+
+    test('should drop the earliest checkpoint when full', () => {
+      const ring = new CheckpointRing<string>(10, 3);
+      [0, 10, 20, 30].forEach(frame => ring.record(frame, `state${frame}`));
+
+      expect(ring.getFrames()).toEqual([10, 20, 30]);
+      expect(ring.nearest(5)).toBeNull();
+
+      // Nothing is kept for a frame before everything stored
+      ring.record(5, 'early');
+      expect(ring.getFrames()).toEqual([10, 20, 30]);
+    });
+
+    test('should replace and invalidate checkpoints', () => {
+      const ring = new CheckpointRing<string>(10);
+      [0, 10, 20].forEach(frame => ring.record(frame, `state${frame}`));
+
+      ring.record(10, 'replaced');
+      expect(ring.size).toBe(3);
+      expect(ring.nearest(15)?.state).toBe('replaced');
+
+      ring.invalidateFrom(10);
+      expect(ring.getFrames()).toEqual([0]);
+    });
+  });
+
+  describe('AnimationEngine integration', () => {
+    const timeline: Timeline = {
+      version: '1.0',
+      frameRate: 60,
+      duration: 100,
+      dimensions: { width: 400, height: 300, responsive: false },
+      layers: [{
+        id: 'layer',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [{
+          startFrame: 0,
+          duration: 100,
+          elements: [
+            { id: 'a', type: ElementType.CIRCLE, properties: { x: 10, y: 0, radius: 10, fill: '#000000' } },
+            { id: 'b', type: ElementType.CIRCLE, properties: { x: 20, y: 0, radius: 20, fill: '#000000' } }
+          ]
+        }]
+      }],
+      scripts: []
+    };
+
+    let engine: AnimationEngine;
+    let stepComplete: jest.Mock;
+    let sequenceComplete: jest.Mock;
+
+    beforeEach(() => {
+      engine = new AnimationEngine(JSON.parse(JSON.stringify(timeline)));
+      engine.setCheckpointInterval(10);
+      engine.registerGroup({
+        id: 'first',
+        type: AnimationGroupType.PARALLEL,
+        elementIds: ['a'],
+        properties: ['radius'],
+        startFrame: 10,
+        duration: 20,
+        easing: 'linear'
+      });
+      engine.registerGroup({
+        id: 'second',
+        type: AnimationGroupType.PARALLEL,
+        elementIds: ['b'],
+        properties: ['x'],
+        startFrame: 40,
+        duration: 15,
+        easing: 'linear'
+      });
+      engine.registerSequence({
+        id: 'sequence',
+        steps: [
+          { groupId: 'first', waitForComplete: true, onComplete: 'firstDone' },
+          { groupId: 'second', waitForComplete: true }
+        ],
+        repeat: 1,
+        autoPlay: false
+      });
+
+      stepComplete = jest.fn();
+      sequenceComplete = jest.fn();
+      engine.addEventListener('firstDone', stepComplete);
+      engine.addEventListener('sequenceComplete', sequenceComplete);
+
+      // Play up to frame 60, so each completion is dispatched once
+      engine.playSequence('sequence');
+      engine.pause();
+      (engine as any).advanceFrames(60);
+    });
+
+    afterEach(() => {
+      engine.stop();
+    });
+
+    test('should rebuild sequence progress when seeking back', () => {
+      expect(sequenceComplete).toHaveBeenCalledTimes(1);
+
+      // Back inside the second step: its completion is pending again
+      engine.seekToFrame(35);
+      engine.seekToFrame(55);
+      expect(sequenceComplete).toHaveBeenCalledTimes(2);
+    });
+
+    test('should not dispatch replayed events again', () => {
+      engine.seekToFrame(35);
+      expect(stepComplete).toHaveBeenCalledTimes(1);
+      expect(sequenceComplete).toHaveBeenCalledTimes(1);
+    });
+
+    test('should not dispatch events of frames a forward seek skips', () => {
+      // Both completions lie between the two frames
+      engine.seekToFrame(5);
+      engine.seekToFrame(70);
+      expect(stepComplete).toHaveBeenCalledTimes(1);
+      expect(sequenceComplete).toHaveBeenCalledTimes(1);
+    });
+
+    test('should dispatch events on the frame a forward seek lands on', () => {
+      engine.seekToFrame(5);
+      engine.seekToFrame(30);
+      expect(stepComplete).toHaveBeenCalledTimes(2);
+    });
+
+    test('should undo group keyframes applied after the target', () => {
+      engine.seekToFrame(5);
+
+      const b = engine.getCurrentElements().find(el => el.id === 'b');
+      expect(b?.animations).toBeUndefined();
+
+      // Replaying past the first step applies the second group again,
+      // without announcing the step's completion
+      engine.seekToFrame(50);
+      expect(stepComplete).toHaveBeenCalledTimes(1);
+      const replayed = engine.getCurrentElements().find(el => el.id === 'b');
+      expect(replayed?.properties.x).toBeCloseTo(20 + 20 * 10 / 15);
+    });
+  });
+});
@@ -0,0 +1,119 @@
+import {
+  ColorMatrix,
+  IDENTITY_MATRIX,
+  filterMatrix,
+  concatColorMatrices,
+  composeColorFilters,
+  mixColorMatrix,
+  isIdentity
+} from '../packages/runtime/src/color-matrix';
+import { FlareRenderer } from '../packages/runtime/src/renderer';
+
+// Run straight RGBA through a matrix, without clamping
+function apply(matrix: ColorMatrix, color: number[]): number[] {
+  return [0, 1, 2, 3].map((row) =>
+    matrix[row * 5 + 4] + [0, 1, 2, 3].reduce((sum, k) => sum + matrix[row * 5 + k] * color[k], 0)
+  );
+}
+
+function expectClose(actual: number[], expected: number[]): void {
+  expect(actual.length).toBe(expected.length);
+  actual.forEach((value, i) => expect(value).toBeCloseTo(expected[i], 5));
+}
+
+describe('Color Matrix Filters', () => {
+  const orange = [1, 0.5, 0.1, 0.8];
+
+  test('should scale color channels for brightness and leave alpha alone', () => {
+    expectClose(apply(filterMatrix({ type: 'brightness', amount: 0.5 }), orange), [0.5, 0.25, 0.05, 0.8]);
+  });
+
+  test('should turn colors gray with full grayscale', () => {
+    const [r, g, b, a] = apply(filterMatrix({ type: 'grayscale', amount: 1 }), orange);
+    const luma = 0.2126 * 1 + 0.7152 * 0.5 + 0.0722 * 0.1;
+
+    expect(r).toBeCloseTo(luma, 5);
+    expect(g).toBeCloseTo(luma, 5);
+    expect(b).toBeCloseTo(luma, 5);
+    expect(a).toBeCloseTo(0.8, 5);
+  });
+
+  test('should treat no-op filters as the identity', () => {
+    expect(isIdentity(filterMatrix({ type: 'saturate', amount: 1 }))).toBe(true);
+    expect(isIdentity(filterMatrix({ type: 'grayscale', amount: 0 }))).toBe(true);
+    expect(isIdentity(filterMatrix({ type: 'hueRotate', angle: 360 }))).toBe(true);
+    expect(isIdentity(filterMatrix({ type: 'tint', color: '#ff0000', amount: 0 }))).toBe(true);
+  });
+
+  test('should keep grays gray under hue rotation', () => {
+    expectClose(apply(filterMatrix({ type: 'hueRotate', angle: 120 }), [0.4, 0.4, 0.4, 1]), [0.4, 0.4, 0.4, 1]);
+  });
+
+  test('should tint by luminance', () => {
+    const white = apply(filterMatrix({ type: 'tint', color: '#f80', amount: 1 }), [1, 1, 1, 1]);
+    expectClose(white, [1, 0x88 / 255, 0, 1]);
+  });
+
+  test('should compose a chain into one matrix applied in order', () => {
+    const chain = [
+      { type: 'saturate' as const, amount: 0.3 },
+      { type: 'hueRotate' as const, angle: 45 },
+      { type: 'brightness' as const, amount: 0.8 }
+    ];
+    const composed = composeColorFilters(chain)!;
+
+    let color = orange;
+    for (const filter of chain) {
+      color = apply(filterMatrix(filter), color);
+    }
+    expectClose(apply(composed, orange), color);
+  });
+
+  test('should compose the offsets of later matrices after earlier ones', () => {
+    const offset = IDENTITY_MATRIX.slice();
+    offset[4] = 0.25;
+    const halve = filterMatrix({ type: 'brightness', amount: 0.5 });
+
+    expectClose(apply(concatColorMatrices(offset, halve), [0, 0, 0, 1]), [0.125, 0, 0, 1]);
+    expectClose(apply(concatColorMatrices(halve, offset), [0, 0, 0, 1]), [0.25, 0, 0, 1]);
+  });
+
+  test('should compose chains that change nothing to null', () => {
+    expect(composeColorFilters([])).toBeNull();
+    expect(composeColorFilters([
+      { type: 'brightness', amount: 2 },
+      { type: 'brightness', amount: 0.5 }
+    ])).toBeNull();
+  });
+
+  test('should fade a matrix in from the identity', () => {
+    const gray = filterMatrix({ type: 'grayscale', amount: 1 });
+
+    expect(isIdentity(mixColorMatrix(gray, 0))).toBe(true);
+    expectClose(mixColorMatrix(gray, 1), gray);
+    expectClose(mixColorMatrix(gray, 0.5), filterMatrix({ type: 'grayscale', amount: 0.5 }));
+  });
+
+  test('should ignore raw matrices of the wrong size', () => {
+    expect(isIdentity(filterMatrix({ type: 'matrix', values: [1, 2, 3] }))).toBe(true);
+    expect(isIdentity(filterMatrix({ type: 'matrix', values: 'none' } as any))).toBe(true);
+  });
+
+  test('should treat filters of unknown types as the identity', () => {
+    expect(isIdentity(filterMatrix({ type: 'sepia', amount: 1 } as any))).toBe(true);
+    expect(composeColorFilters([{ type: 'sepia' } as any])).toBeNull();
+  });
+
+  test('should compose an element\'s filters once across cloned frames', () => {
+    const renderer = Object.create(FlareRenderer.prototype);
+    renderer.colorMatrices = new Map();
+    const props = { filters: [{ type: 'grayscale', amount: 1 }] };
+
+    const first = renderer.colorMatrixFor('logo', JSON.parse(JSON.stringify(props)));
+    const second = renderer.colorMatrixFor('logo', JSON.parse(JSON.stringify(props)));
+    expect(second).toBe(first);
+
+    const changed = renderer.colorMatrixFor('logo', { filters: [{ type: 'grayscale', amount: 0.5 }] });
+    expect(changed).not.toBe(first);
+  });
+});
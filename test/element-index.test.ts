@@ -0,0 +1,175 @@
+import { ElementIndex } from '../packages/runtime/src/animation/element-index';
+import { AnimationEngine } from '../packages/runtime/src/animation/animation-engine';
+import { AnimationGroupType } from '../packages/runtime/src/animation/groups';
+import { Timeline, Element, ElementType } from '@flare/shared';
+
+describe('Element ID Index', () => {
+  const makeElement = (id: string, x: number = 0): Element => ({
+    id,
+    type: ElementType.RECTANGLE,
+    properties: { x, y: 0, width: 10, height: 10, fill: '#000000' }
+  });
+
+  const makeTimeline = (): Timeline => ({
+    version: '1.0',
+    frameRate: 60,
+    duration: 100,
+    dimensions: { width: 400, height: 300, responsive: false },
+    layers: [
+      {
+        id: 'layer1',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [
+          { startFrame: 0, duration: 50, elements: [makeElement('a', 1), makeElement('b', 2)] },
+          { startFrame: 50, duration: 50, elements: [makeElement('c', 3)] }
+        ]
+      },
+      {
+        id: 'layer2',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [
+          { startFrame: 0, duration: 100, elements: [makeElement('a', 99), makeElement('d', 4)] }
+        ]
+      }
+    ],
+    scripts: []
+  });
+
+  describe('Lookup', () => {
+    test('should index every layer and frame of a timeline', () => {
+      const index = ElementIndex.fromTimeline(makeTimeline());
+
+      expect(index.size).toBe(4);
+      expect(index.findById('b')?.properties.x).toBe(2);
+      expect(index.findById('c')?.properties.x).toBe(3);
+      expect(index.findById('d')?.properties.x).toBe(4);
+      expect(index.findById('missing')).toBeNull();
+    });
+
+    test('should keep the first element when IDs repeat', () => {
+      const index = ElementIndex.fromTimeline(makeTimeline());
+      expect(index.findById('a')?.properties.x).toBe(1);
+    });
+
+    test('should map handles back to elements', () => {
+      const index = ElementIndex.fromTimeline(makeTimeline());
+      const handle = index.getHandle('c');
+
+      expect(handle).toBeGreaterThanOrEqual(0);
+      expect(index.getElement(handle)?.id).toBe('c');
+      expect(index.getHandle('missing')).toBe(-1);
+    });
+  });
+
+  describe('Insert and remove', () => {
+    test('should recycle handles of removed elements', () => {
+      const index = new ElementIndex();
+      const first = index.insert(makeElement('first'));
+      index.insert(makeElement('second'));
+
+      expect(index.remove('first')).toBe(true);
+      expect(index.findById('first')).toBeNull();
+      expect(index.remove('first')).toBe(false);
+
+      const third = index.insert(makeElement('third'));
+      expect(third).toBe(first);
+      expect(index.size).toBe(2);
+    });
+
+    test('should hand a removed ID to the next element that shares it', () => {
+      const index = ElementIndex.fromTimeline(makeTimeline());
+      const handle = index.getHandle('a');
+
+      expect(index.remove('a')).toBe(true);
+      expect(index.getHandle('a')).toBe(handle);
+      expect(index.findById('a')?.properties.x).toBe(99);
+
+      expect(index.remove('a')).toBe(true);
+      expect(index.findById('a')).toBeNull();
+    });
+
+    test('should remove a particular element that shares an ID', () => {
+      const index = new ElementIndex();
+      const first = makeElement('same', 1);
+      const second = makeElement('same', 2);
+      index.insert(first);
+      index.insert(second);
+
+      expect(index.remove('same', second)).toBe(true);
+      expect(index.remove('same', second)).toBe(false);
+      expect(index.findById('same')).toBe(first);
+    });
+
+    test('should index many elements', () => {
+      const index = new ElementIndex();
+      for (let i = 0; i < 10000; i++) {
+        index.insert(makeElement(`el${i}`, i));
+      }
+
+      expect(index.size).toBe(10000);
+      expect(index.findById('el9999')?.properties.x).toBe(9999);
+    });
+  });
+
+  describe('AnimationEngine integration', () => {
+    test('should animate elements added after load', () => {
+      const engine = new AnimationEngine(makeTimeline());
+      expect(engine.addElement('layer1', 0, makeElement('added', 10))).toBe(true);
+
+      engine.registerGroup({
+        id: 'addedGroup',
+        type: AnimationGroupType.PARALLEL,
+        elementIds: ['added'],
+        properties: ['x'],
+        startFrame: 0,
+        duration: 20,
+        easing: 'linear'
+      });
+      engine.registerSequence({
+        id: 'addedSequence',
+        steps: [{ groupId: 'addedGroup', waitForComplete: false }],
+        repeat: 1,
+        autoPlay: true
+      });
+      engine.pause();
+
+      engine.seekToFrame(10);
+      const added = engine.getCurrentElements().find(el => el.id === 'added');
+      expect(added?.properties.x).toBeCloseTo(15);
+    });
+
+    test('should remove elements from the timeline and the index', () => {
+      const engine = new AnimationEngine(makeTimeline());
+
+      expect(engine.removeElement('b')).toBe(true);
+      expect(engine.removeElement('b')).toBe(false);
+
+      engine.seekToFrame(10);
+      const ids = engine.getCurrentElements().map(el => el.id);
+      expect(ids).not.toContain('b');
+      expect(ids).toContain('d');
+    });
+
+    test('should keep finding an ID that another layer still holds', () => {
+      const engine = new AnimationEngine(makeTimeline());
+
+      expect(engine.removeElement('a')).toBe(true);
+      engine.seekToFrame(10);
+      const remaining = engine.getCurrentElements().filter(el => el.id === 'a');
+      expect(remaining.map(el => el.properties.x)).toEqual([99]);
+
+      expect(engine.removeElement('a')).toBe(true);
+      expect(engine.removeElement('a')).toBe(false);
+    });
+
+    test('should reject unknown layers and frames', () => {
+      const engine = new AnimationEngine(makeTimeline());
+      expect(engine.addElement('nope', 0, makeElement('x'))).toBe(false);
+      expect(engine.addElement('layer1', 5, makeElement('x'))).toBe(false);
+    });
+  });
+});
@@ -284,6 +284,30 @@ describe('Event Trigger System', () => {
       // Callback should not be called
       expect(mockCallback).not.toHaveBeenCalled();
     });
+
+    test('should trigger a batch of interactions in order', () => {
+      eventManager.registerTriggers([
+        { id: 'click-1', type: EventTriggerType.CLICK, elementId: 'button1', action: 'pressed' },
+        { id: 'hover-1', type: EventTriggerType.HOVER, elementId: 'button1', action: 'pressed' },
+        { id: 'drag-2', type: EventTriggerType.DRAG_START, elementId: 'button2', action: 'pressed' }
+      ] as InteractionEventTrigger[]);
+
+      const mockCallback = jest.fn();
+      eventManager.addEventListener('pressed', mockCallback);
+
+      eventManager.triggerInteractions([
+        { type: EventTriggerType.HOVER, elementId: 'button1', eventData: { x: 5 } },
+        { type: EventTriggerType.CLICK, elementId: 'button2' },
+        { type: EventTriggerType.DRAG_START, elementId: 'button2', eventData: { x: 7 } },
+        { type: EventTriggerType.CLICK, elementId: 'button1' }
+      ]);
+
+      // The click on button2 has no trigger
+      expect(mockCallback).toHaveBeenCalledTimes(3);
+      expect(mockCallback.mock.calls.map(call => call[0].triggerId)).toEqual(['hover-1', 'drag-2', 'click-1']);
+      expect(mockCallback.mock.calls[0][0].x).toBe(5);
+      expect(mockCallback.mock.calls[1][0].elementId).toBe('button2');
+    });
   });
 
   describe('Playback Triggers', () => {
@@ -0,0 +1,114 @@
+import { PropertyPathTable } from '../packages/runtime/src/animation/property-paths';
+import { AnimationEngine } from '../packages/runtime/src/animation/animation-engine';
+import { Timeline, ElementType } from '@flare/shared';
+
+describe('Compiled Property Paths', () => {
+  let table: PropertyPathTable;
+
+  beforeEach(() => {
+    table = new PropertyPathTable();
+  });
+
+  describe('Compilation', () => {
+    test('should split flat and nested paths', () => {
+      const x = table.compile('x');
+      expect(x.parents).toEqual([]);
+      expect(x.key).toBe('x');
+
+      const nested = table.compile('shadow.offset.x');
+      expect(nested.parents).toEqual(['shadow', 'offset']);
+      expect(nested.key).toBe('x');
+    });
+
+    test('should share one entry per path', () => {
+      expect(table.compile('shadow.blur')).toBe(table.compile('shadow.blur'));
+    });
+
+    test('should keep the compiled property on the animation without serializing it', () => {
+      const animation = { property: 'shadow.blur', keyframes: [] };
+      const compiled = table.resolve(animation);
+
+      expect(table.resolve(animation)).toBe(compiled);
+      expect(JSON.parse(JSON.stringify(animation))).toEqual({ property: 'shadow.blur', keyframes: [] });
+    });
+
+    test('should recompile when an animation changes its property', () => {
+      const animation = { property: 'x', keyframes: [] };
+      expect(table.resolve(animation).key).toBe('x');
+
+      animation.property = 'y';
+      expect(table.resolve(animation).key).toBe('y');
+    });
+  });
+
+  describe('Reading and writing', () => {
+    test('should read and write flat properties', () => {
+      const properties: any = { x: 5 };
+      const x = table.compile('x');
+
+      expect(table.get(properties, x)).toBe(5);
+      table.set(properties, x, 10);
+      expect(properties.x).toBe(10);
+    });
+
+    test('should create intermediate objects for nested paths', () => {
+      const properties: any = {};
+      const nested = table.compile('shadow.offset.x');
+
+      expect(table.get(properties, nested)).toBeUndefined();
+      table.set(properties, nested, 4);
+      expect(properties.shadow.offset.x).toBe(4);
+      expect(table.get(properties, nested)).toBe(4);
+    });
+  });
+
+  describe('AnimationEngine integration', () => {
+    const timeline: Timeline = {
+      version: '1.0',
+      frameRate: 60,
+      duration: 60,
+      dimensions: { width: 400, height: 300, responsive: false },
+      layers: [{
+        id: 'layer',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [{
+          startFrame: 0,
+          duration: 60,
+          elements: [{
+            id: 'rect',
+            type: ElementType.RECTANGLE,
+            properties: { x: 0, y: 0, width: 10, height: 10, fill: '#000000' },
+            animations: [
+              {
+                property: 'x',
+                keyframes: [
+                  { frame: 0, value: 0, easing: 'linear' },
+                  { frame: 20, value: 100, easing: 'linear' }
+                ]
+              },
+              {
+                property: 'shadow.offset',
+                keyframes: [
+                  { frame: 0, value: 0, easing: 'linear' },
+                  { frame: 20, value: 10, easing: 'linear' }
+                ]
+              }
+            ]
+          }]
+        }]
+      }],
+      scripts: []
+    };
+
+    test('should animate flat and nested properties', () => {
+      const engine = new AnimationEngine(timeline);
+      engine.seekToFrame(10);
+
+      const rect = engine.getCurrentElements()[0];
+      expect(rect.properties.x).toBeCloseTo(50);
+      expect(rect.properties.shadow.offset).toBeCloseTo(5);
+    });
+  });
+});
@@ -0,0 +1,295 @@
+import { TimingWheel, FrameScheduler } from '../packages/runtime/src/animation/scheduler';
+import { AnimationEngine } from '../packages/runtime/src/animation/animation-engine';
+import { AnimationGroupType } from '../packages/runtime/src/animation/groups';
+import { Timeline, ElementType } from '@flare/shared';
+
+describe('Frame Scheduler', () => {
+  describe('TimingWheel', () => {
+    test('should expire tasks on their due tick', () => {
+      const wheel = new TimingWheel();
+      const delays = [1, 63, 64, 65, 4095, 4096, 70000];
+      const ids = delays.map(delay => wheel.schedule(delay, () => {}));
+
+      const expiredAt = new Map<number, number>();
+      for (let tick = 1; tick <= 70000; tick++) {
+        wheel.tick().forEach(task => expiredAt.set(task.id, tick));
+      }
+
+      ids.forEach((id, index) => {
+        expect(expiredAt.get(id)).toBe(delays[index]);
+      });
+      expect(wheel.size).toBe(0);
+    });
+
+    test('should run same-tick tasks in insertion order', () => {
+      const wheel = new TimingWheel();
+      const first = wheel.schedule(100, () => {});
+      for (let i = 0; i < 50; i++) wheel.tick();
+      const second = wheel.schedule(50, () => {});
+
+      let expired: number[] = [];
+      for (let i = 0; i < 50; i++) {
+        expired = expired.concat(wheel.tick().map(task => task.id));
+      }
+      expect(expired).toEqual([first, second]);
+    });
+
+    test('should cancel single tasks and whole owners', () => {
+      const wheel = new TimingWheel();
+      const single = wheel.schedule(5, () => {});
+      wheel.schedule(5, () => {}, 'owner');
+      wheel.schedule(500, () => {}, 'owner');
+
+      expect(wheel.cancel(single)).toBe(true);
+      expect(wheel.cancel(single)).toBe(false);
+      expect(wheel.cancelOwner('owner')).toBe(2);
+      expect(wheel.size).toBe(0);
+
+      for (let i = 0; i < 500; i++) {
+        expect(wheel.tick()).toEqual([]);
+      }
+    });
+  });
+
+  describe('FrameScheduler', () => {
+    test('should run tasks behind the playhead after the timeline loops', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.advance(50);
+      scheduler.scheduleAtFrame(30, () => log.push('30'));
+      scheduler.scheduleAtFrame(60, () => log.push('60'));
+
+      scheduler.advance(20);
+      expect(log).toEqual(['60']);
+
+      scheduler.advance(59);
+      expect(log).toEqual(['60']);
+
+      scheduler.advance(1);
+      expect(log).toEqual(['60', '30']);
+    });
+
+    test('should run absolute frames past the end of the timeline in later loops', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.advance(50);
+      scheduler.scheduleAtAbsoluteFrame(30, () => log.push('30'));
+      scheduler.scheduleAtAbsoluteFrame(140, () => log.push('140'));
+      scheduler.scheduleAtAbsoluteFrame(250, () => log.push('250'));
+
+      // Frame 30 is behind the playhead, so it runs on its next visit
+      scheduler.advance(80);
+      expect(log).toEqual(['30']);
+
+      scheduler.advance(10);
+      expect(log).toEqual(['30', '140']);
+
+      scheduler.advance(109);
+      expect(log).toEqual(['30', '140']);
+
+      scheduler.advance(1);
+      expect(log).toEqual(['30', '140', '250']);
+    });
+
+    test('should run passed tasks on forward seeks and re-base on backward seeks', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.seek(80);
+      scheduler.scheduleAtFrame(50, () => log.push('50'));
+      scheduler.scheduleAtFrame(90, () => log.push('90'));
+
+      // Landing exactly on a task's frame runs it
+      scheduler.seek(50);
+      expect(log).toEqual(['50']);
+
+      scheduler.seek(95);
+      expect(log).toEqual(['50', '90']);
+      expect(scheduler.pendingCount).toBe(0);
+    });
+
+    test('should keep extra loops across seeks', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.scheduleAtFrame(10, () => log.push('done'), undefined, 2);
+      scheduler.advance(110);
+      expect(log).toEqual([]);
+
+      scheduler.seek(5);
+      expect(log).toEqual([]);
+
+      scheduler.seek(10);
+      expect(log).toEqual(['done']);
+    });
+
+    test('should cancel delayed starts by owner', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.scheduleAfter(5, () => log.push('a'), 'sequence');
+      scheduler.scheduleAfter(5, () => log.push('b'), 'sequence');
+      scheduler.scheduleAfter(5, () => log.push('c'));
+
+      expect(scheduler.cancelOwner('sequence')).toBe(2);
+      scheduler.advance(5);
+      expect(log).toEqual(['c']);
+    });
+
+    test('should restore pending tasks from a snapshot', () => {
+      const scheduler = new FrameScheduler(100);
+      const log: string[] = [];
+
+      scheduler.scheduleAtFrame(10, () => log.push('10'));
+      scheduler.scheduleAtFrame(20, () => log.push('20'), 'owner');
+      scheduler.advance(3);
+      const snapshot = scheduler.snapshot();
+
+      scheduler.advance(50);
+      expect(log).toEqual(['10', '20']);
+
+      scheduler.restore(snapshot);
+      expect(scheduler.pendingCount).toBe(2);
+      scheduler.advance(17);
+      expect(log).toEqual(['10', '20', '10', '20']);
+    });
+  });
+
+  describe('AnimationEngine integration', () => {
+    const timeline: Timeline = {
+      version: '1.0',
+      frameRate: 60,
+      duration: 100,
+      dimensions: { width: 400, height: 300, responsive: false },
+      layers: [{
+        id: 'layer',
+        type: 'normal',
+        visible: true,
+        locked: false,
+        frames: [{
+          startFrame: 0,
+          duration: 100,
+          elements: [
+            { id: 'a', type: ElementType.CIRCLE, properties: { x: 0, y: 0, radius: 10, fill: '#000000' } },
+            { id: 'b', type: ElementType.CIRCLE, properties: { x: 0, y: 0, radius: 20, fill: '#000000' } }
+          ]
+        }]
+      }],
+      scripts: []
+    };
+
+    let engine: AnimationEngine;
+
+    beforeEach(() => {
+      engine = new AnimationEngine(JSON.parse(JSON.stringify(timeline)));
+      engine.registerGroup({
+        id: 'first',
+        type: AnimationGroupType.PARALLEL,
+        elementIds: ['a'],
+        properties: ['radius'],
+        startFrame: 10,
+        duration: 20,
+        easing: 'linear'
+      });
+      engine.registerGroup({
+        id: 'second',
+        type: AnimationGroupType.STAGGER,
+        elementIds: ['a', 'b'],
+        properties: ['x'],
+        startFrame: 40,
+        duration: 10,
+        staggerDelay: 5,
+        easing: 'linear'
+      });
+      engine.registerSequence({
+        id: 'sequence',
+        steps: [
+          { groupId: 'first', waitForComplete: true, onComplete: 'firstDone' },
+          { groupId: 'second', waitForComplete: true }
+        ],
+        repeat: 1,
+        autoPlay: false
+      });
+    });
+
+    afterEach(() => {
+      engine.stop();
+    });
+
+    test('should step through a sequence as frames pass', () => {
+      const stepComplete = jest.fn();
+      const groupComplete = jest.fn();
+      const sequenceComplete = jest.fn();
+      engine.addEventListener('firstDone', stepComplete);
+      engine.addEventListener('animationComplete', groupComplete);
+      engine.addEventListener('sequenceComplete', sequenceComplete);
+
+      engine.playSequence('sequence');
+      engine.pause();
+
+      engine.seekToFrame(29);
+      expect(stepComplete).not.toHaveBeenCalled();
+
+      engine.seekToFrame(30);
+      expect(stepComplete).toHaveBeenCalledTimes(1);
+      expect(groupComplete).toHaveBeenCalledTimes(1);
+
+      // The staggered group finishes when its last element does: 40 + 5 + 10
+      engine.seekToFrame(54);
+      expect(sequenceComplete).not.toHaveBeenCalled();
+
+      engine.seekToFrame(55);
+      expect(groupComplete).toHaveBeenCalledTimes(2);
+      expect(sequenceComplete).toHaveBeenCalledTimes(1);
+    });
+
+    test('should complete a group that outlasts the timeline in the next loop', () => {
+      const groupComplete = jest.fn();
+      engine.addEventListener('animationComplete', groupComplete);
+      engine.registerGroup({
+        id: 'long',
+        type: AnimationGroupType.PARALLEL,
+        elementIds: ['b'],
+        properties: ['radius'],
+        startFrame: 80,
+        duration: 40,
+        easing: 'linear'
+      });
+      engine.registerSequence({
+        id: 'longSequence',
+        steps: [{ groupId: 'long', waitForComplete: true }],
+        repeat: 1,
+        autoPlay: false
+      });
+
+      engine.playSequence('longSequence');
+      engine.pause();
+
+      // It ends on frame 120, which is frame 20 of the next loop
+      engine.seekToFrame(20);
+      engine.seekToFrame(99);
+      expect(groupComplete).not.toHaveBeenCalled();
+
+      (engine as any).advanceFrames(20);
+      expect(engine.getCurrentFrame()).toBe(19);
+      expect(groupComplete).not.toHaveBeenCalled();
+
+      (engine as any).advanceFrames(1);
+      expect(groupComplete).toHaveBeenCalledTimes(1);
+    });
+
+    test('should cancel pending steps when a sequence stops', () => {
+      const stepComplete = jest.fn();
+      engine.addEventListener('firstDone', stepComplete);
+
+      engine.playSequence('sequence');
+      engine.pause();
+      engine.stopSequence('sequence');
+
+      engine.seekToFrame(60);
+      expect(stepComplete).not.toHaveBeenCalled();
+    });
+  });
+});
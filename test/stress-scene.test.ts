@@ -0,0 +1,151 @@
+import {
+  generateStressScene,
+  encodeStressSceneJSON,
+  encodeStressSceneBinary,
+  FlareBinary,
+  FlareParser
+} from '../packages/file-format/src';
+import { Element } from '@flare/shared';
+
+describe('Stress Scene Generator', () => {
+  const countElements = (elements: Element[]): number =>
+    elements.reduce((total, element) => total + 1 + countElements(element.children || []), 0);
+
+  const depthOf = (elements: Element[]): number =>
+    elements.reduce((depth, element) => Math.max(depth, element.children ? 1 + depthOf(element.children) : 0), 0);
+
+  describe('Generation', () => {
+    test('should honour element, layer and nesting parameters', () => {
+      const scene = generateStressScene({ elementCount: 1000, layerCount: 3, nestingDepth: 2 });
+      const layers = scene.timeline.layers;
+
+      expect(layers.length).toBe(3);
+      const total = layers.reduce((sum, layer) => sum + countElements(layer.frames[0].elements), 0);
+      expect(total).toBe(1000);
+      layers.forEach(layer => expect(depthOf(layer.frames[0].elements)).toBe(2));
+    });
+
+    test('should build tracks, paths and triggers to order', () => {
+      const scene = generateStressScene({
+        elementCount: 50,
+        tracksPerElement: 3,
+        keyframesPerTrack: 5,
+        easingMix: ['linear'],
+        pathAnimationCount: 4,
+        triggerDensity: 10,
+        duration: 200
+      });
+
+      const leaf = scene.timeline.layers[0].frames[0].elements[0];
+      expect(leaf.animations?.length).toBe(3);
+      leaf.animations?.forEach(animation => {
+        expect(animation.keyframes.length).toBe(5);
+        expect(animation.keyframes.every(keyframe => keyframe.easing === 'linear')).toBe(true);
+      });
+
+      expect(scene.paths.length).toBe(4);
+      expect(scene.pathAnimations.length).toBe(4);
+      expect(scene.triggers.length).toBe(20);
+    });
+
+    test('should put keyframes on distinct frames when there are more than frames', () => {
+      const scene = generateStressScene({ elementCount: 5, keyframesPerTrack: 10, duration: 4 });
+
+      scene.timeline.layers[0].frames[0].elements.forEach(element => {
+        element.animations?.forEach(animation => {
+          expect(animation.keyframes.map(keyframe => keyframe.frame)).toEqual([0, 1, 2, 3]);
+        });
+      });
+    });
+
+    test('should be deterministic for a seed', () => {
+      const options = { elementCount: 200, pathAnimationCount: 3, triggerDensity: 5 };
+      const a = JSON.stringify(generateStressScene({ ...options, seed: 7 }));
+      const b = JSON.stringify(generateStressScene({ ...options, seed: 7 }));
+      const c = JSON.stringify(generateStressScene({ ...options, seed: 8 }));
+
+      expect(a).toBe(b);
+      expect(a).not.toBe(c);
+    });
+  });
+
+  describe('Binary encoding', () => {
+    test('should round-trip a scene', () => {
+      const scene = generateStressScene({ elementCount: 300, nestingDepth: 1, pathAnimationCount: 2, triggerDensity: 5 });
+      const binary = encodeStressSceneBinary(scene);
+
+      expect(FlareBinary.isBinary(binary)).toBe(true);
+      expect(FlareBinary.decode(binary)).toEqual(JSON.parse(encodeStressSceneJSON(scene)));
+      expect(binary.length).toBeLessThan(encodeStressSceneJSON(scene).length);
+    });
+
+    test('should encode timelines the parser loads', () => {
+      const scene = generateStressScene({ elementCount: 20, nestingDepth: 1 });
+
+      expect(FlareParser.parseBinary(encodeStressSceneBinary(scene))).toEqual(scene.timeline);
+      expect(FlareParser.parseJSON(encodeStressSceneJSON(scene))).toEqual(scene.timeline);
+    });
+
+    test('should round-trip edge-case values', () => {
+      const value = {
+        negative: -12345,
+        large: 2 ** 40,
+        fraction: 0.1,
+        text: 'héllo 🎉',
+        list: [true, false, null, [1, 2]],
+        skipped: undefined
+      };
+
+      expect(FlareBinary.decode(FlareBinary.encode(value))).toEqual({
+        negative: -12345,
+        large: 2 ** 40,
+        fraction: 0.1,
+        text: 'héllo 🎉',
+        list: [true, false, null, [1, 2]]
+      });
+    });
+
+    test('should store repeated subtrees once', () => {
+      const track = () => ({
+        property: 'x',
+        keyframes: [
+          { frame: 0, value: 10, easing: 'linear' },
+          { frame: 30, value: 200, easing: 'ease-in' }
+        ]
+      });
+      const elements = [];
+      for (let i = 0; i < 50; i++) {
+        elements.push({ id: `el${i}`, properties: { x: 5, y: 6, fill: '#ff0000' }, animations: [track(), track()] });
+      }
+      const single = FlareBinary.encode({ elements: elements.slice(0, 1) });
+      const binary = FlareBinary.encode({ elements });
+
+      // Written out in full, 50 elements would take about 50 times the bytes
+      expect(binary.length).toBeLessThan(single.length * 10);
+
+      const decoded = FlareBinary.decode(binary);
+      expect(decoded).toEqual({ elements });
+      expect(decoded.elements[0].animations).not.toBe(decoded.elements[1].animations);
+
+      const shared = FlareBinary.decode(binary, { shareRecords: true });
+      expect(shared).toEqual({ elements });
+      expect(shared.elements[0].animations).toBe(shared.elements[1].animations);
+    });
+
+    test('should decode version 1 data', () => {
+      // "FLRB", version 1, one string "a", then { a: 1 }
+      const bytes = new Uint8Array([0x46, 0x4c, 0x52, 0x42, 1, 1, 1, 0x61, 7, 1, 0, 4, 2]);
+      expect(FlareBinary.decode(bytes)).toEqual({ a: 1 });
+    });
+
+    test('should reject data that isn\'t a binary timeline', () => {
+      const error = jest.spyOn(console, 'error').mockImplementation(() => {});
+      try {
+        expect(() => FlareParser.parseBinary(new Uint8Array([1, 2, 3, 4, 5]))).toThrow();
+        expect(() => FlareParser.parseBinary(FlareBinary.encode({ layers: [] }))).toThrow();
+      } finally {
+        error.mockRestore();
+      }
+    });
+  });
+});
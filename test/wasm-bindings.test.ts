@@ -0,0 +1,38 @@
+import { decodeHeapText } from '../packages/runtime/src/wasm-bindings';
+
+describe('WASM Bindings', () => {
+  describe('decodeHeapText', () => {
+    const originalDecoder = (global as any).TextDecoder;
+
+    // Browsers' TextDecoder throws on views of shared memory; Node's doesn't
+    class BrowserTextDecoder {
+      decode(view: Uint8Array): string {
+        if (view.buffer instanceof SharedArrayBuffer) {
+          throw new TypeError('The provided ArrayBufferView value must not be shared.');
+        }
+        return Array.from(view, (byte) => String.fromCharCode(byte)).join('');
+      }
+    }
+
+    beforeEach(() => {
+      (global as any).TextDecoder = BrowserTextDecoder;
+    });
+
+    afterEach(() => {
+      (global as any).TextDecoder = originalDecoder;
+    });
+
+    test('should decode a view of a shared heap', () => {
+      const heap = new Uint8Array(new SharedArrayBuffer(16));
+      const text = '{"a":1}';
+      for (let i = 0; i < text.length; i++) heap[4 + i] = text.charCodeAt(i);
+
+      expect(decodeHeapText(heap.subarray(4, 4 + text.length))).toBe(text);
+    });
+
+    test('should decode a view of an unshared heap', () => {
+      const heap = new Uint8Array([0, 104, 105, 0]);
+      expect(decodeHeapText(heap.subarray(1, 3))).toBe('hi');
+    });
+  });
+});